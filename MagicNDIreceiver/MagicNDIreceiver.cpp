@@ -127,6 +127,40 @@
 //				  Version 1.025
 // 16.05.25		- Rebuild with latest ofxNDI -  NDI 6.3.1.0 x64/MT
 //				  Version 1.026
+// 18.10.26		- Start receiver statistics sampling
+//				  Record texture upload and conversion times
+//				  Show receiver statistics in help text
+//				- Add "Standby" option for senders to keep connected
+//				  at low bandwidth for fast switching
+//				- Add "Backup" option for senders to switch to
+//				  if the selected sender is lost
+//				- Add "Buffering" option for asynchronous texture upload
+//				  using persistent mapped pixel buffers with fences
+//				- Upload BGRA/BGRX frames directly as GL_BGRA
+//				  and remove the compute shader red/blue swap
+//				  Receive RGBA/RGBX frames without conversion
+//				  Alpha swizzle to one for BGRX/RGBX
+//				- YUV option requests the native format of the sender
+//				  Upload planar NV12, I420, YV12, P216, PA16 and UYVA frames
+//				  to single and two channel textures for each plane
+//				  and convert to RGBA with compute shaders
+//				  BT.601 for SD and BT.709 for HD resolutions
+//				- Textures, plane textures and pixel buffers from a pool
+//				  for re-use when the sender resolution or format changes
+//				  Textures have immutable storage
+//				  Remove unused receiving buffer allocation
+//				- CPU and GPU timing of capture, upload, convert and draw stages
+//				  Add "Profile" option to write timing to a CSV file
+//				  Show timing in help text
+//				- Add "Trace" option to record each stage and NDI receive
+//				  to a chrome://tracing JSON file
+//				- Add "Tiles" option to compare each frame with the last
+//				  in 64x64 pixel tiles and upload and convert
+//				  only the tiles that have changed
+//				- Repeated frames are not uploaded or converted
+//				  and the last texture is drawn
+//				  Add "Repeat hash" option to find repeated frames
+//				  sent again by the sender
 //
 // =======================================================================================
 
@@ -156,6 +190,7 @@
 #include <windows.h>
 #include <conio.h>
 #include <stdio.h>
+#include <chrono> // for stage timing
 #include <gl/gl.h>
 #pragma comment(lib, "OpenGL32.Lib")
 
@@ -164,6 +199,8 @@
 // Spout extensions (with standaloneExtensions define)
 #include "SpoutGL\SpoutGLextensions.h"
 #include "SpoutGL\YuvShaders.h" // Compute shaders
+#include "SpoutGL\ResourcePool.h" // Texture and buffer re-use
+#include "SpoutGL\StageTimer.h" // Stage timing
 
 // Name list for the combo box
 static std::string senderList; // Name list to compare for changes
@@ -178,9 +215,19 @@ yuvShaders shaders; // Compute shaders
 #define PARAM_Aspect      1
 #define PARAM_Lowres      2
 #define PARAM_YUV         3
+#define PARAM_Standby     4
+#define PARAM_Backup      5
+#define PARAM_Buffer      6
+#define PARAM_Profile     7
+#define PARAM_Trace       8
+#define PARAM_Tiles       9
+#define PARAM_Repeat      10
 
 // Number of parameters
-#define NumParams 4
+#define NumParams 11
+
+// Tile size in pixels for changed tile upload
+#define TILE_SIZE 64
 
 // For OpenGL
 #ifndef GL_CLAMP_TO_EDGE
@@ -207,7 +254,6 @@ public:
 		printf("MagicNDIreceiver\n");
 		*/
 
-		spout_buffer = nullptr;
 		senderName = "";
 		startName = "";
 		senderIndex = -1;
@@ -220,9 +266,33 @@ public:
 		bAspect = false; // do not preserve aspect ratio of received texture in draw
 		bLowres = false; // do not use low bandwidth receiving mode
 		bYUV = false; // Prefer BGRA by default
+		bBuffer = true; // Upload textures using pixel buffers
+		m_pbo[0] = m_pbo[1] = m_pbo[2] = 0;
+		m_pboFence[0] = m_pboFence[1] = m_pboFence[2] = nullptr;
+		m_pboMemory[0] = m_pboMemory[1] = m_pboMemory[2] = nullptr;
+		m_pboSize = 0;
+		PboIndex = 0;
+		bOpaque = false;
+		planeTexture[0] = planeTexture[1] = planeTexture[2] = 0;
+		planeFourCC = (NDIlib_FourCC_video_type_e)0;
+		bTiles = false; // Upload the whole frame
+		bTextureValid = false;
+		bTileValid = false;
+		tileFourCC = (NDIlib_FourCC_video_type_e)0;
+		tileChanged = 0;
+		tileCount = 0;
 		hlp.reserve(1024); // reserve instead of allocate on the stack
 
 		receiver.SetAudio(false); // Set to receive no audio
+		receiver.StartStats(1000); // Sample receiver statistics every second
+
+		// Stages timed for each frame
+		STAGE_Capture = timer.AddStage("Capture", false);
+		STAGE_Tiles   = timer.AddStage("Tile compare", false);
+		STAGE_Upload  = timer.AddStage("Upload");
+		STAGE_Convert = timer.AddStage("Convert");
+		STAGE_Draw    = timer.AddStage("Draw");
+		profileTime = std::chrono::steady_clock::now();
 
 	}
 
@@ -247,6 +317,16 @@ public:
 
 		bNewContext = true; // New OpenGL context
 
+		// Pixel buffers and textures are re-created for the new context
+		ReleasePbos();
+		ReleasePlanes();
+		pool.Clear();
+		myTexture = 0;
+		yuvTexture = 0;
+
+		// Timer queries are re-created for the new context
+		timer.Release();
+
 		// Make sure there is a valid texture to draw in case of scene change.
 		if (senderWidth > 0 && senderHeight > 0) {
 			if(bYUV)
@@ -261,10 +341,21 @@ public:
 		// Close the NDI receiver
 		// and release receiving buffer and texture
 		ReleaseNDIreceiver();
+		ReleasePbos();
+		ReleasePlanes();
+		pool.Clear();
+		timer.Release();
+		// Write the trace if recording
+		if (ofxNDIutils::IsTracing()) {
+			ofxNDIutils::StopTrace();
+			ofxNDIutils::WriteTrace(traceFile.c_str());
+		}
 	};
 
 	void drawBefore(MagicUserData *userData) {
 
+		ofxNDIutils::TraceSpan span("MagicNDIreceiver::drawBefore");
+
 		unsigned int width = 0;
 		unsigned int height = 0;
 		int nsenders = 0;
@@ -293,7 +384,9 @@ public:
 
 					// If initialized and the the index is current,
 					// release the receiver if it's a different name.
-					if (bInitialized && i == senderIndex && name != senderName) {
+					// With failover the sender is found by name after
+					// the list and the receiver is kept if it has closed.
+					if (bInitialized && i == senderIndex && name != senderName && !HasFailover()) {
 						ReleaseNDIreceiver();
 					}
 					
@@ -306,6 +399,10 @@ public:
 					if (i < nSenders - 1)
 						list += "\n";
 
+					// Keep standby senders connected
+					if (IsStandbyName(name))
+						receiver.AddStandby(name);
+
 					// This section is to allow waiting for
 					// the sender saved in the comobox to start
 					// if the user does not select anything else
@@ -316,12 +413,31 @@ public:
 							// Set the sender name and allow receiver creation with this index
 							senderName = name;
 							senderIndex = i;
+							// The saved sender is the primary sender for failover
+							primaryName = name;
 							bStarted = true; // don't do this section again
 						}
 					}
+					else if (bInitialized && !startName.empty() && !bStarted && primaryName == startName) {
+						// Receiving from a backup sender because the saved sender
+						// was not running. It is the primary sender now it has started.
+						if (name.find(startName.c_str(), 0, startName.size()) != std::string::npos) {
+							primaryName = name;
+							bStarted = true;
+						}
+					}
 
 				} // endif nSenders > 0
 
+				// With failover, update the index of the current sender.
+				// If it has closed, the receiver switches to a backup
+				// sender when no frames have arrived for the timeout.
+				if (bInitialized && HasFailover())
+					receiver.GetSenderIndex(senderName, senderIndex);
+
+				// Backup senders may have started
+				UpdateFailover();
+
 				// Tell Magic paramNeedsUpdating to update the combo box 
 				// if the list is different or if a new OpenGL context
 				// in case there has been a scene change.
@@ -346,7 +462,18 @@ public:
 				// Frame rate might be much less than the draw cycle
 				// ReceiveImage succeeds if it finds a sender
 				// Receive a pixel buffer and use the video frame data pointer directly
-				if (receiver.ReceiveImage(width, height)) {
+				BeginStage(STAGE_Capture);
+				bool bReceived = receiver.ReceiveImage(width, height);
+				EndStage(STAGE_Capture);
+
+				// The receiver may have switched to a backup sender
+				// or back to the primary sender
+				if (receiver.GetSenderName() != senderName) {
+					senderName = receiver.GetSenderName();
+					receiver.GetSenderIndex(senderName, senderIndex);
+				}
+
+				if (bReceived) {
 
 					// Have the NDI sender dimensions changed ?
 					// (initially senderWidth and senderHeight are 0 so the buffer gets created here)
@@ -357,38 +484,106 @@ public:
 						if(bYUV)
 							InitTexture(yuvTexture, GL_RGBA, senderWidth/2, senderHeight);
 						InitTexture(myTexture, GL_RGBA, senderWidth, senderHeight);
+						// Plane textures are created for the next frame
+						ReleasePlanes();
+						// Free the video frame, which can be from a standby receiver
+						receiver.FreeVideoData();
 						return; // no more for this cycle
 					}
 
 					// Now that the receiving texture is the right size
 					// update with the pixel buffer
-					if (bYUV && receiver.GetVideoType() == NDIlib_FourCC_type_UYVY) {
+					if (receiver.IsRepeatFrame() && bTextureValid) {
+						// The frame is the same as the last one
+						// so the texture is drawn again without upload
+						receiver.FreeVideoData();
+						receiver.SetStageTime(ofxNDI_stage_upload, 0.0);
+						receiver.SetStageTime(ofxNDI_stage_convert, 0.0);
+					}
+					else if (bYUV && receiver.GetVideoType() == NDIlib_FourCC_type_UYVY) {
+
+						// Find the tiles that have changed if selected
+						bool bPartial = CompareTiles(receiver.GetVideoData(), receiver.GetVideoStride(),
+							senderWidth*2, senderHeight, TILE_SIZE*2, NDIlib_FourCC_type_UYVY);
 
 						// Get UYVY pixels into yuvTexture
-						glBindTexture(GL_TEXTURE_2D, yuvTexture);
-						glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, senderWidth/2, senderHeight, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid *)receiver.GetVideoData());
-						glBindTexture(GL_TEXTURE_2D, 0);
+						BeginStage(STAGE_Upload);
+						if (bPartial)
+							UploadTiles(yuvTexture, GL_RGBA, receiver.GetVideoData(), receiver.GetVideoStride(), 2);
+						else
+							UploadTexture(yuvTexture, senderWidth/2, senderHeight, GL_RGBA,
+								receiver.GetVideoData(), receiver.GetVideoStride());
+						// The frame has been copied and can be freed now
+						receiver.FreeVideoData();
+						EndStage(STAGE_Upload, ofxNDI_stage_upload);
 
 						// Convert YUV texture to RGBA texture
-						shaders.YUVtoRgba(yuvTexture, myTexture, senderWidth, senderHeight, true);
+						BeginStage(STAGE_Convert);
+						ofxNDIutils::TraceBegin("yuvShaders::YUVtoRgba");
+						if (bPartial) {
+							for (size_t i = 0; i < tileRects.size(); i++) {
+								shaders.YUVtoRgbaRegion(yuvTexture, myTexture, tileRects[i].x, tileRects[i].y,
+									tileRects[i].width, tileRects[i].height, IsBT601());
+							}
+						}
+						else {
+							shaders.YUVtoRgba(yuvTexture, myTexture, senderWidth, senderHeight, IsBT601());
+						}
+						ofxNDIutils::TraceEnd();
+						EndStage(STAGE_Convert, ofxNDI_stage_convert);
+						bTextureValid = true;
 
 					}
-					else {
-						if (receiver.GetVideoType() == NDIlib_FourCC_type_BGRA
-							|| receiver.GetVideoType() == NDIlib_FourCC_type_BGRX) {
+					else if (bYUV && IsPlanar(receiver.GetVideoType())) {
+
+						// Create textures for each plane if the format has changed
+						if (receiver.GetVideoType() != planeFourCC)
+							InitPlanes(receiver.GetVideoType(), senderWidth, senderHeight);
 
-							// Get BGRA pixels into myTexture
-							glBindTexture(GL_TEXTURE_2D, myTexture);
-							glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, senderWidth, senderHeight, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid *)receiver.GetVideoData());
-							glBindTexture(GL_TEXTURE_2D, 0);
+						// Planar formats are not compared in tiles
+						// and the whole texture is converted
+						bTileValid = false;
 
-							// Swap BGRA > RGBA
-							shaders.Swap(myTexture, senderWidth, senderHeight);
+						// Get the planes into their textures
+						BeginStage(STAGE_Upload);
+						UploadPlanes(receiver.GetVideoData(), receiver.GetVideoStride(), senderWidth, senderHeight);
+						receiver.FreeVideoData();
+						EndStage(STAGE_Upload, ofxNDI_stage_upload);
 
+						// Convert planes to RGBA texture
+						BeginStage(STAGE_Convert);
+						ConvertPlanes(myTexture, senderWidth, senderHeight);
+						EndStage(STAGE_Convert, ofxNDI_stage_convert);
+						bTextureValid = true;
+
+					}
+					else {
+						// BGRA and RGBA frames are uploaded directly to myTexture.
+						// OpenGL re-orders BGRA pixels during the transfer,
+						// so there is no conversion stage.
+						GLenum glformat = GetUploadFormat(receiver.GetVideoType());
+						if (glformat != 0) {
+							bool bPartial = CompareTiles(receiver.GetVideoData(), receiver.GetVideoStride(),
+								senderWidth*4, senderHeight, TILE_SIZE*4, receiver.GetVideoType());
+							BeginStage(STAGE_Upload);
+							// The alpha of BGRX and RGBX frames is undefined
+							SetTextureAlpha(myTexture, receiver.GetVideoType() == NDIlib_FourCC_type_BGRX
+								|| receiver.GetVideoType() == NDIlib_FourCC_type_RGBX);
+							if (bPartial)
+								UploadTiles(myTexture, glformat, receiver.GetVideoData(), receiver.GetVideoStride(), 1);
+							else
+								UploadTexture(myTexture, senderWidth, senderHeight, glformat,
+									receiver.GetVideoData(), receiver.GetVideoStride());
+							// The frame has been copied and can be freed now
+							receiver.FreeVideoData();
+							EndStage(STAGE_Upload, ofxNDI_stage_upload);
+							receiver.SetStageTime(ofxNDI_stage_convert, 0.0);
+							bTextureValid = true;
 						}
 					}
 
 					// Must free video frame data
+					// if not already freed after upload
 					receiver.FreeVideoData();
 
 				}
@@ -397,12 +592,41 @@ public:
 				// Otherwise the connection could be down so draw the current texture 
 				// and keep waiting for it to come back.
 				if (senderWidth > 0 && senderHeight > 0 && myTexture > 0) {
+					BeginStage(STAGE_Draw);
 					DrawReceivedTexture(myTexture, GL_TEXTURE_2D,
 						senderWidth, senderHeight,
 						userData->glState->viewportWidth,
 						userData->glState->viewportHeight);
+					EndStage(STAGE_Draw);
 				}
 
+				// Collect GPU times that are ready
+				timer.Update();
+				WriteProfile();
+
+			}
+			else if (HasFailover()) {
+				// Not initialized with failover.
+				// Receive from the primary sender, or the backup sender in use,
+				// if it is running. Otherwise failover switches to a backup sender
+				// after the timeout. The sender is not selected by index because
+				// another sender can take the place of one that has closed.
+				std::string name = receiver.IsFailover() ? senderName : primaryName;
+				int index = 0;
+				if (!name.empty() && receiver.GetSenderIndex(name, index)) {
+					senderName = name;
+					senderIndex = index;
+					receiver.SetSenderName(senderName.c_str());
+					bInitialized = receiver.CreateReceiver(senderIndex);
+				}
+				else {
+					receiver.CheckFailover();
+					if (receiver.ReceiverCreated()) {
+						senderName = receiver.GetSenderName();
+						receiver.GetSenderIndex(senderName, senderIndex);
+						bInitialized = true;
+					}
+				}
 			}
 			else {
 				// Not initialized
@@ -420,7 +644,9 @@ public:
 
 	bool fixedParamValueChanged(const int whichParam, const char* newValue) {
 		
-		if (!newValue || !newValue[0])
+		// The standby and backup lists and the profile and trace file names can be empty
+		if (!newValue || (!newValue[0] && whichParam != PARAM_Standby
+			&& whichParam != PARAM_Backup && whichParam != PARAM_Profile && whichParam != PARAM_Trace))
 			return false;
 
 		int iValue = atoi(newValue);
@@ -435,6 +661,9 @@ public:
 			// There might not be any senders running yet.
 			if (newValue && newValue[0] && !bStarted) {
 				startName = newValue; // set the starting name
+				// The primary sender for failover until its full name is found
+				if (primaryName.empty())
+					primaryName = startName;
 			}
 
 			// Find the index of the selected name in the NDI names list
@@ -453,6 +682,9 @@ public:
 							senderName = name;
 							// Set the selected sender name or the old one will be used
 							receiver.SetSenderName(senderName.c_str());
+							// The selected sender is the primary sender for failover
+							primaryName = senderName;
+							UpdateFailover();
 						}
 					}
 				}
@@ -481,13 +713,70 @@ public:
 				// Release the receiver and resources
 				ReleaseNDIreceiver();
 				// Set receiver preferred format
+				// YUV receives the native format of the sender,
+				// UYVY or P216, UYVA or PA16 with alpha
 				if (bYUV)
-					receiver.SetFormat(NDIlib_recv_color_format_UYVY_RGBA);
+					receiver.SetFormat(NDIlib_recv_color_format_best);
 				else
 					receiver.SetFormat(NDIlib_recv_color_format_BGRX_BGRA);
 			}
 			break;
 
+		// Standby senders
+		case PARAM_Standby:
+			SetStandbyNames(newValue);
+			// Backup senders are also standby senders
+			UpdateFailover();
+			break;
+
+		// Pixel buffer upload
+		case PARAM_Buffer:
+			bBuffer = (iValue == 1);
+			if (!bBuffer)
+				ReleasePbos();
+			break;
+
+		// Backup senders
+		case PARAM_Backup:
+			backupNames = SplitNames(newValue);
+			UpdateFailover();
+			break;
+
+		// Timing CSV file
+		case PARAM_Profile:
+			profileFile = newValue;
+			timer.Reset();
+			break;
+
+		// Trace JSON file
+		// Recording starts when a file name is entered
+		// and the file is written when it is cleared
+		case PARAM_Trace:
+			if (ofxNDIutils::IsTracing()) {
+				ofxNDIutils::StopTrace();
+				ofxNDIutils::WriteTrace(traceFile.c_str());
+			}
+			traceFile = newValue;
+			if (!traceFile.empty())
+				ofxNDIutils::StartTrace();
+			break;
+
+		// Find repeated frames by a hash of sampled rows
+		case PARAM_Repeat:
+			receiver.SetRepeatHash(iValue == 1);
+			break;
+
+		// Upload changed tiles
+		case PARAM_Tiles:
+			bTiles = (iValue == 1);
+			bTileValid = false;
+			if (!bTiles) {
+				// Free the previous frame
+				std::vector<unsigned char>().swap(tilePrevious);
+				tileChanged = tileCount = 0;
+			}
+			break;
+
 		default:
 			break;
 
@@ -524,7 +813,20 @@ public:
 			"    Low bandwidth : low resolution receiving mode.\n"
 			"      A medium quality stream that takes almost no bandwidth\n"
 			"      normally about 640 pixels on the longest side.\n"
-			"    YUV : Set to prefer YUV or BGRA data (default BGRA)\n\n"
+			"    YUV : Set to prefer YUV or BGRA data (default BGRA)\n"
+			"      YUV is received in the native format of the sender\n"
+			"      and converted to RGBA by the GPU.\n"
+			"    Standby : sender names, separated by commas, to keep\n"
+			"      connected at low bandwidth for fast switching.\n"
+			"    Backup : sender names, separated by commas, in order\n"
+			"      of preference to switch to if the sender is lost.\n"
+			"      The sender is received again when it is stable.\n"
+			"    Buffering : asynchronous texture upload\n"
+			"      using OpenGL pixel buffers.\n"
+			"    Profile : file to write stage timing (CSV)\n"
+			"    Trace : file to record a trace (JSON)\n"
+			"    Tiles : upload only the tiles that have changed\n"
+			"    Repeat hash : find repeated frames by a hash\n\n"
 			"  Lynn Jarvis 2018-2026\n  https://spout.zeal.co \n"
 			"  ofxNDI Version ";
 		hlp += ofxNDIutils::GetVersion(); hlp += "\n";
@@ -538,6 +840,40 @@ public:
 		std::string NDInumber = receiver.GetNDIversion().substr(NDIversion.length() - 8, 8);
 		hlp += NDInumber;
 
+		// Receiver statistics
+		if (bInitialized) {
+			ofxNDIreceiveStats stats = receiver.GetStats();
+			char tmp[256]{};
+			sprintf_s(tmp, 256, "\n\n  Video frames %lld, dropped %lld, queued %d\n",
+				stats.videoFrames, stats.videoDropped, stats.videoQueue);
+			hlp += tmp;
+			sprintf_s(tmp, 256, "  Jitter mean %.2f msec, max %.2f msec\n",
+				stats.jitterMean, stats.jitterMax);
+			hlp += tmp;
+			sprintf_s(tmp, 256, "  Capture %.3f, upload %.3f, convert %.3f msec",
+				stats.stageTime[ofxNDI_stage_capture],
+				stats.stageTime[ofxNDI_stage_upload],
+				stats.stageTime[ofxNDI_stage_convert]);
+			hlp += tmp;
+			if (!backupNames.empty()) {
+				sprintf_s(tmp, 256, "\n  %s, last switch %.3f msec",
+					receiver.IsFailover() ? "Backup" : "Primary",
+					receiver.GetFailoverLatency());
+				hlp += tmp;
+			}
+			if (receiver.GetRepeatFrames() > 0) {
+				sprintf_s(tmp, 256, "\n  Repeated frames %lld", receiver.GetRepeatFrames());
+				hlp += tmp;
+			}
+			if (bTiles && tileCount > 0) {
+				sprintf_s(tmp, 256, "\n  Tiles changed %u of %u", tileChanged, tileCount);
+				hlp += tmp;
+			}
+			// Stage timing
+			hlp += "\n\n";
+			hlp += timer.GetText();
+		}
+
 		return hlp.c_str();
 	}
 
@@ -545,7 +881,12 @@ protected:
 
 	// Initialize in constructor
 	ofxNDIreceive receiver; // NDI receiver object
-	unsigned char *spout_buffer = nullptr; // Buffer used for image transfer
+	resourcePool pool; // Textures and pixel buffers for re-use
+	stageTimer timer; // Stage timing
+	int STAGE_Capture, STAGE_Tiles, STAGE_Upload, STAGE_Convert, STAGE_Draw;
+	std::string profileFile; // CSV file for stage timing
+	std::chrono::steady_clock::time_point profileTime; // last written
+	std::string traceFile; // JSON file for tracing
 	std::string senderName; // full NDI sender name used by a receiver
 	std::string startName;// used to wait for a selected sender to start
 	int senderIndex; // index into the list of NDI senders
@@ -553,47 +894,565 @@ protected:
 	unsigned int senderHeight;
 	GLuint myTexture; // RGBA data
 	GLuint yuvTexture; // YUV data
+	GLuint planeTexture[3]; // Planar YUV data
+	NDIlib_FourCC_video_type_e planeFourCC; // Format of the plane textures
 
 	bool bInitialized; // NDI is initialized
 	bool bStarted; // module has started
 	bool bNewContext; // glInit has been called
 	bool bAspect; // preserve aspect ratio of received texture in draw
 	bool bLowres; // low bandwidth receiving mode
+	bool bBuffer; // pixel buffer texture upload
+	GLuint m_pbo[3]; // Unpack pixel buffers
+	GLsync m_pboFence[3]; // Upload fence for each pixel buffer
+	void* m_pboMemory[3]; // Persistent mapped pixel buffer memory
+	unsigned int m_pboSize; // Size of each pixel buffer
+	int PboIndex;
+	bool bOpaque; // Texture alpha swizzled to one
+	bool bTextureValid; // myTexture has a received frame
+	bool bTiles; // Upload changed tiles
+	bool bTileValid; // tilePrevious is the same as the texture
+	NDIlib_FourCC_video_type_e tileFourCC; // Format of tilePrevious
+	std::vector<unsigned char> tilePrevious; // Last frame uploaded
+	std::vector<unsigned char> tileDirty; // Changed tiles of the frame
+	unsigned int tileChanged; // Number of changed tiles of the last frame
+	unsigned int tileCount; // Number of tiles of a frame
+	struct tileRect {
+		unsigned int x, y, width, height; // Pixels
+	};
+	std::vector<tileRect> tileRects; // Changed tiles, adjacent tiles in a row together
 	std::string hlp; // Help text
+	std::vector<std::string> standbyNames; // Shortened names of standby senders
+	std::vector<std::string> backupNames; // Shortened names of backup senders
+	std::string primaryName; // Full NDI name of the selected sender for failover, or the saved name until found
+
+	// Split a comma separated list of names
+	std::vector<std::string> SplitNames(const char* names)
+	{
+		std::vector<std::string> namelist;
+		std::string list = names;
+		size_t start = 0;
+		while (start <= list.length()) {
+			size_t end = list.find(',', start);
+			if (end == std::string::npos)
+				end = list.length();
+			std::string name = list.substr(start, end - start);
+			// Trim spaces
+			name.erase(0, name.find_first_not_of(' '));
+			name.erase(name.find_last_not_of(' ') + 1);
+			if (!name.empty())
+				namelist.push_back(name);
+			start = end + 1;
+		}
+		return namelist;
+	}
+
+	// Shortened name shown in the dialog, the part within brackets
+	// of the full NDI name "MACHINE (source)"
+	std::string ShortName(const std::string &name)
+	{
+		size_t start = name.find_first_of('(');
+		size_t end = name.find_last_of(')');
+		if (start == std::string::npos || end == std::string::npos || end <= start)
+			return name;
+		return name.substr(start + 1, end - start - 1);
+	}
+
+	// Does a full NDI sender name match a name entered by the user,
+	// either the whole name or the shortened name shown in the dialog
+	bool IsSenderName(const std::string &name, const std::string &entry)
+	{
+		return name == entry || ShortName(name) == entry;
+	}
+
+	// Set the standby sender names from a comma separated list
+	void SetStandbyNames(const char* names)
+	{
+		standbyNames = SplitNames(names);
+		receiver.ClearStandby();
+
+		// Add senders that are running now
+		// Others are added when they are found
+		int nsenders = receiver.GetSenderCount();
+		for (int i = 0; i < nsenders; i++) {
+			std::string name = receiver.GetSenderName(i);
+			if (IsStandbyName(name))
+				receiver.AddStandby(name);
+		}
+	}
+
+	// Is failover set up with a primary sender and backup senders
+	bool HasFailover()
+	{
+		return !backupNames.empty() && !primaryName.empty();
+	}
+
+	// Update the primary and backup senders for failover.
+	// The primary sender is the one selected by the user and does not
+	// change while receiving from a backup sender. It is the shortened
+	// name saved with the scene until that sender has been found.
+	// Backup senders that are running are found by their names.
+	void UpdateFailover()
+	{
+		if (backupNames.empty()) {
+			receiver.ClearFailover();
+			return;
+		}
+		if (primaryName.empty())
+			return;
+
+		std::vector<std::string> backups;
+		int nsenders = receiver.GetSenderCount();
+		for (size_t i = 0; i < backupNames.size(); i++) {
+			for (int j = 0; j < nsenders; j++) {
+				std::string name = receiver.GetSenderName(j);
+				if (name != primaryName && IsSenderName(name, backupNames[i])) {
+					backups.push_back(name);
+					break;
+				}
+			}
+		}
+		receiver.SetFailover(primaryName, backups);
+	}
+
+	// Is a full NDI sender name in the standby list
+	bool IsStandbyName(const std::string &name)
+	{
+		for (size_t i = 0; i < standbyNames.size(); i++) {
+			if (IsSenderName(name, standbyNames[i]))
+				return true;
+		}
+		return false;
+	}
 
 	// Initialize local OpenGL texture
+	// The texture is taken from the pool and the existing one returned to it.
 	void InitTexture(GLuint &texID, GLenum GLformat, unsigned int width, unsigned int height)
 	{
-		// Release any existing texture
-		if (texID != 0) 
-			glDeleteTextures(1, &texID);
-
-		// Generate a new one
-		glGenTextures(1, &texID);
+		pool.ReleaseTexture(texID);
+		texID = pool.GetTexture(width, height, GLformat);
 
+		// A re-used texture might have the alpha swizzled
 		glBindTexture(GL_TEXTURE_2D, texID);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		// glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spout_buffer);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_ALPHA);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		bOpaque = false;
+
+		// The texture contents are undefined
+		bTextureValid = false;
+		bTileValid = false;
+
+	}
+
+	// OpenGL pixel format to upload an NDI video frame
+	// without conversion. Zero if not supported.
+	GLenum GetUploadFormat(NDIlib_FourCC_video_type_e fourcc)
+	{
+		switch (fourcc) {
+			case NDIlib_FourCC_type_BGRA:
+			case NDIlib_FourCC_type_BGRX:
+				return GL_BGRA;
+			case NDIlib_FourCC_type_RGBA:
+			case NDIlib_FourCC_type_RGBX:
+				return GL_RGBA;
+			default:
+				return 0;
+		}
+	}
+
+	// Swizzle texture alpha to one for formats without alpha
+	void SetTextureAlpha(GLuint TextureID, bool bOne)
+	{
+		if (bOne == bOpaque)
+			return;
+		glBindTexture(GL_TEXTURE_2D, TextureID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, bOne ? GL_ONE : GL_ALPHA);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		bOpaque = bOne;
+	}
+
+	// Update a texture with video frame pixels
+	// using pixel buffers if enabled or glTexSubImage2D
+	// gltype is GL_UNSIGNED_SHORT for 16 bit planes
+	void UploadTexture(GLuint TextureID, unsigned int width, unsigned int height,
+		GLenum glformat, const unsigned char* data, unsigned int pitch,
+		GLenum gltype = GL_UNSIGNED_BYTE)
+	{
+		if (bBuffer && UploadTexturePixels(TextureID, width, height, glformat, data, pitch, gltype))
+			return;
+		glBindTexture(GL_TEXTURE_2D, TextureID);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch/TexelSize(glformat, gltype));
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, glformat, gltype, (GLvoid *)data);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 		glBindTexture(GL_TEXTURE_2D, 0);
+	}
 
-		// Update the RGBA receiving buffer
-		if (spout_buffer)
-			free((void*)spout_buffer);
-		spout_buffer = (unsigned char*)malloc(width*height*4*sizeof(unsigned char));
+	//
+	// Changed tiles
+	//
+	// Each frame is compared with the last in tiles of TILE_SIZE pixels.
+	// Only the tiles that have changed are uploaded and converted.
+	// If more than half have changed, the whole frame is uploaded.
+	//
+
+	// Compare a frame with the last frame uploaded
+	// Returns true if only the changed tiles in tileRects are to be uploaded
+	bool CompareTiles(const unsigned char* data, unsigned int pitch,
+		unsigned int rowbytes, unsigned int height, unsigned int tilebytes,
+		NDIlib_FourCC_video_type_e fourcc)
+	{
+		tileRects.clear();
+		if (!bTiles || !data)
+			return false;
+
+		// Copy the whole frame if there is no last frame to compare
+		const size_t size = (size_t)rowbytes*height;
+		if (!bTileValid || fourcc != tileFourCC || tilePrevious.size() != size) {
+			tilePrevious.resize(size);
+			ofxNDIutils::CopyImage((const void*)data, (void*)tilePrevious.data(),
+				rowbytes/4, height, pitch, rowbytes, false);
+			tileFourCC = fourcc;
+			bTileValid = true;
+			tileChanged = tileCount = 0;
+			return false;
+		}
+
+		BeginStage(STAGE_Tiles);
+		tileChanged = ofxNDIutils::DirtyTiles(data, tilePrevious.data(),
+			rowbytes, height, pitch, tilebytes, TILE_SIZE, tileDirty);
+		tileCount = (unsigned int)tileDirty.size();
+		EndStage(STAGE_Tiles);
+
+		if (tileChanged*2 > tileCount)
+			return false;
 
-		// To prevent artefacts when the texture is first drawn, clear with zero chars.
-		// Noticeable with low frame rate sources such as NDI "Test Pattern"
-		// Can use the receiving buffer here for this.
-		if (spout_buffer)
-			memset(spout_buffer, 0, width*height*4* sizeof(unsigned char));
+		// Adjacent changed tiles in a row are uploaded together
+		const unsigned int width = rowbytes/(tilebytes/TILE_SIZE);
+		const unsigned int tilesX = (rowbytes + tilebytes - 1)/tilebytes;
+		for (unsigned int i = 0; i < tileCount; i++) {
+			if (!tileDirty[i])
+				continue;
+			const unsigned int tx = i%tilesX;
+			tileRect rect;
+			rect.x = tx*TILE_SIZE;
+			rect.y = (i/tilesX)*TILE_SIZE;
+			unsigned int end = tx;
+			while (end < tilesX && tileDirty[i + end - tx])
+				end++;
+			rect.width  = (std::min)(width, end*TILE_SIZE) - rect.x;
+			rect.height = (std::min)(height, rect.y + TILE_SIZE) - rect.y;
+			tileRects.push_back(rect);
+			i += end - tx - 1;
+		}
+
+		return true;
+	}
+
+	// Upload the changed tiles of a frame
+	// - pixels | frame pixels for each RGBA texel, 2 for UYVY
+	void UploadTiles(GLuint TextureID, GLenum glformat,
+		const unsigned char* data, unsigned int pitch, unsigned int pixels)
+	{
+		glBindTexture(GL_TEXTURE_2D, TextureID);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch/4);
+		for (size_t i = 0; i < tileRects.size(); i++) {
+			const tileRect &rect = tileRects[i];
+			const unsigned int x = rect.x/pixels;
+			glTexSubImage2D(GL_TEXTURE_2D, 0, x, rect.y,
+				(rect.width + pixels - 1)/pixels, rect.height, glformat, GL_UNSIGNED_BYTE,
+				(GLvoid*)(data + (size_t)rect.y*pitch + (size_t)x*4));
+		}
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	// Bytes per texel of an upload format
+	unsigned int TexelSize(GLenum glformat, GLenum gltype)
+	{
+		unsigned int channels = 4;
+		if (glformat == GL_RED)
+			channels = 1;
+		else if (glformat == GL_RG)
+			channels = 2;
+		return (gltype == GL_UNSIGNED_SHORT) ? channels*2 : channels;
+	}
 
+	//
+	// Planar YUV
+	//
+	// Each plane is uploaded to its own texture and converted
+	// to RGBA by a compute shader.
+	//   NV12       - Y GL_R8, UV GL_RG8 at half width and height
+	//   I420, YV12 - Y GL_R8, U and V GL_R8 at half width and height
+	//   P216, PA16 - Y GL_R16, UV GL_RG16 at half width, alpha GL_R16
+	//   UYVA       - UYVY GL_RGBA8 at half width, alpha GL_R8
+	//
+
+	bool IsPlanar(NDIlib_FourCC_video_type_e fourcc)
+	{
+		return (fourcc == NDIlib_FourCC_type_NV12
+			|| fourcc == NDIlib_FourCC_type_I420
+			|| fourcc == NDIlib_FourCC_type_YV12
+			|| fourcc == NDIlib_FourCC_type_P216
+			|| fourcc == NDIlib_FourCC_type_PA16
+			|| fourcc == NDIlib_FourCC_type_UYVA);
+	}
+
+	// NDI uses BT.601 for SD and BT.709 for HD resolutions
+	bool IsBT601()
+	{
+		return (senderHeight < 720);
+	}
+
+	// Create textures for the planes of a format
+	void InitPlanes(NDIlib_FourCC_video_type_e fourcc, unsigned int width, unsigned int height)
+	{
+		ReleasePlanes();
+
+		// Chroma dimensions
+		const unsigned int cw = (width+1)/2;
+		const unsigned int ch = (height+1)/2;
+
+		switch (fourcc) {
+			case NDIlib_FourCC_type_NV12:
+				InitPlaneTexture(planeTexture[0], GL_R8, width, height);
+				InitPlaneTexture(planeTexture[1], GL_RG8, cw, ch);
+				break;
+			case NDIlib_FourCC_type_I420:
+			case NDIlib_FourCC_type_YV12:
+				InitPlaneTexture(planeTexture[0], GL_R8, width, height);
+				InitPlaneTexture(planeTexture[1], GL_R8, cw, ch);
+				InitPlaneTexture(planeTexture[2], GL_R8, cw, ch);
+				break;
+			case NDIlib_FourCC_type_P216:
+			case NDIlib_FourCC_type_PA16:
+				InitPlaneTexture(planeTexture[0], GL_R16, width, height);
+				InitPlaneTexture(planeTexture[1], GL_RG16, cw, height);
+				if (fourcc == NDIlib_FourCC_type_PA16)
+					InitPlaneTexture(planeTexture[2], GL_R16, width, height);
+				break;
+			case NDIlib_FourCC_type_UYVA:
+				InitPlaneTexture(planeTexture[0], GL_RGBA8, cw, height);
+				InitPlaneTexture(planeTexture[1], GL_R8, width, height);
+				break;
+			default:
+				return;
+		}
+		planeFourCC = fourcc;
+	}
+
+	// Plane texture for compute shader image load
+	void InitPlaneTexture(GLuint &texID, GLenum internalformat, unsigned int width, unsigned int height)
+	{
+		texID = pool.GetTexture(width, height, internalformat);
+	}
+
+	void ReleasePlanes()
+	{
+		for (int i = 0; i < 3; i++)
+			pool.ReleaseTexture(planeTexture[i]);
+		planeFourCC = (NDIlib_FourCC_video_type_e)0;
+	}
+
+	// Upload the planes of a video frame.
+	// The planes follow each other in memory.
+	// stride is the line pitch of the first plane.
+	void UploadPlanes(const unsigned char* data, unsigned int stride, unsigned int width, unsigned int height)
+	{
+		if (!data)
+			return;
+
+		const unsigned int cw = (width+1)/2;
+		const unsigned int ch = (height+1)/2;
+
+		switch (planeFourCC) {
+			case NDIlib_FourCC_type_NV12:
+				UploadTexture(planeTexture[0], width, height, GL_RED, data, stride);
+				UploadTexture(planeTexture[1], cw, ch, GL_RG, data + stride*height, stride);
+				break;
+			case NDIlib_FourCC_type_I420:
+			case NDIlib_FourCC_type_YV12:
+				// U then V for I420, V then U for YV12
+				UploadTexture(planeTexture[0], width, height, GL_RED, data, stride);
+				UploadTexture(planeTexture[1], cw, ch, GL_RED, data + stride*height, stride/2);
+				UploadTexture(planeTexture[2], cw, ch, GL_RED, data + stride*height + (stride/2)*ch, stride/2);
+				break;
+			case NDIlib_FourCC_type_P216:
+			case NDIlib_FourCC_type_PA16:
+				UploadTexture(planeTexture[0], width, height, GL_RED, data, stride, GL_UNSIGNED_SHORT);
+				UploadTexture(planeTexture[1], cw, height, GL_RG, data + stride*height, stride, GL_UNSIGNED_SHORT);
+				if (planeFourCC == NDIlib_FourCC_type_PA16)
+					UploadTexture(planeTexture[2], width, height, GL_RED, data + stride*height*2, stride, GL_UNSIGNED_SHORT);
+				break;
+			case NDIlib_FourCC_type_UYVA:
+				UploadTexture(planeTexture[0], cw, height, GL_RGBA, data, stride);
+				UploadTexture(planeTexture[1], width, height, GL_RED, data + stride*height, stride/2);
+				break;
+			default:
+				break;
+		}
+	}
+
+	// Convert the plane textures to RGBA
+	bool ConvertPlanes(GLuint DestID, unsigned int width, unsigned int height)
+	{
+		ofxNDIutils::TraceSpan span("yuvShaders::PlanarToRgba");
+		switch (planeFourCC) {
+			case NDIlib_FourCC_type_NV12:
+				return shaders.NV12toRgba(planeTexture[0], planeTexture[1], DestID, width, height, IsBT601());
+			case NDIlib_FourCC_type_I420:
+				return shaders.I420toRgba(planeTexture[0], planeTexture[1], planeTexture[2], DestID, width, height, IsBT601());
+			case NDIlib_FourCC_type_YV12:
+				return shaders.I420toRgba(planeTexture[0], planeTexture[2], planeTexture[1], DestID, width, height, IsBT601());
+			case NDIlib_FourCC_type_P216:
+			case NDIlib_FourCC_type_PA16:
+				return shaders.P216toRgba(planeTexture[0], planeTexture[1], planeTexture[2], DestID, width, height, IsBT601());
+			case NDIlib_FourCC_type_UYVA:
+				return shaders.UYVAtoRgba(planeTexture[0], planeTexture[1], DestID, width, height, IsBT601());
+			default:
+				return false;
+		}
 	}
 
 
+	//
+	// Asynchronous texture upload using persistent mapped pixel buffers.
+	// The frame is copied to the next buffer so that the NDI video frame
+	// can be freed immediately. The texture is then updated from the buffer
+	// by DMA without waiting. A fence for each buffer prevents it being
+	// written again before the upload from it has completed.
+	// glformat and gltype describe the pixels of the frame or plane.
+	//
+	bool UploadTexturePixels(GLuint TextureID, unsigned int width, unsigned int height,
+		GLenum glformat, const unsigned char* data, unsigned int pitch,
+		GLenum gltype = GL_UNSIGNED_BYTE)
+	{
+		if (data == nullptr || TextureID == 0)
+			return false;
+
+		// Create or enlarge the pixel buffers
+		const unsigned int linesize = width*TexelSize(glformat, gltype);
+		unsigned int size = linesize*height;
+		if (m_pbo[0] == 0 || size > m_pboSize) {
+			if (!InitPbos(size))
+				return false;
+		}
+
+		PboIndex = (PboIndex + 1) % 3;
+
+		// Wait for any upload still in progress from this buffer.
+		// With three buffers this has normally completed.
+		if (m_pboFence[PboIndex]) {
+			GLenum result = glClientWaitSync(m_pboFence[PboIndex], GL_SYNC_FLUSH_COMMANDS_BIT, 4000000); // 4 msec
+			glDeleteSync(m_pboFence[PboIndex]);
+			m_pboFence[PboIndex] = nullptr;
+			if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED)
+				return false;
+		}
+
+		// Copy the frame to the mapped buffer allowing for the source line pitch
+		unsigned char* dest = (unsigned char*)m_pboMemory[PboIndex];
+		if (pitch == linesize) {
+			memcpy(dest, data, size);
+		}
+		else {
+			for (unsigned int y = 0; y < height; y++)
+				memcpy(dest + y*linesize, data + y*pitch, linesize);
+		}
+
+		// Update the texture from the buffer - returns immediately
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[PboIndex]);
+		glBindTexture(GL_TEXTURE_2D, TextureID);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, glformat, gltype, (GLvoid*)0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		// Fence to signal when the upload from this buffer is complete
+		m_pboFence[PboIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		return true;
+	}
+
+	// Create persistent mapped unpack pixel buffers
+	bool InitPbos(unsigned int size)
+	{
+		ReleasePbos();
+
+		if (!glBufferStorage || !glMapBufferRange || !glFenceSync)
+			return false;
+
+		// Buffers released for a smaller size can be re-used
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		for (int i = 0; i < 3; i++) {
+			m_pbo[i] = pool.GetBuffer(size, flags, &m_pboMemory[i]);
+			if (!m_pbo[i] || !m_pboMemory[i]) {
+				printf("MagicNDIreceiver : InitPbos - could not map pixel buffer\n");
+				ReleasePbos();
+				bBuffer = false; // Use glTexSubImage2D
+				return false;
+			}
+		}
+		m_pboSize = size;
+		PboIndex = 0;
+
+		return true;
+	}
+
+	// Release pixel buffers and fences
+	void ReleasePbos()
+	{
+		for (int i = 0; i < 3; i++) {
+			// The buffer stays mapped in the pool, so wait for
+			// any upload from it before it can be used again
+			if (m_pboFence[i]) {
+				glClientWaitSync(m_pboFence[i], GL_SYNC_FLUSH_COMMANDS_BIT, 4000000); // 4 msec
+				glDeleteSync(m_pboFence[i]);
+			}
+			m_pboFence[i] = nullptr;
+			m_pboMemory[i] = nullptr;
+			pool.ReleaseBuffer(m_pbo[i]);
+		}
+		m_pboSize = 0;
+	}
+
+	// Time a stage and record it in the trace
+	void BeginStage(int stage)
+	{
+		ofxNDIutils::TraceBegin(timer.GetName(stage));
+		timer.Begin(stage);
+	}
+
+	void EndStage(int stage)
+	{
+		timer.End(stage);
+		ofxNDIutils::TraceEnd();
+	}
+
+	// End timing a stage and record the CPU time in the receiver statistics
+	void EndStage(int stage, ofxNDIstage ndistage)
+	{
+		EndStage(stage);
+		receiver.SetStageTime(ndistage, timer.GetLast(stage));
+	}
+
+	// Write stage timing to the profile file every 5 seconds
+	void WriteProfile()
+	{
+		if (profileFile.empty())
+			return;
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now - profileTime > std::chrono::seconds(5)) {
+			timer.WriteCSV(profileFile.c_str());
+			profileTime = now;
+		}
+	}
+
 	// Release receiver and resources
 	void ReleaseNDIreceiver()
 	{
@@ -602,14 +1461,11 @@ protected:
 
 		// Release NDI receiver
 		receiver.ReleaseReceiver();
-		// Free the receiving buffer and texture 
+		// Return the textures to the pool
 		// because the receiving resolution might change
-		if (spout_buffer) free((void*)spout_buffer);
-		spout_buffer = nullptr;
-		if (myTexture != 0) glDeleteTextures(1, &myTexture);
-		myTexture = 0;
-		if (yuvTexture != 0) glDeleteTextures(1, &yuvTexture);
-		yuvTexture = 0;
+		pool.ReleaseTexture(myTexture);
+		pool.ReleaseTexture(yuvTexture);
+		ReleasePlanes();
 		senderWidth = 0;
 		senderHeight = 0;
 		bInitialized = false;
@@ -697,6 +1553,24 @@ const MagicModuleParam MagicNDIreceiverModule::params[NumParams] = {
 	MagicModuleParam("YUV", "0", "0", "1", MVT_BOOL, MWT_TOGGLEBUTTON, false, "Receive YUV or RGBA data\n"
 			"RGBA is uncompressed and highest quality with alpha. "
 			"YUV is a compressed format but is more speed efficient. "
-			"The difference is more noticeable at high resolutions.")
+			"The difference is more noticeable at high resolutions."),
+	MagicModuleParam("Standby", "", NULL, NULL, MVT_STRING, MWT_TEXTBOX, false, "Sender names as shown in the list, or full NDI names, "
+			"separated by commas, to keep connected at low bandwidth. Switching to a standby sender is almost immediate."),
+	MagicModuleParam("Backup", "", NULL, NULL, MVT_STRING, MWT_TEXTBOX, false, "Sender names, separated by commas, "
+			"in order of preference. If the sender is lost, the first backup sender running is received "
+			"until the sender has been stable for five seconds."),
+	MagicModuleParam("Buffering", "1", "0", "1", MVT_BOOL, MWT_TOGGLEBUTTON, false, "Asynchronous texture upload using OpenGL pixel buffers. "
+			"The received frame is released immediately and the texture is updated without waiting."),
+	MagicModuleParam("Profile", "", NULL, NULL, MVT_STRING, MWT_TEXTBOX, false, "File to write the CPU and GPU time "
+			"of each stage of receiving, as CSV, every 5 seconds. Clear to stop."),
+	MagicModuleParam("Trace", "", NULL, NULL, MVT_STRING, MWT_TEXTBOX, false, "File to record the start and duration "
+			"of each stage and NDI receive. Clear to stop and write the file, which can be opened with "
+			"chrome://tracing or https://ui.perfetto.dev"),
+	MagicModuleParam("Tiles", "0", "0", "1", MVT_BOOL, MWT_TOGGLEBUTTON, false, "Compare each frame with the last "
+			"in 64x64 pixel tiles and upload and convert only the tiles that have changed. "
+			"Reduces upload for slides, titles and screen captures. Not used for planar YUV formats."),
+	MagicModuleParam("Repeat hash", "0", "0", "1", MVT_BOOL, MWT_TOGGLEBUTTON, false, "Repeated frames with the same "
+			"timestamp are drawn again without upload. Also compare a hash of 64 rows of each frame "
+			"to find frames that the sender has sent again with a new timestamp.")
 
 };
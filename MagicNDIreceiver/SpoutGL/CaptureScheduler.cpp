@@ -0,0 +1,223 @@
+/*
+				CaptureScheduler.cpp
+
+		Frame capture at an output rate independent of the render rate
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	Copyright (c) 2026, Lynn Jarvis. All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, 
+	are permitted provided that the following conditions are met:
+
+		1. Redistributions of source code must retain the above copyright notice, 
+		   this list of conditions and the following disclaimer.
+
+		2. Redistributions in binary form must reproduce the above copyright notice, 
+		   this list of conditions and the following disclaimer in the documentation 
+		   and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"	AND ANY 
+	EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+	OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE	ARE DISCLAIMED. 
+	IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+	========================
+
+	18.10.26 - first version
+
+*/
+
+#include "CaptureScheduler.h"
+
+//
+// Class: captureScheduler
+//
+// Decides for each render frame whether to capture it for output.
+//
+// Render time is accumulated in a phase and a frame is captured
+// each time a whole output period has accumulated. The phase is kept
+// in units of 1/(numerator*1e9) second so that for a rational rate N/D
+// the period is exactly D*1e9 units and captures do not drift.
+// The remainder is carried to the next period, so a 144 Hz render
+// captured at 50 fps selects every 2nd or 3rd frame in a fixed pattern.
+//
+// If rendering is slower than the output rate, every frame is captured.
+// After a stall, the phase is restarted rather than capturing a burst
+// of frames to catch up.
+//
+// A capture is deferred to a following frame if the readback
+// of the previous capture has not completed, so that mapping
+// the pixel buffer does not block the render loop.
+//
+
+captureScheduler::captureScheduler() {
+	m_fpsStart = std::chrono::steady_clock::now();
+}
+
+captureScheduler::~captureScheduler() {
+	// Release must be called while the OpenGL context is current
+}
+
+//---------------------------------------------------------
+// Function: SetRate
+// Set the output frame rate as a ratio (frames per second)
+void captureScheduler::SetRate(int numerator, int denominator)
+{
+	if (numerator <= 0 || denominator <= 0)
+		return;
+	m_numerator = numerator;
+	m_denominator = denominator;
+	m_bStarted = false;
+}
+
+//---------------------------------------------------------
+// Function: SetActive
+// Capture every frame if not active
+void captureScheduler::SetActive(bool bActive)
+{
+	m_bActive = bActive;
+	m_bStarted = false;
+}
+
+bool captureScheduler::GetActive()
+{
+	return m_bActive;
+}
+
+//---------------------------------------------------------
+// Function: Capture
+// Decide whether to capture this render frame
+bool captureScheduler::Capture()
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	if (m_bActive) {
+
+		const int64_t period = (int64_t)m_denominator*1000000000LL;
+
+		if (!m_bStarted) {
+			// Capture the first frame
+			m_phase = period;
+			m_last = now;
+			m_bStarted = true;
+		}
+		else {
+			int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_last).count();
+			m_last = now;
+			// Limit to one second in case of a long stall
+			if (ns > 1000000000LL) ns = 1000000000LL;
+			m_phase += ns*(int64_t)m_numerator;
+		}
+
+		if (m_phase < period) {
+			m_skipped++;
+			return false;
+		}
+
+		// Wait for the previous readback to complete
+		if (!ReadbackComplete()) {
+			m_deferred++;
+			return false;
+		}
+
+		m_phase -= period;
+		// More than a period behind, so restart
+		if (m_phase >= period)
+			m_phase = 0;
+	}
+
+	m_captured++;
+
+	// Captured frames per second
+	m_fpsCount++;
+	const double seconds = std::chrono::duration<double>(now - m_fpsStart).count();
+	if (seconds >= 1.0) {
+		m_fps = (double)m_fpsCount/seconds;
+		m_fpsCount = 0;
+		m_fpsStart = now;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: ReadbackStarted
+// Insert a fence after the readback commands of a capture
+void captureScheduler::ReadbackStarted()
+{
+	if (!glFenceSync || !glDeleteSync)
+		return;
+	if (m_fence)
+		glDeleteSync(m_fence);
+	m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+//---------------------------------------------------------
+// Function: ReadbackComplete
+// Whether the last readback has completed, without waiting
+bool captureScheduler::ReadbackComplete()
+{
+	if (!m_fence || !glClientWaitSync)
+		return true;
+
+	const GLenum result = glClientWaitSync(m_fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+		return false;
+
+	// Signalled or failed
+	glDeleteSync(m_fence);
+	m_fence = nullptr;
+
+	return true;
+}
+
+int64_t captureScheduler::GetCaptured()
+{
+	return m_captured;
+}
+
+int64_t captureScheduler::GetSkipped()
+{
+	return m_skipped;
+}
+
+int64_t captureScheduler::GetDeferred()
+{
+	return m_deferred;
+}
+
+double captureScheduler::GetFps()
+{
+	return m_fps;
+}
+
+//---------------------------------------------------------
+// Function: Reset
+// Reset the phase and counts
+void captureScheduler::Reset()
+{
+	m_bStarted = false;
+	m_phase = 0;
+	m_captured = 0;
+	m_skipped = 0;
+	m_deferred = 0;
+	m_fpsCount = 0;
+	m_fps = 0.0;
+	m_fpsStart = std::chrono::steady_clock::now();
+}
+
+//---------------------------------------------------------
+// Function: Release
+// Delete the fence
+void captureScheduler::Release()
+{
+	if (m_fence && glDeleteSync)
+		glDeleteSync(m_fence);
+	m_fence = nullptr;
+}
@@ -0,0 +1,294 @@
+/*
+				ResourcePool.cpp
+
+		Pool of OpenGL textures and pixel buffers for re-use
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	Copyright (c) 2026, Lynn Jarvis. All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, 
+	are permitted provided that the following conditions are met:
+
+		1. Redistributions of source code must retain the above copyright notice, 
+		   this list of conditions and the following disclaimer.
+
+		2. Redistributions in binary form must reproduce the above copyright notice, 
+		   this list of conditions and the following disclaimer in the documentation 
+		   and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"	AND ANY 
+	EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+	OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE	ARE DISCLAIMED. 
+	IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+	========================
+
+	18.10.26 - first version
+
+*/
+
+#include "ResourcePool.h"
+
+//
+// Class: resourcePool
+//
+// Textures are keyed by width, height and internal format.
+// Sources that change resolution, for example between low bandwidth
+// and full resolution, re-use textures already created instead of
+// allocating new storage each time.
+//
+
+resourcePool::resourcePool() {
+
+}
+
+resourcePool::~resourcePool() {
+	// Clear must be called while the OpenGL context is current
+}
+
+//---------------------------------------------------------
+// Function: GetTexture
+//
+GLuint resourcePool::GetTexture(unsigned int width, unsigned int height, GLenum internalformat)
+{
+	if (width == 0 || height == 0)
+		return 0;
+
+	// Immutable storage requires a sized format
+	if (internalformat == GL_RGBA)
+		internalformat = GL_RGBA8;
+
+	// Most recently released first
+	for (auto it = m_textures.rbegin(); it != m_textures.rend(); ++it) {
+		if (!it->bUsed && it->width == width && it->height == height && it->format == internalformat) {
+			poolTexture tex = *it;
+			m_textures.erase(std::next(it).base());
+			tex.bUsed = true;
+			m_textures.push_back(tex);
+			return tex.id;
+		}
+	}
+
+	poolTexture tex{};
+	tex.id = CreateTexture(width, height, internalformat);
+	if (tex.id == 0)
+		return 0;
+	tex.width = width;
+	tex.height = height;
+	tex.format = internalformat;
+	tex.bUsed = true;
+	m_textures.push_back(tex);
+
+	return tex.id;
+}
+
+//---------------------------------------------------------
+// Function: ReleaseTexture
+//
+void resourcePool::ReleaseTexture(GLuint &texID)
+{
+	if (texID == 0)
+		return;
+
+	for (auto it = m_textures.begin(); it != m_textures.end(); ++it) {
+		if (it->id == texID) {
+			// Move to the end as the most recently released
+			poolTexture tex = *it;
+			m_textures.erase(it);
+			tex.bUsed = false;
+			m_textures.push_back(tex);
+			TrimTextures();
+			texID = 0;
+			return;
+		}
+	}
+
+	// Not created by the pool
+	glDeleteTextures(1, &texID);
+	texID = 0;
+}
+
+//---------------------------------------------------------
+// Function: GetBuffer
+//
+GLuint resourcePool::GetBuffer(unsigned int size, GLbitfield flags, void** memory)
+{
+	if (size == 0 || !glBufferStorage)
+		return 0;
+
+	// The smallest released buffer that is large enough
+	int index = -1;
+	for (int i = 0; i < (int)m_buffers.size(); i++) {
+		if (!m_buffers[i].bUsed && m_buffers[i].flags == flags && m_buffers[i].size >= size) {
+			if (index < 0 || m_buffers[i].size < m_buffers[index].size)
+				index = i;
+		}
+	}
+
+	if (index >= 0) {
+		poolBuffer buf = m_buffers[index];
+		m_buffers.erase(m_buffers.begin() + index);
+		buf.bUsed = true;
+		m_buffers.push_back(buf);
+		if (memory) *memory = buf.memory;
+		return buf.id;
+	}
+
+	poolBuffer buf{};
+	glGenBuffers(1, &buf.id);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buf.id);
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+	if (flags & GL_MAP_PERSISTENT_BIT) {
+		buf.memory = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+			flags & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+		if (!buf.memory) {
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			glDeleteBuffers(1, &buf.id);
+			printf("resourcePool::GetBuffer - could not map buffer\n");
+			return 0;
+		}
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	buf.size = size;
+	buf.flags = flags;
+	buf.bUsed = true;
+	m_buffers.push_back(buf);
+
+	if (memory) *memory = buf.memory;
+	return buf.id;
+}
+
+//---------------------------------------------------------
+// Function: ReleaseBuffer
+//
+void resourcePool::ReleaseBuffer(GLuint &bufID)
+{
+	if (bufID == 0)
+		return;
+
+	for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it) {
+		if (it->id == bufID) {
+			poolBuffer buf = *it;
+			m_buffers.erase(it);
+			buf.bUsed = false;
+			m_buffers.push_back(buf);
+			TrimBuffers();
+			bufID = 0;
+			return;
+		}
+	}
+
+	glDeleteBuffers(1, &bufID);
+	bufID = 0;
+}
+
+//---------------------------------------------------------
+// Function: SetMaxFree
+//
+void resourcePool::SetMaxFree(unsigned int textures, unsigned int buffers)
+{
+	m_maxFreeTextures = textures;
+	m_maxFreeBuffers = buffers;
+	TrimTextures();
+	TrimBuffers();
+}
+
+//---------------------------------------------------------
+// Function: Clear
+//
+void resourcePool::Clear()
+{
+	for (auto &tex : m_textures)
+		glDeleteTextures(1, &tex.id);
+	m_textures.clear();
+
+	for (auto &buf : m_buffers) {
+		if (buf.memory) {
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buf.id);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		}
+		glDeleteBuffers(1, &buf.id);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	m_buffers.clear();
+}
+
+//---------------------------------------------------------
+// Function: CreateTexture
+// Immutable storage if glTextureStorage2D is available
+GLuint resourcePool::CreateTexture(unsigned int width, unsigned int height, GLenum internalformat)
+{
+	GLuint texID = 0;
+
+	if (glCreateTextures && glTextureStorage2D) {
+		glCreateTextures(GL_TEXTURE_2D, 1, &texID);
+		glTextureStorage2D(texID, 1, internalformat, (GLsizei)width, (GLsizei)height);
+		glBindTexture(GL_TEXTURE_2D, texID);
+	}
+	else {
+		glGenTextures(1, &texID);
+		glBindTexture(GL_TEXTURE_2D, texID);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalformat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return texID;
+}
+
+//---------------------------------------------------------
+// Function: TrimTextures
+// Delete the least recently released textures
+void resourcePool::TrimTextures()
+{
+	unsigned int nfree = 0;
+	for (auto &tex : m_textures) {
+		if (!tex.bUsed) nfree++;
+	}
+	auto it = m_textures.begin();
+	while (nfree > m_maxFreeTextures && it != m_textures.end()) {
+		if (!it->bUsed) {
+			glDeleteTextures(1, &it->id);
+			it = m_textures.erase(it);
+			nfree--;
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: TrimBuffers
+// Delete the least recently released buffers
+void resourcePool::TrimBuffers()
+{
+	unsigned int nfree = 0;
+	for (auto &buf : m_buffers) {
+		if (!buf.bUsed) nfree++;
+	}
+	auto it = m_buffers.begin();
+	while (nfree > m_maxFreeBuffers && it != m_buffers.end()) {
+		if (!it->bUsed) {
+			if (it->memory) {
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, it->id);
+				glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			}
+			glDeleteBuffers(1, &it->id);
+			it = m_buffers.erase(it);
+			nfree--;
+		}
+		else {
+			++it;
+		}
+	}
+}
@@ -68,6 +68,12 @@
 //			28.09.24	- SpoutGLextensions.h - add #define GL_TEXTURE_SWIZZLE_RGBA
 //			22.10.24	- Add glIsMemoryObjectEXT, glCreateBuffers
 //			25.03.25	- ExtLog - changed "standalone" to "standaloneExtensions"
+//			18.10.26	- SpoutGLextensions.h - correct sync extension declarations
+//						  glClientWaitSync, glDeleteSync, glFenceSync to match definitions
+//						- SpoutGLextensions.h - add #define GL_TEXTURE_SWIZZLE_A
+//						  GL_RG, GL_R8, GL_R16, GL_RG8, GL_RG16
+//						- Add timer query extensions and loadQueryExtensions
+//						  USE_QUERY_EXTENSIONS, GLEXT_SUPPORT_QUERY
 //
 /*
 	Copyright (c) 2014-2025, Lynn Jarvis. All rights reserved.
@@ -168,6 +174,19 @@ PFNGLCOPYIMAGESUBDATAPROC glCopyImageSubData = NULL;
 glGetInternalFormativPROC glGetInternalFormativ = NULL;
 #endif
 
+//-------------------
+// Timer query extensions
+//-------------------
+#ifdef USE_QUERY_EXTENSIONS
+glGenQueriesPROC          glGenQueries          = NULL;
+glDeleteQueriesPROC       glDeleteQueries       = NULL;
+glBeginQueryPROC          glBeginQuery          = NULL;
+glEndQueryPROC            glEndQuery            = NULL;
+glQueryCounterPROC        glQueryCounter        = NULL;
+glGetQueryObjectivPROC    glGetQueryObjectiv    = NULL;
+glGetQueryObjectui64vPROC glGetQueryObjectui64v = NULL;
+#endif
+
 //---------------------------
 // Compute shader extensions
 // Disable for Processing library (JSpoutLib)
@@ -589,6 +608,49 @@ bool loadContextExtension()
 }
 
 
+bool loadQueryExtensions()
+{
+
+#ifdef USE_QUERY_EXTENSIONS
+
+#ifdef USE_GLEW
+	if (glQueryCounter && glGetQueryObjectui64v)
+		return true;
+	else
+		return false;
+#else
+
+	// Timer query extensions
+	glGenQueries          = (glGenQueriesPROC)wglGetProcAddress("glGenQueries");
+	glDeleteQueries       = (glDeleteQueriesPROC)wglGetProcAddress("glDeleteQueries");
+	glBeginQuery          = (glBeginQueryPROC)wglGetProcAddress("glBeginQuery");
+	glEndQuery            = (glEndQueryPROC)wglGetProcAddress("glEndQuery");
+	glQueryCounter        = (glQueryCounterPROC)wglGetProcAddress("glQueryCounter");
+	glGetQueryObjectiv    = (glGetQueryObjectivPROC)wglGetProcAddress("glGetQueryObjectiv");
+	glGetQueryObjectui64v = (glGetQueryObjectui64vPROC)wglGetProcAddress("glGetQueryObjectui64v");
+
+	if (glGenQueries != NULL
+		&& glDeleteQueries != NULL
+		&& glBeginQuery != NULL
+		&& glEndQuery != NULL
+		&& glQueryCounter != NULL
+		&& glGetQueryObjectiv != NULL
+		&& glGetQueryObjectui64v != NULL) {
+		return true;
+	}
+	else {
+		return false;
+	}
+#endif
+
+#else
+	// Query extensions defined elsewhere
+	return true;
+#endif
+
+}
+
+
 bool InitializeGlew()
 {
 #ifdef USE_GLEW
@@ -694,6 +756,13 @@ unsigned int loadGLextensions() {
 		ExtLog(SPOUT_EXT_LOG_WARNING, "loadGLextensions : loadContextExtension fail");
 	}
 
+	if (loadQueryExtensions()) {
+		caps |= GLEXT_SUPPORT_QUERY;
+	}
+	else {
+		ExtLog(SPOUT_EXT_LOG_WARNING, "loadGLextensions : loadQueryExtensions fail");
+	}
+
 	// Load wgl interop extensions
 	if (loadInteropExtensions()) {
 		caps |= GLEXT_SUPPORT_NVINTEROP;
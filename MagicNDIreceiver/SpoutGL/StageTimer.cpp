@@ -0,0 +1,383 @@
+/*
+				StageTimer.cpp
+
+		CPU and GPU timing of the stages of a frame
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	Copyright (c) 2026, Lynn Jarvis. All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, 
+	are permitted provided that the following conditions are met:
+
+		1. Redistributions of source code must retain the above copyright notice, 
+		   this list of conditions and the following disclaimer.
+
+		2. Redistributions in binary form must reproduce the above copyright notice, 
+		   this list of conditions and the following disclaimer in the documentation 
+		   and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"	AND ANY 
+	EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+	OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE	ARE DISCLAIMED. 
+	IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+	========================
+
+	18.10.26 - first version
+			 - Add GetName
+			 - Add GetLast for the last time without a summary
+
+*/
+
+#include "StageTimer.h"
+#include <algorithm> // for std::nth_element
+
+//
+// Class: stageTimer
+//
+// CPU time is measured with steady_clock. GPU time uses a pair of
+// GL_TIMESTAMP queries for each stage rather than GL_TIME_ELAPSED,
+// because elapsed time queries cannot be nested or overlap.
+// Queries are used in a ring of STAGETIMER_RING frames and results
+// are read only when available, so timing never stalls the pipeline.
+//
+
+stageTimer::stageTimer() {
+
+}
+
+stageTimer::~stageTimer() {
+	// Release must be called while the OpenGL context is current
+}
+
+//---------------------------------------------------------
+// Function: AddStage
+//
+int stageTimer::AddStage(const char* name, bool bGPU)
+{
+	timerStage stage{};
+	stage.name = name;
+	stage.bGPU = bGPU;
+	m_stages.push_back(stage);
+	return (int)m_stages.size()-1;
+}
+
+//---------------------------------------------------------
+// Function: Begin
+//
+void stageTimer::Begin(int stage)
+{
+	if (stage < 0 || stage >= (int)m_stages.size())
+		return;
+
+	timerStage &st = m_stages[stage];
+
+	if (st.bGPU && glQueryCounter && glGetQueryObjectui64v && wglGetCurrentContext()) {
+
+		// Create queries for the stage
+		if (st.queries[0][0] == 0) {
+			for (int i = 0; i < STAGETIMER_RING; i++)
+				glGenQueries(2, st.queries[i]);
+			m_bQueries = true;
+		}
+
+		st.slot = (st.slot + 1) % STAGETIMER_RING;
+
+		// Collect the previous result from this slot if ready.
+		// Otherwise it is dropped rather than wait for it.
+		if (st.bPending[st.slot]) {
+			GLint available = 0;
+			glGetQueryObjectiv(st.queries[st.slot][1], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available)
+				CollectQuery(st, st.slot);
+			else
+				st.gpuDropped++;
+			st.bPending[st.slot] = false;
+		}
+
+		glQueryCounter(st.queries[st.slot][0], GL_TIMESTAMP);
+	}
+
+	st.start = std::chrono::steady_clock::now();
+}
+
+//---------------------------------------------------------
+// Function: End
+//
+void stageTimer::End(int stage)
+{
+	if (stage < 0 || stage >= (int)m_stages.size())
+		return;
+
+	timerStage &st = m_stages[stage];
+
+	AddTime(stage, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - st.start).count());
+
+	if (st.bGPU && st.queries[0][0] != 0) {
+		glQueryCounter(st.queries[st.slot][1], GL_TIMESTAMP);
+		st.bPending[st.slot] = true;
+	}
+}
+
+//---------------------------------------------------------
+// Function: AddTime
+//
+void stageTimer::AddTime(int stage, double msec)
+{
+	if (stage < 0 || stage >= (int)m_stages.size())
+		return;
+
+	timerStage &st = m_stages[stage];
+	st.cpu[st.cpuPos] = msec;
+	st.cpuPos = (st.cpuPos + 1) % STAGETIMER_SAMPLES;
+	if (st.cpuCount < STAGETIMER_SAMPLES)
+		st.cpuCount++;
+}
+
+//---------------------------------------------------------
+// Function: Update
+//
+void stageTimer::Update()
+{
+	if (!m_bQueries)
+		return;
+
+	for (auto &st : m_stages) {
+		if (st.queries[0][0] == 0)
+			continue;
+		for (int i = 0; i < STAGETIMER_RING; i++) {
+			// The stage in progress is not complete
+			if (!st.bPending[i] || i == st.slot)
+				continue;
+			GLint available = 0;
+			glGetQueryObjectiv(st.queries[i][1], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available) {
+				CollectQuery(st, i);
+				st.bPending[i] = false;
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: GetStage
+//
+bool stageTimer::GetStage(int stage, stageTiming &timing)
+{
+	if (stage < 0 || stage >= (int)m_stages.size())
+		return false;
+
+	const timerStage &st = m_stages[stage];
+	timing.name = st.name;
+	timing.bGPU = st.bGPU && st.queries[0][0] != 0;
+	timing.cpuSamples = st.cpuCount;
+	timing.cpuLast = st.cpuCount > 0 ? st.cpu[(st.cpuPos + STAGETIMER_SAMPLES - 1) % STAGETIMER_SAMPLES] : 0.0;
+	Summarize(st.cpu, st.cpuCount, timing.cpuMean, timing.cpuP50, timing.cpuP95, timing.cpuMax, timing.cpuHistogram);
+	timing.gpuSamples = st.gpuCount;
+	timing.gpuLast = st.gpuCount > 0 ? st.gpu[(st.gpuPos + STAGETIMER_SAMPLES - 1) % STAGETIMER_SAMPLES] : 0.0;
+	Summarize(st.gpu, st.gpuCount, timing.gpuMean, timing.gpuP50, timing.gpuP95, timing.gpuMax, timing.gpuHistogram);
+	timing.gpuDropped = st.gpuDropped;
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: GetLast
+// Last CPU or GPU time of a stage, 0 if none.
+// No summary of the samples, so it can be used every frame.
+//
+double stageTimer::GetLast(int stage, bool bGPU)
+{
+	if (stage < 0 || stage >= (int)m_stages.size())
+		return 0.0;
+
+	const timerStage &st = m_stages[stage];
+	if (bGPU)
+		return st.gpuCount > 0 ? st.gpu[(st.gpuPos + STAGETIMER_SAMPLES - 1) % STAGETIMER_SAMPLES] : 0.0;
+	return st.cpuCount > 0 ? st.cpu[(st.cpuPos + STAGETIMER_SAMPLES - 1) % STAGETIMER_SAMPLES] : 0.0;
+}
+
+//---------------------------------------------------------
+// Function: GetStageCount
+//
+int stageTimer::GetStageCount()
+{
+	return (int)m_stages.size();
+}
+
+//---------------------------------------------------------
+// Function: GetName
+//
+const char* stageTimer::GetName(int stage)
+{
+	if (stage < 0 || stage >= (int)m_stages.size())
+		return "";
+	return m_stages[stage].name.c_str();
+}
+
+//---------------------------------------------------------
+// Function: GetFrameTime
+//
+double stageTimer::GetFrameTime(bool bGPU)
+{
+	double total = 0.0;
+	stageTiming timing;
+	for (int i = 0; i < (int)m_stages.size(); i++) {
+		if (GetStage(i, timing))
+			total += bGPU ? timing.gpuMean : timing.cpuMean;
+	}
+	return total;
+}
+
+//---------------------------------------------------------
+// Function: GetText
+// Mean and 95th percentile for each stage
+std::string stageTimer::GetText()
+{
+	std::string text = "    Stage         CPU mean (p95)    GPU mean (p95) msec\n";
+	char tmp[256]{};
+	stageTiming timing;
+	for (int i = 0; i < (int)m_stages.size(); i++) {
+		GetStage(i, timing);
+		if (timing.bGPU && timing.gpuSamples > 0) {
+			sprintf_s(tmp, 256, "    %-12s  %6.2f (%6.2f)    %6.2f (%6.2f)\n",
+				timing.name.c_str(), timing.cpuMean, timing.cpuP95, timing.gpuMean, timing.gpuP95);
+		}
+		else {
+			sprintf_s(tmp, 256, "    %-12s  %6.2f (%6.2f)         -\n",
+				timing.name.c_str(), timing.cpuMean, timing.cpuP95);
+		}
+		text += tmp;
+	}
+	sprintf_s(tmp, 256, "    Total         %6.2f             %6.2f\n",
+		GetFrameTime(false), GetFrameTime(true));
+	text += tmp;
+	return text;
+}
+
+//---------------------------------------------------------
+// Function: WriteCSV
+// One line for the CPU and one for the GPU times of each stage
+bool stageTimer::WriteCSV(const char* path)
+{
+	if (!path || !*path)
+		return false;
+
+	FILE* file = nullptr;
+	if (fopen_s(&file, path, "w") != 0 || !file) {
+		printf("stageTimer::WriteCSV - could not open [%s]\n", path);
+		return false;
+	}
+
+	fprintf(file, "stage,timer,samples,mean,p50,p95,max,dropped");
+	for (int b = 0; b < STAGETIMER_BINS; b++)
+		fprintf(file, ",<%.1f", (b < STAGETIMER_BINS-1) ? (b+1)*STAGETIMER_BINWIDTH : 1000.0);
+	fprintf(file, "\n");
+
+	stageTiming timing;
+	for (int i = 0; i < (int)m_stages.size(); i++) {
+		GetStage(i, timing);
+		fprintf(file, "%s,cpu,%u,%.4f,%.4f,%.4f,%.4f,0", timing.name.c_str(),
+			timing.cpuSamples, timing.cpuMean, timing.cpuP50, timing.cpuP95, timing.cpuMax);
+		for (int b = 0; b < STAGETIMER_BINS; b++)
+			fprintf(file, ",%u", timing.cpuHistogram[b]);
+		fprintf(file, "\n");
+		if (timing.bGPU) {
+			fprintf(file, "%s,gpu,%u,%.4f,%.4f,%.4f,%.4f,%u", timing.name.c_str(),
+				timing.gpuSamples, timing.gpuMean, timing.gpuP50, timing.gpuP95, timing.gpuMax,
+				timing.gpuDropped);
+			for (int b = 0; b < STAGETIMER_BINS; b++)
+				fprintf(file, ",%u", timing.gpuHistogram[b]);
+			fprintf(file, "\n");
+		}
+	}
+
+	fclose(file);
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Reset
+//
+void stageTimer::Reset()
+{
+	for (auto &st : m_stages) {
+		st.cpuCount = st.cpuPos = 0;
+		st.gpuCount = st.gpuPos = 0;
+		st.gpuDropped = 0;
+	}
+}
+
+//---------------------------------------------------------
+// Function: Release
+//
+void stageTimer::Release()
+{
+	for (auto &st : m_stages) {
+		if (st.queries[0][0] != 0 && glDeleteQueries) {
+			for (int i = 0; i < STAGETIMER_RING; i++)
+				glDeleteQueries(2, st.queries[i]);
+		}
+		for (int i = 0; i < STAGETIMER_RING; i++) {
+			st.queries[i][0] = st.queries[i][1] = 0;
+			st.bPending[i] = false;
+		}
+		st.slot = 0;
+	}
+	m_bQueries = false;
+}
+
+//---------------------------------------------------------
+// Function: CollectQuery
+// Read the timestamps of a completed query pair
+void stageTimer::CollectQuery(timerStage &st, int slot)
+{
+	GLuint64 start = 0;
+	GLuint64 end = 0;
+	glGetQueryObjectui64v(st.queries[slot][0], GL_QUERY_RESULT, &start);
+	glGetQueryObjectui64v(st.queries[slot][1], GL_QUERY_RESULT, &end);
+	if (end < start)
+		return;
+	st.gpu[st.gpuPos] = (double)(end - start)/1000000.0; // nanoseconds to msec
+	st.gpuPos = (st.gpuPos + 1) % STAGETIMER_SAMPLES;
+	if (st.gpuCount < STAGETIMER_SAMPLES)
+		st.gpuCount++;
+}
+
+//---------------------------------------------------------
+// Function: Summarize
+// Statistics and histogram of the rolling samples
+void stageTimer::Summarize(const double* samples, unsigned int count,
+	double &mean, double &p50, double &p95, double &max,
+	unsigned int* histogram)
+{
+	mean = p50 = p95 = max = 0.0;
+	for (int b = 0; b < STAGETIMER_BINS; b++)
+		histogram[b] = 0;
+	if (count == 0)
+		return;
+
+	std::vector<double> sorted(samples, samples + count);
+	double total = 0.0;
+	for (double t : sorted) {
+		total += t;
+		if (t > max) max = t;
+		int bin = (int)(t/STAGETIMER_BINWIDTH);
+		if (bin >= STAGETIMER_BINS) bin = STAGETIMER_BINS-1;
+		if (bin < 0) bin = 0;
+		histogram[bin]++;
+	}
+	mean = total/(double)count;
+
+	std::nth_element(sorted.begin(), sorted.begin() + count/2, sorted.end());
+	p50 = sorted[count/2];
+	const unsigned int n95 = (count*95)/100;
+	std::nth_element(sorted.begin(), sorted.begin() + n95, sorted.end());
+	p95 = sorted[n95];
+}
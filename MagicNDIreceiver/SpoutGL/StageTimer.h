@@ -0,0 +1,145 @@
+/*
+
+				StageTimer.h
+
+		CPU and GPU timing of the stages of a frame
+		
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	Copyright (c) 2026, Lynn Jarvis. All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, 
+	are permitted provided that the following conditions are met:
+
+		1. Redistributions of source code must retain the above copyright notice, 
+		   this list of conditions and the following disclaimer.
+
+		2. Redistributions in binary form must reproduce the above copyright notice, 
+		   this list of conditions and the following disclaimer in the documentation 
+		   and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"	AND ANY 
+	EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+	OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE	ARE DISCLAIMED. 
+	IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+#ifndef __stageTimer__
+#define __stageTimer__
+
+#include <windows.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+// Spout OpenGL extensions including timer queries
+#include "SpoutGLextensions.h"
+
+#define STAGETIMER_RING     4 // Frames of GPU queries in flight
+#define STAGETIMER_SAMPLES  240 // Rolling window of samples
+#define STAGETIMER_BINS     20 // Histogram bins
+#define STAGETIMER_BINWIDTH 0.5 // Histogram bin width msec
+
+// Timing of one stage over the rolling window
+// Times are in milliseconds
+struct stageTiming {
+	std::string name;
+	bool bGPU; // GPU timer queries are used
+	unsigned int cpuSamples;
+	double cpuLast, cpuMean, cpuP50, cpuP95, cpuMax;
+	unsigned int gpuSamples;
+	double gpuLast, gpuMean, gpuP50, gpuP95, gpuMax;
+	unsigned int gpuDropped; // GPU results not ready before the query was re-used
+	// Bins of STAGETIMER_BINWIDTH. The last bin includes all longer times.
+	unsigned int cpuHistogram[STAGETIMER_BINS];
+	unsigned int gpuHistogram[STAGETIMER_BINS];
+};
+
+class stageTimer {
+
+	public:
+
+		stageTimer();
+		~stageTimer();
+
+		// Add a stage to be timed and return its index.
+		// bGPU - also time the OpenGL commands of the stage.
+		// A stage with no OpenGL commands, or outside
+		// an OpenGL context, should be CPU only.
+		int AddStage(const char* name, bool bGPU = true);
+
+		// Start and end timing a stage
+		void Begin(int stage);
+		void End(int stage);
+
+		// Add a CPU time measured elsewhere
+		void AddTime(int stage, double msec);
+
+		// Collect GPU results that are ready, without waiting.
+		// Call once each frame.
+		void Update();
+
+		// Timing of a stage over the rolling window
+		bool GetStage(int stage, stageTiming &timing);
+
+		// Last time of a stage (msec), 0 if none
+		double GetLast(int stage, bool bGPU = false);
+
+		// Number of stages
+		int GetStageCount();
+
+		// Name of a stage
+		const char* GetName(int stage);
+
+		// Sum of the mean time of all stages
+		double GetFrameTime(bool bGPU = false);
+
+		// Stage times as text for display
+		std::string GetText();
+
+		// Write stage times and histograms to a CSV file
+		bool WriteCSV(const char* path);
+
+		// Clear all samples
+		void Reset();
+
+		// Delete timer queries.
+		// Required before the OpenGL context is closed or changed.
+		void Release();
+
+	protected :
+
+		struct timerStage {
+			std::string name;
+			bool bGPU;
+			std::chrono::steady_clock::time_point start;
+			// Timestamp query pairs for each frame in flight
+			GLuint queries[STAGETIMER_RING][2];
+			bool bPending[STAGETIMER_RING];
+			int slot;
+			// Rolling samples
+			double cpu[STAGETIMER_SAMPLES];
+			double gpu[STAGETIMER_SAMPLES];
+			unsigned int cpuCount, cpuPos;
+			unsigned int gpuCount, gpuPos;
+			unsigned int gpuDropped;
+		};
+
+		std::vector<timerStage> m_stages;
+		bool m_bQueries = false; // Timer queries are available
+
+		void CollectQuery(timerStage &stage, int slot);
+		void Summarize(const double* samples, unsigned int count,
+			double &mean, double &p50, double &p95, double &max,
+			unsigned int* histogram);
+
+};
+
+#endif
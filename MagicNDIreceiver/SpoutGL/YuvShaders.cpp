@@ -2,6 +2,7 @@
 				YuvShaders.cpp
 
 		Functions to manage RGBA <> UYVY compute shaders
+		and planar YUV > RGBA compute shaders
 
 	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -29,6 +30,11 @@
 	========================
 
 	25.11.25 - first version
+	18.10.26 - Add NV12toRgba, I420toRgba, P216toRgba and UYVAtoRgba
+			   for planar formats
+			   Add PlanarShader for multiple source plane textures
+			   CheckShaderFormat - option to change the first format name only
+			 - Add YUVtoRgbaRegion to convert part of a texture
 
 */
 
@@ -50,6 +56,10 @@ yuvShaders::~yuvShaders() {
 	if (m_yuvProgram      > 0) glDeleteProgram(m_yuvProgram);
 	if (m_rgbaProgram     > 0) glDeleteProgram(m_rgbaProgram);
 	if (m_swapProgram     > 0) glDeleteProgram(m_swapProgram);
+	if (m_nv12Program     > 0) glDeleteProgram(m_nv12Program);
+	if (m_i420Program     > 0) glDeleteProgram(m_i420Program);
+	if (m_p216Program     > 0) glDeleteProgram(m_p216Program);
+	if (m_uyvaProgram     > 0) glDeleteProgram(m_uyvaProgram);
 
 }
 
@@ -71,7 +81,19 @@ bool yuvShaders::YUVtoRgba(GLuint SourceID, GLuint DestID,
 	unsigned int width, unsigned int height, bool BT601)
 {
 	return ComputeShader(m_rgbastr, m_rgbaProgram, SourceID, DestID,
-		width, height, (float)BT601);
+		width, height, (float)BT601, 0.0f, 0.0f);
+}
+
+//---------------------------------------------------------
+// Function: YUVtoRgbaRegion
+//    Convert only the region x, y, width, height of the dest
+//    e.g. for the changed tiles of a frame
+bool yuvShaders::YUVtoRgbaRegion(GLuint SourceID, GLuint DestID,
+	unsigned int x, unsigned int y,
+	unsigned int width, unsigned int height, bool BT601)
+{
+	return ComputeShader(m_rgbastr, m_rgbaProgram, SourceID, DestID,
+		width, height, (float)BT601, (float)(x & ~1u), (float)y);
 }
 
 //---------------------------------------------------------
@@ -83,6 +105,54 @@ bool yuvShaders::Swap(GLuint SourceID, unsigned int width, unsigned int height)
 	return ComputeShader(m_swapstr, m_swapProgram, SourceID, 0, width, height);
 }
 
+//---------------------------------------------------------
+// Function: NV12toRgba
+// Semi-planar 4:2:0
+bool yuvShaders::NV12toRgba(GLuint YplaneID, GLuint UVplaneID, GLuint DestID,
+	unsigned int width, unsigned int height, bool BT601)
+{
+	const GLuint planes[3] = { YplaneID, UVplaneID, 0 };
+	const GLenum formats[3] = { GL_R8, GL_RG8, 0 };
+	return PlanarShader(m_nv12str, m_nv12Program, planes, formats, DestID,
+		width, height, (float)BT601);
+}
+
+//---------------------------------------------------------
+// Function: I420toRgba
+// Planar 4:2:0
+bool yuvShaders::I420toRgba(GLuint YplaneID, GLuint UplaneID, GLuint VplaneID, GLuint DestID,
+	unsigned int width, unsigned int height, bool BT601)
+{
+	const GLuint planes[3] = { YplaneID, UplaneID, VplaneID };
+	const GLenum formats[3] = { GL_R8, GL_R8, GL_R8 };
+	return PlanarShader(m_i420str, m_i420Program, planes, formats, DestID,
+		width, height, (float)BT601);
+}
+
+//---------------------------------------------------------
+// Function: P216toRgba
+// Semi-planar 16 bit 4:2:2 with optional alpha plane
+bool yuvShaders::P216toRgba(GLuint YplaneID, GLuint UVplaneID, GLuint AplaneID, GLuint DestID,
+	unsigned int width, unsigned int height, bool BT601)
+{
+	const GLuint planes[3] = { YplaneID, UVplaneID, AplaneID };
+	const GLenum formats[3] = { GL_R16, GL_RG16, GL_R16 };
+	return PlanarShader(m_p216str, m_p216Program, planes, formats, DestID,
+		width, height, (float)BT601, AplaneID > 0 ? 1.0f : 0.0f);
+}
+
+//---------------------------------------------------------
+// Function: UYVAtoRgba
+// Packed 4:2:2 with alpha plane
+bool yuvShaders::UYVAtoRgba(GLuint UYVYplaneID, GLuint AplaneID, GLuint DestID,
+	unsigned int width, unsigned int height, bool BT601)
+{
+	const GLuint planes[3] = { UYVYplaneID, AplaneID, 0 };
+	const GLenum formats[3] = { GL_RGBA8, GL_R8, 0 };
+	return PlanarShader(m_uyvastr, m_uyvaProgram, planes, formats, DestID,
+		width, height, (float)BT601);
+}
+
 
 //---------------------------------------------------------
 // Function: SetGLformat
@@ -121,9 +191,17 @@ void yuvShaders::SetGLformat(GLint glformat)
 		if (m_yuvProgram      > 0) glDeleteProgram(m_yuvProgram);
 		if (m_rgbaProgram     > 0) glDeleteProgram(m_rgbaProgram);
 		if (m_swapProgram     > 0) glDeleteProgram(m_swapProgram);
+		if (m_nv12Program     > 0) glDeleteProgram(m_nv12Program);
+		if (m_i420Program     > 0) glDeleteProgram(m_i420Program);
+		if (m_p216Program     > 0) glDeleteProgram(m_p216Program);
+		if (m_uyvaProgram     > 0) glDeleteProgram(m_uyvaProgram);
 		m_yuvProgram      = 0;
 		m_rgbaProgram     = 0;
 		m_swapProgram     = 0;
+		m_nv12Program     = 0;
+		m_i420Program     = 0;
+		m_p216Program     = 0;
+		m_uyvaProgram     = 0;
 
 		// No notice for GL_RGBA -> GL_RGBA8
 		if (glformat != GL_RGBA) {
@@ -138,7 +216,8 @@ void yuvShaders::SetGLformat(GLint glformat)
 //---------------------------------------------------------
 // Function: CheckShaderFormat
 // Check shader source for correct format description
-void yuvShaders::CheckShaderFormat(std::string &shaderstr)
+// bFirst - change only the first format name (the output image)
+void yuvShaders::CheckShaderFormat(std::string &shaderstr, bool bFirst)
 {
 	// Find existing format name "layout(rgba8, etc
 	size_t pos1 = shaderstr.find("(");
@@ -156,6 +235,8 @@ void yuvShaders::CheckShaderFormat(std::string &shaderstr)
 				break;
 			}
 			shaderstr.replace(pos, formatname.length(), m_GLformatName);
+			if (bFirst)
+				break;
 		}
 	}
 }
@@ -223,6 +304,71 @@ bool yuvShaders::ComputeShader(std::string &shaderstr, GLuint &program,
 
 }
 
+//---------------------------------------------------------
+// Function: PlanarShader
+//    Apply compute shader on planar source textures to RGBA dest.
+//    The dest is bound to image unit 0 and planes to units 1-3.
+//    A plane of zero is not bound.
+bool yuvShaders::PlanarShader(std::string &shaderstr, GLuint &program,
+	const GLuint planes[3], const GLenum formats[3], GLuint DestID,
+	unsigned int width, unsigned int height,
+	float uniform0, float uniform1)
+{
+	if (shaderstr.empty() || planes[0] == 0 || DestID == 0) {
+		printf("yuvShaders::PlanarShader - no shader or texture\n");
+		return false;
+	}
+
+	// Opengl context is necessary
+	if(!wglGetCurrentContext()) {
+		printf("yuvShaders::PlanarShader - no OpenGL context\n");
+		return false;
+	}
+
+	// One invocation for each output pixel
+	const GLuint local_size_x = 16;
+	const GLuint local_size_y = 16;
+	GLuint nWgX = (width  + local_size_x - 1) / local_size_x;
+	GLuint nWgY = (height + local_size_y - 1) / local_size_y;
+
+	if (program == 0) {
+
+		// Check shader source for correct output format name
+		// Source plane formats are fixed
+		CheckShaderFormat(shaderstr, true);
+
+		program = CreateComputeShader(shaderstr, local_size_x, local_size_y);
+
+		if (program == 0) {
+			printf("yuvShaders::PlanarShader - CreateComputeShader failed\n");
+			return false;
+		}
+	}
+
+	glUseProgram(program);
+	glBindImageTexture(0, DestID, 0, GL_FALSE, 0, GL_WRITE_ONLY, m_GLformat);
+	for (GLuint i = 0; i < 3; i++) {
+		if (planes[i] > 0)
+			glBindImageTexture(i+1, planes[i], 0, GL_FALSE, 0, GL_READ_ONLY, formats[i]);
+	}
+
+	if (uniform0 != -1.0) glUniform1f(0, uniform0);
+	if (uniform1 != -1.0) glUniform1f(1, uniform1);
+
+	glDispatchCompute(nWgX, nWgY, 1);
+
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, m_GLformat);
+	for (GLuint i = 0; i < 3; i++) {
+		if (planes[i] > 0)
+			glBindImageTexture(i+1, 0, 0, GL_FALSE, 0, GL_READ_ONLY, formats[i]);
+	}
+	glUseProgram(0);
+
+	return true;
+
+}
+
 //---------------------------------------------------------
 // Function: CreateComputeShader
 // Create compute shader from a source string
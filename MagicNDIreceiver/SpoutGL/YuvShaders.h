@@ -3,6 +3,7 @@
 				YuvShaders.h
 
 		Functions to manage RGBA <> UYVY compute shaders
+		and planar YUV > RGBA compute shaders
 		
 	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -56,17 +57,49 @@ class yuvShaders {
 		bool yuvShaders::YUVtoRgba(GLuint SourceID, GLuint DestID,
 			unsigned int width, unsigned int height, bool BT601);
 
+		// YUV to RGBA for a region of the RGBA dest
+		// x must be even
+		bool yuvShaders::YUVtoRgbaRegion(GLuint SourceID, GLuint DestID,
+			unsigned int x, unsigned int y,
+			unsigned int width, unsigned int height, bool BT601);
+
 		// Swap RGBA<>BGRA
 		bool yuvShaders::Swap(GLuint SourceID, unsigned int width, unsigned int height);
 
+		// NV12 to RGBA
+		// Y plane GL_R8, interleaved UV plane GL_RG8 at half width and height
+		bool yuvShaders::NV12toRgba(GLuint YplaneID, GLuint UVplaneID, GLuint DestID,
+			unsigned int width, unsigned int height, bool BT601);
+
+		// I420 to RGBA
+		// Y plane GL_R8, U and V planes GL_R8 at half width and height
+		// For YV12, exchange the U and V planes
+		bool yuvShaders::I420toRgba(GLuint YplaneID, GLuint UplaneID, GLuint VplaneID, GLuint DestID,
+			unsigned int width, unsigned int height, bool BT601);
+
+		// P216 and PA16 to RGBA
+		// Y plane GL_R16, interleaved UV plane GL_RG16 at half width
+		// Alpha plane GL_R16 for PA16 or zero for P216
+		bool yuvShaders::P216toRgba(GLuint YplaneID, GLuint UVplaneID, GLuint AplaneID, GLuint DestID,
+			unsigned int width, unsigned int height, bool BT601);
+
+		// UYVA to RGBA
+		// UYVY plane GL_RGBA8 at half width, alpha plane GL_R8
+		bool yuvShaders::UYVAtoRgba(GLuint UYVYplaneID, GLuint AplaneID, GLuint DestID,
+			unsigned int width, unsigned int height, bool BT601);
+
 		// Shader format
 		void SetGLformat(GLint glformat);
-		void CheckShaderFormat(std::string &shaderstr);
+		void CheckShaderFormat(std::string &shaderstr, bool bFirst = false);
 
 		// Globals
 		GLuint m_yuvProgram     = 0;
 		GLuint m_rgbaProgram    = 0;
 		GLuint m_swapProgram    = 0;
+		GLuint m_nv12Program    = 0;
+		GLuint m_i420Program    = 0;
+		GLuint m_p216Program    = 0;
+		GLuint m_uyvaProgram    = 0;
 
 	protected :
 
@@ -76,6 +109,13 @@ class yuvShaders {
 			float uniform0 = -1.0, float uniform1 = -1.0,
 			float uniform2 = -1.0, float uniform3 = -1.0);
 
+		// Planar source to RGBA dest
+		// Up to three source planes with their image formats
+		bool PlanarShader(std::string &shader, GLuint &program,
+			const GLuint planes[3], const GLenum formats[3], GLuint DestID,
+			unsigned int width, unsigned int height,
+			float uniform0 = -1.0, float uniform1 = -1.0);
+
 		GLuint CreateComputeShader(std::string shader, unsigned int nWgX, unsigned int nWgY);
 
 		GLint m_GLformat = GL_RGBA8;
@@ -157,9 +197,12 @@ class yuvShaders {
 		"layout(rgba8, binding=0) uniform readonly image2D src;\n"
 		"layout(rgba8, binding=1) uniform writeonly image2D dst;\n"
 		"layout (location = 0) uniform float BT601;\n"
+		"layout (location = 1) uniform float offsetX;\n"
+		"layout (location = 2) uniform float offsetY;\n"
 		"void main() {\n"
 
-		    "ivec2 pos = ivec2(gl_GlobalInvocationID.xy);\n"
+		    // Offset of the region converted in RGBA pixels
+		    "ivec2 pos = ivec2(gl_GlobalInvocationID.xy) + ivec2(offsetX, offsetY);\n"
 
 		    // Only process even X (each invocation outputs 2 RGBA pixels)
 		    "if ((pos.x % 2) != 0) return;\n"
@@ -225,6 +268,108 @@ class yuvShaders {
 
 		"}\n";
 
+		//
+		// Planar YUV > RGB
+		//
+		// Common to the planar shaders. The destination is declared first
+		// so that CheckShaderFormat changes only the output format name.
+		// "range" is 255 for 8 bit or 65535 for 16 bit data. Video range
+		// scales with bit depth, so 16/255 becomes 4096/65535.
+		//
+		std::string m_planarstr =
+		"vec3 yuv2rgb(float Y, float U, float V, float BT601, float range) {\n"
+			"float k = (range + 1.0)/256.0/range;\n"
+			// Convert from video range to full range
+			"Y = clamp((Y - 16.0*k) / (219.0*k), 0.0, 1.0);\n"
+			"U = clamp((U - 16.0*k) / (224.0*k), 0.0, 1.0) - 0.5;\n"
+			"V = clamp((V - 16.0*k) / (224.0*k), 0.0, 1.0) - 0.5;\n"
+			"vec3 rgb;\n"
+			"if(BT601 == 1.0) {\n"
+			"    rgb.r = Y + 1.402   * V;\n"
+			"    rgb.g = Y - 0.34414 * U - 0.71414 * V;\n"
+			"    rgb.b = Y + 1.772   * U;\n"
+			"}\n"
+			"else {\n"
+			"    rgb.r = Y + 1.5748 * V;\n"
+			"    rgb.g = Y - 0.1873 * U - 0.4681 * V;\n"
+			"    rgb.b = Y + 1.8556 * U;\n"
+			"}\n"
+			"return clamp(rgb, 0.0, 1.0);\n"
+		"}\n";
+
+		//
+		// NV12 > RGBA
+		//
+		std::string m_nv12str =
+		"layout(rgba8, binding=0) uniform writeonly image2D dst;\n"
+		"layout(r8, binding=1) uniform readonly image2D yplane;\n"
+		"layout(rg8, binding=2) uniform readonly image2D uvplane;\n"
+		"layout (location = 0) uniform float BT601;\n"
+		+ m_planarstr +
+		"void main() {\n"
+			"ivec2 pos = ivec2(gl_GlobalInvocationID.xy);\n"
+			"float Y = imageLoad(yplane, pos).r;\n"
+			"vec2 uv = imageLoad(uvplane, pos/2).rg;\n"
+			"imageStore(dst, pos, vec4(yuv2rgb(Y, uv.r, uv.g, BT601, 255.0), 1.0));\n"
+		"}\n";
+
+		//
+		// I420 > RGBA
+		//
+		std::string m_i420str =
+		"layout(rgba8, binding=0) uniform writeonly image2D dst;\n"
+		"layout(r8, binding=1) uniform readonly image2D yplane;\n"
+		"layout(r8, binding=2) uniform readonly image2D uplane;\n"
+		"layout(r8, binding=3) uniform readonly image2D vplane;\n"
+		"layout (location = 0) uniform float BT601;\n"
+		+ m_planarstr +
+		"void main() {\n"
+			"ivec2 pos = ivec2(gl_GlobalInvocationID.xy);\n"
+			"float Y = imageLoad(yplane, pos).r;\n"
+			"float U = imageLoad(uplane, pos/2).r;\n"
+			"float V = imageLoad(vplane, pos/2).r;\n"
+			"imageStore(dst, pos, vec4(yuv2rgb(Y, U, V, BT601, 255.0), 1.0));\n"
+		"}\n";
+
+		//
+		// P216/PA16 > RGBA
+		//
+		std::string m_p216str =
+		"layout(rgba8, binding=0) uniform writeonly image2D dst;\n"
+		"layout(r16, binding=1) uniform readonly image2D yplane;\n"
+		"layout(rg16, binding=2) uniform readonly image2D uvplane;\n"
+		"layout(r16, binding=3) uniform readonly image2D aplane;\n"
+		"layout (location = 0) uniform float BT601;\n"
+		"layout (location = 1) uniform float alpha;\n"
+		+ m_planarstr +
+		"void main() {\n"
+			"ivec2 pos = ivec2(gl_GlobalInvocationID.xy);\n"
+			"float Y = imageLoad(yplane, pos).r;\n"
+			// 4:2:2 - chroma is half width, full height
+			"vec2 uv = imageLoad(uvplane, ivec2(pos.x/2, pos.y)).rg;\n"
+			"float A = 1.0;\n"
+			"if(alpha == 1.0) A = imageLoad(aplane, pos).r;\n"
+			"imageStore(dst, pos, vec4(yuv2rgb(Y, uv.r, uv.g, BT601, 65535.0), A));\n"
+		"}\n";
+
+		//
+		// UYVA > RGBA
+		//
+		std::string m_uyvastr =
+		"layout(rgba8, binding=0) uniform writeonly image2D dst;\n"
+		"layout(rgba8, binding=1) uniform readonly image2D uyvyplane;\n"
+		"layout(r8, binding=2) uniform readonly image2D aplane;\n"
+		"layout (location = 0) uniform float BT601;\n"
+		+ m_planarstr +
+		"void main() {\n"
+			"ivec2 pos = ivec2(gl_GlobalInvocationID.xy);\n"
+			// U, Y0, V, Y1 for two pixels
+			"vec4 uyvy = imageLoad(uyvyplane, ivec2(pos.x/2, pos.y));\n"
+			"float Y = (pos.x % 2) == 0 ? uyvy.g : uyvy.a;\n"
+			"float A = imageLoad(aplane, pos).r;\n"
+			"imageStore(dst, pos, vec4(yuv2rgb(Y, uyvy.r, uyvy.b, BT601, 255.0), A));\n"
+		"}\n";
+
 		//
 		// Swap RGBA <> BGRA
 		//
@@ -0,0 +1,165 @@
+/*
+
+	ofxNDIbenchmark
+
+	Throughput and latency of ofxNDIsend to ofxNDIreceive
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+				- Add RunKernels to compare ofxNDIutils kernels
+				  with scalar references and time them
+				- Add HashBuffer to RunKernels
+				- Add DirtyTiles and memequal to RunKernels
+				- SSE2 kernels for all OFXNDI_SIMD systems
+				  Instruction set in the output
+				- Add audio conversion to RunKernels
+				- Add ofxNDIresampler to RunKernels
+				- Add ofxNDIcadence to RunKernels
+				- Add scalar variants and bTimed to ofxNDIkernelResult
+
+*/
+#pragma once
+#ifndef __ofxNDIbenchmark__
+#define __ofxNDIbenchmark__
+
+#include <string>
+#include <vector>
+#include "ofxNDIsend.h"
+#include "ofxNDIreceive.h"
+
+//
+// Each case runs one or more streams, each with a sender thread and
+// a receiver thread. No GPU is used. Set the environment variable
+// OFXNDI_MOCK=1 to use the loopback mock runtime (ofxNDImock.h),
+// built if OFXNDI_USE_MOCK is defined,
+// so that no network is needed.
+//
+// Latency is the time from the sender's frame timestamp to capture.
+// Sender CPU time is measured for the sending threads and receive time
+// for the ReceiveImage calls that returned a frame.
+// Memory allocations are counted if OFXNDI_BENCHMARK_ALLOCATIONS
+// is defined for ofxNDIbenchmark.cpp, which replaces global operator new.
+// Otherwise the allocations column is -1.
+//
+// RunKernels compares each ofxNDIutils image and audio function
+// with a scalar reference for sizes including odd widths, pitches
+// that are not a multiple of 16 and unaligned buffers, then times it.
+// Results are included in the JSON file.
+//
+// The console program ofxNDIbenchmark (MagicNDIreceiver\ofxNDIbenchmark,
+// in the MagicNDIreceiver solution) runs the kernels and the default
+// cases with allocation counting and the mock runtime built in :
+//
+//    set OFXNDI_MOCK=1
+//    ofxNDIbenchmark [-kernels] [-frames N] [-fps N] [file.json]
+//
+
+struct ofxNDIbenchmarkCase {
+	unsigned int width = 1920;
+	unsigned int height = 1080;
+	NDIlib_FourCC_video_type_e format = NDIlib_FourCC_video_type_RGBA;
+	bool bClocked = false; // Clocked at the frame rate, otherwise async
+	int streams = 1;
+};
+
+struct ofxNDIbenchmarkResult {
+	ofxNDIbenchmarkCase test;
+	int64_t sent = 0; // Frames sent by all streams
+	int64_t received = 0; // Frames received by all streams
+	int64_t dropped = 0; // Sent but not received
+	double seconds = 0.0; // Wall time of the case
+	double fps = 0.0; // Received frames per second of each stream
+	double latencyP50 = 0.0; // msec
+	double latencyP99 = 0.0;
+	double latencyP999 = 0.0;
+	double latencyMax = 0.0;
+	double sendCpu = 0.0; // Sender CPU msec per frame
+	double receiveTime = 0.0; // Receive msec per frame
+	double allocations = -1.0; // Per frame sent, -1 if not counted
+};
+
+struct ofxNDIkernelResult {
+	std::string kernel; // ofxNDIutils function
+	std::string variant; // "scalar", "sse2", "movsd" or "dispatch" for a function that selects one
+	int cases = 0; // Sizes, pitches and alignments compared
+	int failed = 0; // Cases different to the scalar reference
+	double gbps = 0.0; // GB read and written per second at 1920x1080
+	double cycles = -1.0; // Per pixel or audio sample, -1 if no cycle counter
+	bool bTimed = false; // GB/s and cycles measured
+};
+
+class ofxNDIbenchmark {
+
+public:
+
+	ofxNDIbenchmark();
+	~ofxNDIbenchmark();
+
+	// Frames sent by each stream for each case
+	// Initialized 300
+	void SetFrames(int frames);
+
+	// Frame rate of clocked senders
+	// Initialized 60
+	void SetFrameRate(int fps);
+
+	// Add a case to run
+	void AddCase(unsigned int width, unsigned int height,
+		NDIlib_FourCC_video_type_e format, bool bClocked, int streams);
+
+	// Add 720p, 1080p, 1440p and 4K cases in RGBA, BGRA, UYVY and NV12
+	// both clocked and async with one stream, and 1 to 32 streams
+	// for 1080p RGBA async
+	void AddDefaultCases();
+
+	// Run all cases and print the results
+	bool Run();
+
+	// Run one case
+	ofxNDIbenchmarkResult RunCase(const ofxNDIbenchmarkCase &test);
+
+	// Results of the cases run
+	std::vector<ofxNDIbenchmarkResult> GetResults();
+
+	// Compare ofxNDIutils kernels with scalar references and time them
+	// Returns false if any kernel is different to the reference
+	bool RunKernels();
+
+	// Results of RunKernels
+	std::vector<ofxNDIkernelResult> GetKernelResults();
+
+	// Write results as JSON
+	bool WriteJSON(const char* path);
+
+private:
+
+	int m_frames;
+	int m_fps;
+	std::vector<ofxNDIbenchmarkCase> m_cases;
+	std::vector<ofxNDIbenchmarkResult> m_results;
+	std::vector<ofxNDIkernelResult> m_kernels;
+	std::string m_runtime; // NDI runtime version
+
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*
+
+	ofxNDIcadence
+
+	Audio samples for each video frame at an exact rational rate
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+
+*/
+#include "ofxNDIcadence.h"
+#include <stdio.h>
+
+// Greatest common divisor
+static int64_t CadenceGcd(int64_t a, int64_t b)
+{
+	while (b != 0) {
+		const int64_t t = a%b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+ofxNDIcadence::ofxNDIcadence()
+{
+	m_samplerate = 0;
+	m_N = 0;
+	m_D = 1;
+	m_whole = 0;
+	m_remainder = 0;
+	m_divisor = 1;
+	m_error = 0;
+	m_frames = 0;
+	m_samples = 0;
+}
+
+ofxNDIcadence::~ofxNDIcadence()
+{
+
+}
+
+// Audio sample rate and video frame rate of N/D frames per second
+bool ofxNDIcadence::Set(int samplerate, int framerate_N, int framerate_D)
+{
+	if (samplerate <= 0 || framerate_N <= 0 || framerate_D <= 0) {
+		printf("ofxNDIcadence::Set - invalid %d Hz at %d/%d fps\n", samplerate, framerate_N, framerate_D);
+		return false;
+	}
+
+	m_samplerate = samplerate;
+	m_N = framerate_N;
+	m_D = framerate_D;
+
+	// samplerate x D / N as a whole number and a fraction
+	// reduced so that the cadence period is as short as possible
+	const int64_t numerator = (int64_t)samplerate*(int64_t)framerate_D;
+	m_whole = numerator/framerate_N;
+	m_remainder = numerator%framerate_N;
+	m_divisor = framerate_N;
+	if (m_remainder > 0) {
+		const int64_t gcd = CadenceGcd(m_remainder, m_divisor);
+		m_remainder /= gcd;
+		m_divisor /= gcd;
+	}
+	else {
+		m_divisor = 1;
+	}
+
+	Reset();
+
+	return true;
+}
+
+// Start again from the first frame
+void ofxNDIcadence::Reset()
+{
+	m_error = 0;
+	m_frames = 0;
+	m_samples = 0;
+}
+
+// Samples of the next frame
+int ofxNDIcadence::Next()
+{
+	int64_t samples = m_whole;
+	m_error += m_remainder;
+	if (m_error >= m_divisor) {
+		m_error -= m_divisor;
+		samples++;
+	}
+	m_frames++;
+	m_samples += samples;
+	return (int)samples;
+}
+
+// Samples of the next frame without moving to it
+int ofxNDIcadence::Peek()
+{
+	return (int)(m_whole + ((m_error + m_remainder >= m_divisor) ? 1 : 0));
+}
+
+// Least samples of any frame
+int ofxNDIcadence::GetMinSamples()
+{
+	return (int)m_whole;
+}
+
+// Most samples of any frame
+int ofxNDIcadence::GetMaxSamples()
+{
+	return (int)(m_whole + ((m_remainder > 0) ? 1 : 0));
+}
+
+// Frames before the cadence repeats
+int64_t ofxNDIcadence::GetPeriod()
+{
+	return m_divisor;
+}
+
+// Frames returned by Next
+int64_t ofxNDIcadence::GetFrames()
+{
+	return m_frames;
+}
+
+// Samples of all frames returned by Next
+int64_t ofxNDIcadence::GetSamples()
+{
+	return m_samples;
+}
+
+// Time of the first sample of the next frame (100 nsec)
+int64_t ofxNDIcadence::GetTimecode()
+{
+	if (m_samplerate <= 0)
+		return 0;
+	// Whole seconds and the rest separately
+	// so that the product does not overflow
+	const int64_t seconds = m_samples/m_samplerate;
+	const int64_t rest = m_samples%m_samplerate;
+	return seconds*10000000 + rest*10000000/m_samplerate;
+}
+
+// Time of the start of the next video frame (100 nsec)
+int64_t ofxNDIcadence::GetFrameTimecode()
+{
+	if (m_N <= 0)
+		return 0;
+	// Frame k is at k x D / N seconds
+	const int64_t units = m_frames*(int64_t)m_D;
+	const int64_t seconds = units/m_N;
+	const int64_t rest = units%m_N;
+	return seconds*10000000 + rest*10000000/m_N;
+}
+
+// Sample rate
+int ofxNDIcadence::GetSampleRate()
+{
+	return m_samplerate;
+}
@@ -0,0 +1,124 @@
+/*
+
+	ofxNDIcadence
+
+	Audio samples for each video frame at an exact rational rate
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+
+*/
+#pragma once
+#ifndef __ofxNDIcadence__
+#define __ofxNDIcadence__
+
+#include <stdint.h>
+
+//
+// Audio samples per video frame are samplerate x D / N
+// for a frame rate of N/D frames per second. This is not a whole
+// number for rates such as 29.97 (30000/1001), where 48 kHz audio
+// is 1601.6 samples per frame.
+//
+// Each frame has the whole part, and one more sample when the
+// remainder accumulated from previous frames reaches a whole sample,
+// as for drawing a line with Bresenham's algorithm. The samples
+// of the first k frames are then always exactly
+// floor(k x samplerate x D / N), so that audio never drifts
+// from the video however long it runs. Integer arithmetic only,
+// and no allocation.
+//
+// Typical values
+// Audio Rate | Video fps   | Samples/frame | Cadence                  | Period |
+// ---------- | ----------- | ------------- | ------------------------ | ------ |
+// 48000      | 30000/1001  | 1601.6        | 1601,1602,1601,1602,1602 |   5    |
+// 48000      | 60000/1001  | 800.8         | 800,801,801,801,801      |   5    |
+// 44100      | 30000/1001  | 1471.47       | 1471,1471,1472,...       |  100   |
+//
+// Example :
+//
+//    ofxNDIcadence cadence;
+//    cadence.Set(48000, 30000, 1001);
+//    int samples = cadence.Next(); // for each video frame
+//
+
+class ofxNDIcadence {
+
+public:
+
+	ofxNDIcadence();
+	~ofxNDIcadence();
+
+	// Audio sample rate and video frame rate of N/D frames per second
+	// Starts again from the first frame
+	bool Set(int samplerate, int framerate_N, int framerate_D = 1000);
+
+	// Start again from the first frame
+	void Reset();
+
+	// Samples of the next frame
+	int Next();
+
+	// Samples of the next frame without moving to it
+	int Peek();
+
+	// Least and most samples of any frame
+	int GetMinSamples();
+	int GetMaxSamples();
+
+	// Frames before the cadence repeats
+	int64_t GetPeriod();
+
+	// Frames returned by Next
+	int64_t GetFrames();
+
+	// Samples of all frames returned by Next
+	int64_t GetSamples();
+
+	// Time of the first sample of the next frame from the start
+	// in 100 nsec units, for NDI timecodes
+	int64_t GetTimecode();
+
+	// Time of the start of the next video frame from the start
+	// in 100 nsec units. The first sample of the frame is less
+	// than one sample before this.
+	int64_t GetFrameTimecode();
+
+	// Sample rate
+	int GetSampleRate();
+
+private:
+
+	int m_samplerate;
+	int m_N;
+	int m_D;
+	int64_t m_whole; // Whole samples per frame
+	int64_t m_remainder; // Remainder of samplerate x D / N
+	int64_t m_divisor; // N reduced with the remainder
+	int64_t m_error; // Accumulated remainder
+	int64_t m_frames;
+	int64_t m_samples;
+
+};
+
+#endif
@@ -28,7 +28,13 @@ typedef NDIlib_v5* (*NDIlib_v5_load_)(void);
 #include <string>
 #include <vector>
 #include <iostream> // for cout
+#include <mutex>
 
+//
+// The NDI library is loaded and initialized once for the process.
+// Each loader that has loaded it holds a reference and the last
+// loader to be destroyed de-initializes NDI and unloads the library.
+//
 class ofxNDIdynloader
 {
 	
@@ -38,20 +44,32 @@ public:
     ~ofxNDIdynloader();
 
     // load library dynamically
+	// or return the library already loaded in the process
     const NDIlib_v5* Load();
 
 private :
 
+	// Load and initialize the library for the process
+	const NDIlib_v5* LoadRuntime();
+#if defined(OFXNDI_USE_MOCK)
+	const NDIlib_v5* LoadMock();
+#endif
+
 #if defined(TARGET_WIN32)
 	bool FindWinRuntime(std::string& runtime);
 	bool ReadPathFromRegistry(HKEY hKey, const char* subkey, const char* valuename, char* filepath, DWORD dwSize = MAX_PATH);
-	HMODULE m_hNDILib;
+	static HMODULE m_hNDILib;
 #elif defined(TARGET_OSX) || defined(TARGET_LINUX)
 	const std::string FindRuntime();
 	const std::string GetCurrentExePath();
-	void* m_hNDILib;
+	static void* m_hNDILib;
 #endif
-	const NDIlib_v5* p_NDILib;
+	const NDIlib_v5* p_NDILib; // Set while this loader holds a reference
+
+	// Shared by all loaders
+	static std::mutex m_loaderMutex;
+	static const NDIlib_v5* m_pLibrary;
+	static int m_nReferences;
 
 };
 
@@ -0,0 +1,78 @@
+/*
+
+	ofxNDImock
+
+	Loopback stand-in for the NDI runtime
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+
+*/
+#pragma once
+#ifndef __ofxNDImock__
+#define __ofxNDImock__
+
+#include <cstddef> // to avoid NULL definition problem
+#include "Processing.NDI.Lib.h" // NDI SDK
+
+//
+// The mock runtime implements the NDIlib_v5 function table used by
+// ofxNDIsend and ofxNDIreceive without the NDI runtime or a network.
+//
+// Senders and receivers created within the same process are connected
+// by name. Video, audio and metadata frames are copied once by the sender
+// and the same frame memory is shared by every connected receiver.
+// Each receiver gets a frame after a configurable latency and jitter
+// and frames can be lost at random to test receiving behaviour.
+//
+// ofxNDIdynloader::Load returns the mock runtime if the build
+// defines OFXNDI_USE_MOCK (Debug configurations) and the
+// environment variable OFXNDI_MOCK is set and not "0".
+// Release configurations do not compile the mock.
+// Network conditions can be set by environment variables
+//   OFXNDI_MOCK_LATENCY - delivery delay in milliseconds
+//   OFXNDI_MOCK_JITTER  - maximum random additional delay in milliseconds
+//   OFXNDI_MOCK_LOSS    - fraction of frames lost (0 - 1)
+//   OFXNDI_MOCK_SEED    - random number seed for repeatable tests
+// or by SetNetwork.
+//
+// Formats are not converted. Receivers get frames in the format sent.
+//
+namespace ofxNDImock {
+
+	// Return whether the mock runtime is selected by OFXNDI_MOCK
+	bool IsSelected();
+
+	// Return the mock function table
+	const NDIlib_v5* Load();
+
+	// Set network conditions for frames sent from now on
+	// - latency | delivery delay (msec)
+	// - jitter | maximum random additional delay (msec)
+	// - loss | fraction of frames lost (0 - 1)
+	// - seed | random number seed
+	void SetNetwork(double latency, double jitter = 0.0, double loss = 0.0, unsigned int seed = 1);
+
+}
+
+#endif
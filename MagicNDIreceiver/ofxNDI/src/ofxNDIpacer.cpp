@@ -0,0 +1,228 @@
+/*
+
+	ofxNDIpacer
+
+	Frame rate control with absolute deadlines
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+
+*/
+#include "ofxNDIpacer.h"
+#include "ofxNDIutils.h" // for tracing and Windows timer functions
+#include <stdio.h>
+#include <math.h>
+#include <thread>
+
+ofxNDIpacer::ofxNDIpacer()
+{
+	m_N = 60000; // 60 fps
+	m_D = 1000;
+	m_bStarted = false;
+	m_frame = 0;
+#if defined(TARGET_WIN32)
+	m_spin = std::chrono::microseconds(2000);
+#else
+	m_spin = std::chrono::microseconds(500);
+#endif
+	m_spinMax = std::chrono::microseconds(4000);
+	m_bAdaptive = true;
+	m_period = 0;
+	ResetStats();
+
+	// Reduce the Windows timer period once for the life of the pacer
+#if defined(TARGET_WIN32)
+	TIMECAPS tc={};
+	if (timeGetDevCaps(&tc, sizeof(TIMECAPS)) == MMSYSERR_NOERROR) {
+		if (timeBeginPeriod(tc.wPeriodMin) == TIMERR_NOERROR)
+			m_period = tc.wPeriodMin;
+	}
+#endif
+}
+
+ofxNDIpacer::~ofxNDIpacer()
+{
+#if defined(TARGET_WIN32)
+	if (m_period > 0)
+		timeEndPeriod(m_period);
+#endif
+}
+
+// Frame clock of N/D frames per second
+void ofxNDIpacer::SetRate(int framerate_N, int framerate_D)
+{
+	if (framerate_N <= 0 || framerate_D <= 0) {
+		printf("ofxNDIpacer::SetRate - invalid frame rate %d/%d\n", framerate_N, framerate_D);
+		return;
+	}
+	m_N = framerate_N;
+	m_D = framerate_D;
+	m_bStarted = false;
+}
+
+int ofxNDIpacer::GetRateN()
+{
+	return m_N;
+}
+
+int ofxNDIpacer::GetRateD()
+{
+	return m_D;
+}
+
+// Spin window before each deadline
+void ofxNDIpacer::SetSpin(double usec, bool bAdaptive)
+{
+	if (usec < 0.0)
+		usec = 0.0;
+	m_spin = std::chrono::nanoseconds((int64_t)(usec*1000.0));
+	if (m_spinMax < m_spin)
+		m_spinMax = m_spin;
+	m_bAdaptive = bAdaptive;
+}
+
+// Start the frame clock again with the next Wait
+void ofxNDIpacer::Start()
+{
+	m_bStarted = false;
+}
+
+// Time of frame number "frame" from the start of the clock.
+// Whole seconds and the remainder are calculated separately
+// so that the time is exact and does not overflow.
+std::chrono::nanoseconds ofxNDIpacer::FrameTime(int64_t frame)
+{
+	const int64_t ticks = frame*(int64_t)m_D; // in units of 1/N sec
+	const int64_t seconds = ticks/m_N;
+	const int64_t remainder = ticks%m_N;
+	return std::chrono::nanoseconds(seconds*1000000000LL + remainder*1000000000LL/m_N);
+}
+
+// Time of the next frame deadline
+std::chrono::steady_clock::time_point ofxNDIpacer::GetDeadline()
+{
+	if (!m_bStarted)
+		return std::chrono::steady_clock::now();
+	return m_start + FrameTime(m_frame + 1);
+}
+
+// Wait for the next frame deadline
+bool ofxNDIpacer::Wait()
+{
+	ofxNDIutils::TraceSpan span("ofxNDIpacer::Wait");
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	// The first frame starts the clock
+	if (!m_bStarted) {
+		m_start = now;
+		m_frame = 0;
+		m_last = now;
+		m_bStarted = true;
+		m_stats.frames++;
+		return true;
+	}
+
+	m_frame++;
+	std::chrono::steady_clock::time_point deadline = m_start + FrameTime(m_frame);
+	bool bOnTime = true;
+
+	if (now >= deadline) {
+		// Late. Start at once, but if more than one frame late
+		// skip to the current frame time rather than catch up.
+		bOnTime = false;
+		m_stats.late++;
+		const std::chrono::nanoseconds period = FrameTime(m_frame + 1) - FrameTime(m_frame);
+		if (now - deadline > period) {
+			const int64_t missed = (int64_t)((now - deadline)/period);
+			m_frame += missed;
+			m_stats.skipped += missed;
+			deadline = m_start + FrameTime(m_frame);
+		}
+	}
+	else {
+		// Sleep until the spin window
+		if (deadline - now > m_spin) {
+			const std::chrono::steady_clock::time_point wake = deadline - m_spin;
+			std::this_thread::sleep_until(wake);
+			now = std::chrono::steady_clock::now();
+			// If sleep wakes later than the window allows, increase it
+			if (m_bAdaptive && now > deadline && m_spin < m_spinMax) {
+				m_spin += std::chrono::microseconds(250);
+				if (m_spin > m_spinMax)
+					m_spin = m_spinMax;
+			}
+		}
+		// Spin to the deadline
+		while (now < deadline) {
+			std::this_thread::yield();
+			now = std::chrono::steady_clock::now();
+		}
+	}
+
+	// Statistics
+	m_stats.frames++;
+	const double error = std::chrono::duration<double, std::micro>(now - deadline).count();
+	if (bOnTime) {
+		m_errorTotal += error;
+		m_errors++;
+		if (error > m_stats.errorMax)
+			m_stats.errorMax = error;
+	}
+	const double period = std::chrono::duration<double, std::micro>(now - m_last).count();
+	m_periodTotal += period;
+	m_periodSquares += period*period;
+	m_periods++;
+	m_last = now;
+
+	return bOnTime;
+}
+
+// Pacing statistics
+ofxNDIpacerStats ofxNDIpacer::GetStats()
+{
+	ofxNDIpacerStats stats = m_stats;
+	if (m_errors > 0)
+		stats.errorMean = m_errorTotal/(double)m_errors;
+	if (m_periods > 0) {
+		const double mean = m_periodTotal/(double)m_periods;
+		const double variance = m_periodSquares/(double)m_periods - mean*mean;
+		stats.jitter = (variance > 0.0) ? sqrt(variance) : 0.0;
+		if (mean > 0.0)
+			stats.fps = 1000000.0/mean;
+	}
+	stats.spin = std::chrono::duration<double, std::micro>(m_spin).count();
+	return stats;
+}
+
+// Clear the pacing statistics
+void ofxNDIpacer::ResetStats()
+{
+	m_stats = ofxNDIpacerStats();
+	m_errorTotal = 0.0;
+	m_errors = 0;
+	m_periodTotal = 0.0;
+	m_periodSquares = 0.0;
+	m_periods = 0;
+	m_last = std::chrono::steady_clock::now();
+}
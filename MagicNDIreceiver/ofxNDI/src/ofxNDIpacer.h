@@ -0,0 +1,137 @@
+/*
+
+	ofxNDIpacer
+
+	Frame rate control with absolute deadlines
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+
+*/
+#pragma once
+#ifndef __ofxNDIpacer__
+#define __ofxNDIpacer__
+
+#include <stdint.h>
+#include <chrono>
+
+//
+// Each frame has a deadline on a frame clock of N/D frames per second,
+// counted from the start, so that errors do not accumulate.
+// For example 60000/1001 for 59.94 fps.
+//
+// Wait sleeps until the spin window before the deadline and then
+// spins to the deadline. Sleep is only accurate to the system timer,
+// so the window is increased if a sleep wakes later than it allows.
+// If a frame is more than one frame late, the missed deadlines are
+// skipped rather than sending frames as fast as possible to catch up.
+//
+// On Windows, the timer period is reduced to the minimum supported
+// (usually 1 msec) once for the lifetime of the pacer.
+//
+// Example :
+//
+//    ofxNDIpacer pacer;
+//    pacer.SetRate(60000, 1001);
+//    while (bRunning) {
+//        // render and send the frame
+//        pacer.Wait();
+//    }
+//
+
+struct ofxNDIpacerStats {
+	int64_t frames = 0; // Wait calls
+	int64_t late = 0; // Frames that started after the deadline
+	int64_t skipped = 0; // Deadlines skipped after a late frame
+	double errorMean = 0.0; // Mean time from the deadline to the return from Wait (usec)
+	double errorMax = 0.0; // Maximum time from the deadline (usec)
+	double jitter = 0.0; // Standard deviation of the frame period (usec)
+	double fps = 0.0; // Measured frame rate
+	double spin = 0.0; // Current spin window (usec)
+};
+
+class ofxNDIpacer {
+
+public:
+
+	ofxNDIpacer();
+	~ofxNDIpacer();
+
+	// Frame clock of N/D frames per second
+	// The clock starts again with the next Wait
+	void SetRate(int framerate_N, int framerate_D = 1000);
+
+	// Frame rate numerator
+	int GetRateN();
+
+	// Frame rate denominator
+	int GetRateD();
+
+	// Spin window before each deadline (usec)
+	// Initialized 2000 for Windows and 500 for other systems
+	// - bAdaptive | increase the window if sleep wakes too late
+	void SetSpin(double usec, bool bAdaptive = true);
+
+	// Start the frame clock again with the next Wait
+	void Start();
+
+	// Wait for the next frame deadline
+	// Returns false if the deadline had already passed
+	bool Wait();
+
+	// Time of the next frame deadline
+	std::chrono::steady_clock::time_point GetDeadline();
+
+	// Pacing statistics
+	ofxNDIpacerStats GetStats();
+
+	// Clear the pacing statistics
+	void ResetStats();
+
+private:
+
+	int m_N;
+	int m_D;
+	bool m_bStarted;
+	std::chrono::steady_clock::time_point m_start; // Start of the frame clock
+	int64_t m_frame; // Frames since the start
+	std::chrono::nanoseconds m_spin; // Spin window
+	std::chrono::nanoseconds m_spinMax;
+	bool m_bAdaptive;
+	unsigned int m_period; // Windows timer period set
+
+	// Statistics
+	ofxNDIpacerStats m_stats;
+	std::chrono::steady_clock::time_point m_last; // Last return from Wait
+	double m_errorTotal;
+	int64_t m_errors;
+	double m_periodTotal;
+	double m_periodSquares;
+	int64_t m_periods;
+
+	// Time of a frame from the start
+	std::chrono::nanoseconds FrameTime(int64_t frame);
+
+};
+
+#endif
@@ -53,6 +53,19 @@
 	19.01.25 - Update to NDI 6.1.1.0
 	21.12.25 - Update to NDI version 6.2.1.0
 	11.02.25 - Remove unused NDI_send_create_desc
+	18.10.26 - Add receiver statistics - ofxNDIreceiveStats, StartStats, StopStats,
+			   GetStats, ResetStats, SetStageTime
+			 - Add standby receivers - AddStandby, RemoveStandby, ClearStandby,
+			   GetStandbyList, IsStandby, SetStandbyBandwidth
+			 - Add failover to backup senders - SetFailover, ClearFailover,
+			   IsFailover, GetFailoverLatency, CheckFailover
+			 - Add repeated frame detection - SetRepeatHash, IsRepeatFrame,
+			   GetRepeatFrames
+			 - Use the ofxNDIutils monotonic clock for timing and fps
+			   Remove Linux LARGE_INTEGER, dwStartTime and dwElapsedTime
+			 - Add lock-free audio FIFO - SetAudioFifo, ReleaseAudioFifo,
+			   ReadAudio, GetAudioFifo
+			 - Add audio resampling - SetAudioResample, GetAudioResampler
 
 */
 #pragma once
@@ -63,9 +76,16 @@
 #include <iostream>
 #include <vector>
 #include <assert.h>
+#include <thread> // for the statistics sampling thread
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 
 #include "ofxNDIdynloader.h" // NDI library loader
 #include "ofxNDIutils.h" // buffer copy utilities
+#include "ofxNDIfifo.h" // audio FIFO
+#include "ofxNDIresampler.h" // audio sample rate conversion
 
 #if defined(TARGET_WIN32)
 #include <windows.h>
@@ -93,12 +113,46 @@
 // Linux
 // https://github.com/hugoaboud/ofxNDI
 #if !defined(TARGET_WIN32)
-typedef struct {
-	long long QuadPart;
-} LARGE_INTEGER;
 typedef unsigned int DWORD;
 #endif
 
+// Receiving pipeline stages for timing statistics
+enum ofxNDIstage {
+	ofxNDI_stage_capture = 0, // NDI frame capture (and CPU copy if any)
+	ofxNDI_stage_upload  = 1, // Texture upload (application)
+	ofxNDI_stage_convert = 2, // Conversion shader (application)
+	ofxNDI_stage_max     = 3
+};
+
+// Number of 1 msec bins for the video frame jitter histogram
+// The last bin counts all deviations greater than that
+#define OFXNDI_JITTER_BINS 16
+
+// Receiver statistics
+struct ofxNDIreceiveStats {
+	// Total and dropped frames from NDI recv_get_performance
+	int64_t videoFrames = 0;
+	int64_t audioFrames = 0;
+	int64_t metadataFrames = 0;
+	int64_t videoDropped = 0;
+	int64_t audioDropped = 0;
+	int64_t metadataDropped = 0;
+	// Frames waiting in the receive queue from NDI recv_get_queue
+	int videoQueue = 0;
+	int audioQueue = 0;
+	int metadataQueue = 0;
+	// Video frame inter-arrival jitter.
+	// Deviation of the video_frame.timestamp interval
+	// from the sender frame period in 1 msec bins.
+	int64_t jitter[OFXNDI_JITTER_BINS] = {};
+	double jitterMean = 0.0; // msec
+	double jitterMax = 0.0; // msec
+	// Rolling average time of each pipeline stage (msec)
+	double stageTime[ofxNDI_stage_max] = {};
+	// Number of samples taken by the sampling thread
+	int64_t samples = 0;
+};
+
 
 class ofxNDIreceive {
 
@@ -250,6 +304,26 @@ public:
 	// Return the current video frame timecode
 	int64_t GetVideoTimecode();
 
+	// Repeated frames
+	// A video frame is a repeat of the last frame received
+	// if it has the same timestamp and timecode.
+	// A frame sent again by the sender has a new timestamp,
+	// so the frame data can also be compared by a hash.
+	// The application can then keep the last texture
+	// instead of uploading the frame again.
+
+	// Also compare a hash of the frame data
+	// - bHash | compare the hash
+	// - rows | rows sampled evenly through the frame, 0 for all
+	//          A change in rows that are not sampled is not detected.
+	void SetRepeatHash(bool bHash, unsigned int rows = 64);
+
+	// Return whether the current video frame is a repeat of the last one
+	bool IsRepeatFrame();
+
+	// Number of repeated video frames received
+	int64_t GetRepeatFrames();
+
 	// Set to receive Audio
 	void SetAudio(bool bAudio);
 
@@ -278,6 +352,43 @@ public:
 	// Free audio frame buffer
 	void FreeAudioData();
 
+	// Receive audio into a lock-free FIFO so that no audio frames are lost
+	// between reads and there is no allocation after this call.
+	// Also sets to receive audio.
+	// - channels | maximum channels
+	// - samples | samples of each channel, e.g. 48000 for 1 second at 48 kHz
+	// Can be called while ReceiveImage runs on another thread,
+	// but not while another thread calls ReadAudio.
+	bool SetAudioFifo(int channels = 16, int samples = 48000);
+
+	// Release the audio FIFO
+	// Can be called while ReceiveImage runs on another thread,
+	// but not while another thread calls ReadAudio.
+	void ReleaseAudioFifo();
+
+	// Read exactly "samples" samples of "channels" channels
+	// from the audio FIFO as planar float.
+	// Samples not available are returned as silence.
+	// If resampling is set, samples are at the resampled rate.
+	// Can be called from a different thread to ReceiveImage.
+	// Returns the samples read.
+	int ReadAudio(float* output, int samples, int channels);
+
+	// Audio FIFO for the sample rate, level and counters
+	ofxNDIfifo& GetAudioFifo();
+
+	// Resample audio read from the FIFO to a fixed rate.
+	// The rate is adjusted for the clock of the sender
+	// to keep the FIFO level at the latency.
+	// - samplerate | output rate, 0 to read the FIFO directly
+	// - quality | 0 to 3 (8, 16, 32 or 64 filter taps)
+	// - latency | FIFO level (msec)
+	// Not while reading. Call after SetAudioFifo.
+	bool SetAudioResample(int samplerate, int quality = 2, double latency = 40.0);
+
+	// Resampler for the ratio and level
+	ofxNDIresampler& GetAudioResampler();
+
 	// The NDI SDK version number
 	std::string GetNDIversion();
 
@@ -287,6 +398,83 @@ public:
 	// Reset starting received frame rate
 	void ResetFps(double fps);
 
+	// Start a thread to sample receiver statistics
+	// - interval | sampling interval in milliseconds
+	void StartStats(unsigned int interval = 1000);
+
+	// Stop the statistics sampling thread
+	void StopStats();
+
+	// Return the current receiver statistics
+	ofxNDIreceiveStats GetStats();
+
+	// Clear the receiver statistics
+	void ResetStats();
+
+	// Record the time taken by a pipeline stage
+	// Capture is timed by ReceiveImage. Stages outside this
+	// class, such as texture upload and conversion, are timed
+	// by the application and recorded here.
+	// - stage | ofxNDI_stage_upload, ofxNDI_stage_convert
+	// - msec | stage time in milliseconds
+	void SetStageTime(ofxNDIstage stage, double msec);
+
+	// Standby receivers
+	// Senders in the standby pool are kept connected at low bandwidth.
+	// When a standby sender is selected, its frames are received
+	// until the new receiver has connected, so that the switch is
+	// almost immediate. The standby receiver is then returned to the pool.
+
+	// Add a sender to the standby pool
+	// - sendername | full NDI sender name
+	// The standby receiver is connected when the sender is found
+	bool AddStandby(std::string sendername);
+
+	// Remove a sender from the standby pool
+	void RemoveStandby(std::string sendername);
+
+	// Remove all senders from the standby pool
+	void ClearStandby();
+
+	// Return the names of senders in the standby pool
+	std::vector<std::string> GetStandbyList();
+
+	// Return whether a sender standby receiver is connected
+	bool IsStandby(std::string sendername);
+
+	// Set standby receiver bandwidth
+	// Initialized NDIlib_recv_bandwidth_lowest
+	void SetStandbyBandwidth(NDIlib_recv_bandwidth_e bandwidth);
+
+	// Failover
+	// If video frames stop arriving from the primary sender, the receiver
+	// switches to the first backup sender that is running. Backup senders
+	// are kept connected with standby receivers so that the switch is
+	// immediate. When the primary sender has been stable for the hold
+	// time, the receiver switches back to it.
+	// - primary | full NDI name of the primary sender
+	// - backups | full NDI names of backup senders in order of preference
+	// - timeout | msec without video frames before switching
+	// - holdtime | msec the primary must be stable before switching back
+	//              0 for no return to the primary sender
+	void SetFailover(std::string primary, std::vector<std::string> backups,
+		double timeout = 500.0, double holdtime = 5000.0);
+
+	// Remove the failover senders
+	void ClearFailover();
+
+	// Return whether receiving from a backup sender
+	bool IsFailover();
+
+	// Return the time between the last switch and the first video frame (msec)
+	double GetFailoverLatency();
+
+	// Switch to a backup sender if the current one has been lost
+	// or back to the primary sender when it is stable.
+	// Called by ReceiveImage. Call it while no receiver is created
+	// so that a primary sender that is not running fails over.
+	void CheckFailover();
+
 	// ====================================================================
 
 private:
@@ -314,13 +502,9 @@ private:
 	bool bReceiverConnected; // Is the receiver connected and receiving frames
 	NDIlib_recv_bandwidth_e m_bandWidth; // Bandwidth receive option
 
-	uint32_t dwStartTime; // For timing delay
-	uint32_t dwElapsedTime;
-
 	// For received frame fps calculations
-	double PCFreq;
-	int64_t CounterStart;
-	double startTime, lastTime;
+	int64_t CounterStart; // GetClockTime nsec
+	double startTime, lastTime; // msec from CounterStart
 	void StartCounter();
 	double GetCounter();
 	double m_fps;
@@ -336,14 +520,86 @@ private:
 	int64_t m_VideoTimecode;
 	int64_t m_VideoTimestamp;
 
+	// Repeated frames
+	bool m_bRepeatFrame; // Current frame is a repeat
+	bool m_bRepeatHash; // Compare sampled hash
+	bool m_bRepeatValid; // There is a last frame to compare
+	unsigned int m_repeatRows; // Rows sampled for the hash
+	int64_t m_repeatFrames; // Number of repeated frames
+	int64_t m_repeatTimestamp; // Last frame compared
+	int64_t m_repeatTimecode;
+	uint64_t m_repeatHashValue;
+	NDIlib_FourCC_video_type_e m_repeatFourCC;
+	int m_repeatWidth;
+	int m_repeatHeight;
+	int m_repeatStride;
+	void UpdateRepeat();
+	uint64_t SampleHash();
+	void ResetRepeat();
+
 	// Audio frame received
 	bool m_bAudio;
 	bool m_bAudioFrame;
 	float* m_AudioData;
+	size_t m_AudioDataSize; // Floats allocated
 	int m_nAudioSampleRate;
 	int m_nAudioSamples;
 	int m_nAudioChannels;
 	int m_AudioDataStride;
+	ofxNDIfifo m_audioFifo;
+	std::mutex m_audioFifoMutex; // Allocate and Release against the write in ReceiveImage
+	ofxNDIresampler m_audioResampler;
+	void CopyAudioFrame(const NDIlib_audio_frame_v3_t &audio_frame);
+
+	// Statistics
+	ofxNDIreceiveStats m_stats;
+	std::mutex m_statsMutex; // Statistics and pNDI_recv for the sampling thread
+	std::thread m_statsThread;
+	std::atomic<bool> m_bStatsActive;
+	std::condition_variable m_statsCondition;
+	unsigned int m_statsInterval;
+	int64_t m_lastTimestamp; // Previous video frame timestamp
+	double m_jitterTotal;
+	int64_t m_jitterCount;
+	void StatsThread();
+	void UpdateStats(double capturetime);
+
+	// Standby receivers
+	struct ofxNDIstandby {
+		std::string name; // Full NDI sender name
+		NDIlib_recv_instance_t recv; // Receiver or nullptr if not connected
+	};
+	std::vector<ofxNDIstandby> m_standby;
+	NDIlib_recv_bandwidth_e m_standbyBandwidth;
+	NDIlib_recv_instance_t pNDI_standby; // Standby receiver in use for the selected sender
+	std::string m_standbyName; // Sender name of the standby receiver in use
+	NDIlib_recv_instance_t pNDI_frame; // Receiver that captured the current video frame
+	void UpdateStandby();
+	void TakeStandby(std::string sendername);
+	void ReturnStandby();
+	bool CaptureStandby();
+
+	// Failover
+	std::string m_primaryName; // Primary sender
+	std::vector<std::string> m_backupNames; // Backup senders in order
+	double m_failoverTimeout; // msec without frames before switching
+	double m_failoverHold; // msec the primary must be stable before return
+	double m_failoverLatency; // msec from the last switch to the first frame
+	bool m_bFailover; // Receiving from a backup sender
+	bool m_bPrimaryStandby; // Primary standby receiver added for failover
+	int64_t m_primaryFrames; // Primary standby video frame count
+	std::chrono::steady_clock::time_point m_primaryFrameTime; // Primary frame count last changed
+	std::chrono::steady_clock::time_point m_lastFrameTime; // Last video frame received
+	std::chrono::steady_clock::time_point m_switchTime; // Time of the last switch
+	std::chrono::steady_clock::time_point m_primaryStableTime; // Primary stable since
+	bool m_bSwitching; // Waiting for the first frame after a switch
+	bool m_bPrimaryStable;
+	bool SwitchSender(std::string sendername);
+	bool AddPrimaryStandby();
+
+	// Capture a frame from the selected receiver
+	// or from a standby receiver until it has connected
+	NDIlib_frame_type_e CaptureFrame(NDIlib_audio_frame_v3_t* audio_frame, NDIlib_metadata_frame_t* metadata_frame);
 
 	// Replacement function for deprecated NDIlib_find_get_sources
 	// If no timeout specified, return the sources that exist right now
@@ -34,6 +34,18 @@
 			 - Add NOMINMAX define to avoid conflict for
 			   std::min/std::max and Windows min/max
 	23.02.26 - Add audio functions AudioFrameSequence and InterleavedToPlanar
+	18.10.26 - Replace StartTiming/EndTiming with tracing functions
+			   TraceBegin, TraceEnd, TraceSpan, StartTrace, StopTrace, WriteTrace
+			 - Add HashBuffer, hash64 and hash64_sse2
+			 - Add DirtyTiles, memequal and memequal_sse2
+			 - HoldFps - use ofxNDIpacer
+			 - Add OFXNDI_SIMD for SSE2 functions on any x86/x64 or ARM NEON system
+			   including Linux. Add HasSIMD and GetSIMD.
+			 - Add monotonic clock GetClockTime and GetElapsedTime
+			 - Add audio conversion to a caller buffer with SSE2 versions
+			   InterleavedToPlanar, PlanarToInterleaved, FloatToInt16, FloatToInt32,
+			   Int16ToFloat, Int32ToFloat, AudioGain
+			 - AudioFrameSequence - use ofxNDIcadence for an exact average
 
 */
 #pragma once
@@ -53,21 +65,40 @@
 #include <algorithm> // for std::min
 #include <numeric>   // for std::accumulate
 
-// TODO : test includes for OSX
 #if defined(TARGET_OSX)
 #define USE_CHRONO
-#if defined(__aarch64__)
-#include "sse2neon.h"
-#else
-#include <x86intrin.h> // for _movsd
-#endif
 #elif defined(TARGET_WIN32)
 #include <windows.h>
-#include <intrin.h> // for _movsd
 #pragma comment (lib, "winmm.lib") // for timeBeginPeriod
 // #else // Linux
 #endif
 
+//
+// SSE2 functions are compiled for the processor rather than the system.
+//
+// x86 and x64 - SSE2 intrinsics.
+// ARM with NEON (e.g. Apple silicon, Raspberry Pi 4/5, aarch64 Linux) -
+// the same intrinsics translated to NEON by sse2neon.h, which must be in
+// the include path (https://github.com/DLTcollab/sse2neon).
+// 32 bit gcc/clang builds need -msse2.
+// Define OFXNDI_NO_SIMD to use only the functions without SSE.
+// HasSIMD checks that the processor supports them.
+//
+#if !defined(OFXNDI_NO_SIMD)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+#define OFXNDI_SIMD
+#if defined(_MSC_VER)
+#include <intrin.h> // for __movsd, _rotl and __cpuid
+#else
+#include <immintrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__) || defined(__ARM_NEON)
+#define OFXNDI_SIMD
+#define OFXNDI_SIMD_NEON
+#include "sse2neon.h"
+#endif
+#endif
+
 #include <cstring>
 #include <climits>
 
@@ -129,8 +160,14 @@ namespace ofxNDIutils {
 		unsigned int sourcePitch, unsigned int destPitch,
 		bool bInvert = false);
 
-// TODO : check it works for OSX
-#if defined(TARGET_WIN32) || defined(TARGET_OSX)
+	// Whether the processor supports the SSE2 functions.
+	// Checked once. Always true for x64 and ARM NEON.
+	bool HasSIMD();
+	// Instruction set used by the SSE2 functions
+	// "SSE2", "NEON" or "none"
+	std::string GetSIMD();
+
+#if defined(OFXNDI_SIMD)
 	void memcpy_sse2(void* dst, const void* src, size_t Size);
 	void memcpy_movsd(void* dst, const void* src, size_t Size);
 	void rgba_bgra_sse2(const void *source, void *dest, unsigned int width, unsigned int height, bool bInvert = false);
@@ -141,16 +178,134 @@ namespace ofxNDIutils {
 	void rgb2rgba(const void* rgb_source, void* rgba_dest, unsigned int width, unsigned int height, bool bInvert);
 	void YUV422_to_RGBA(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height, unsigned int stride = 0);
 
+	//
+	// Frame hash
+	//
+
+	// 64 bit hash of a buffer, e.g. to find a repeated frame.
+	// Not for security. SSE2 if available.
+	uint64_t HashBuffer(const void* data, size_t size);
+	uint64_t hash64(const void* data, size_t size);
+#if defined(OFXNDI_SIMD)
+	uint64_t hash64_sse2(const void* data, size_t size);
+#endif
+
+	//
+	// Changed tiles
+	//
+
+	// Compare an image with the previous image in tiles
+	// and copy the changed tiles to the previous image.
+	// - current | image pixels
+	// - previous | previous image, rowbytes for each row
+	// - rowbytes | bytes of each row
+	// - height | rows
+	// - pitch | bytes between current rows (0 for rowbytes)
+	// - tilebytes | bytes of each tile row, e.g. 64 pixels x 4 for RGBA
+	// - tilerows | rows of each tile
+	// - dirty | returns 1 for each changed tile, tile row by tile row
+	// Returns the number of changed tiles.
+	unsigned int DirtyTiles(const unsigned char* current, unsigned char* previous,
+		unsigned int rowbytes, unsigned int height, unsigned int pitch,
+		unsigned int tilebytes, unsigned int tilerows,
+		std::vector<unsigned char> &dirty);
+	// Return whether two buffers are the same
+	bool memequal(const void* a, const void* b, size_t size);
+#if defined(OFXNDI_SIMD)
+	bool memequal_sse2(const void* a, const void* b, size_t size);
+#endif
+
+	//
+	// Audio conversion
+	//
+	// Output to a buffer provided by the caller with no allocation.
+	// Planar buffers have "stride" floats from one channel to the next
+	// (0 for the number of samples). 1 to 64 channels.
+	// Float full scale is -1.0 to 1.0. Integers are clipped.
+	//
+
+	// Interleaved (L R L R ...) to planar (L L ... R R ...) float
+	void InterleavedToPlanar(const float* interleaved, float* planar, int channels, int samples, int stride = 0);
+	// Planar to interleaved float
+	void PlanarToInterleaved(const float* planar, float* interleaved, int channels, int samples, int stride = 0);
+	// Float to 16 bit with gain, clipping and optional triangular dither
+	void FloatToInt16(const float* source, int16_t* dest, size_t count, float gain = 1.0f, bool bDither = false);
+	// Float to 32 bit with gain and clipping
+	void FloatToInt32(const float* source, int32_t* dest, size_t count, float gain = 1.0f);
+	// 16 bit to float with gain
+	void Int16ToFloat(const int16_t* source, float* dest, size_t count, float gain = 1.0f);
+	// 32 bit to float with gain
+	void Int32ToFloat(const int32_t* source, float* dest, size_t count, float gain = 1.0f);
+	// Gain. Source and dest can be the same.
+	void AudioGain(const float* source, float* dest, size_t count, float gain);
+
+	// Without SSE
+	void interleaved_planar(const float* interleaved, float* planar, int channels, int samples, int stride = 0);
+	void planar_interleaved(const float* planar, float* interleaved, int channels, int samples, int stride = 0);
+	void float_int16(const float* source, int16_t* dest, size_t count, float gain = 1.0f, bool bDither = false);
+	void float_int32(const float* source, int32_t* dest, size_t count, float gain = 1.0f);
+	void int16_float(const int16_t* source, float* dest, size_t count, float gain = 1.0f);
+	void int32_float(const int32_t* source, float* dest, size_t count, float gain = 1.0f);
+	void audio_gain(const float* source, float* dest, size_t count, float gain);
+#if defined(OFXNDI_SIMD)
+	void interleaved_planar_sse2(const float* interleaved, float* planar, int channels, int samples, int stride = 0);
+	void planar_interleaved_sse2(const float* planar, float* interleaved, int channels, int samples, int stride = 0);
+	void float_int16_sse2(const float* source, int16_t* dest, size_t count, float gain = 1.0f, bool bDither = false);
+	void float_int32_sse2(const float* source, int32_t* dest, size_t count, float gain = 1.0f);
+	void int16_float_sse2(const int16_t* source, float* dest, size_t count, float gain = 1.0f);
+	void int32_float_sse2(const int32_t* source, float* dest, size_t count, float gain = 1.0f);
+	void audio_gain_sse2(const float* source, float* dest, size_t count, float gain);
+#endif
+
+	//
+	// Tracing
+	//
+	// Spans are recorded by each thread to its own buffer without locks
+	// and written as JSON for chrome://tracing or https://ui.perfetto.dev
+	// Spans can be nested and are only recorded while tracing is started.
+	//
+
+	// Maximum events recorded by each thread
+	#define OFXNDI_TRACE_EVENTS 32768
+	// Maximum nesting of spans
+	#define OFXNDI_TRACE_DEPTH 16
+
+	// Start recording and clear previous events
+	void StartTrace();
+	// Stop recording. Recorded events are retained.
+	void StopTrace();
+	// Return whether recording
+	bool IsTracing();
+	// Write recorded events to a JSON file.
+	// Should not be called at the same time as StartTrace.
+	bool WriteTrace(const char* path);
+	// Start a span. The name is copied when the span ends.
+	void TraceBegin(const char* name);
+	// End the last span started by this thread
+	void TraceEnd();
+	// Name the calling thread in the trace
+	void TraceThreadName(const char* name);
+
+	// Span for the lifetime of the object
+	class TraceSpan {
+	public:
+		TraceSpan(const char* name) { TraceBegin(name); }
+		~TraceSpan() { TraceEnd(); }
+	};
+
 	//
 	// Timing
 	//
 
+	// Monotonic clock (std::chrono::steady_clock) in nanoseconds.
+	// Not affected by changes to the system time.
+	// Use for all timing, fps, latency and jitter measurements.
+	int64_t GetClockTime();
+	// Time since a GetClockTime value (msec)
+	double GetElapsedTime(int64_t start);
+
 #ifdef USE_CHRONO
-	// Start timing period
-	void StartTiming();
-	// Stop timing and return microseconds elapsed.
-	// Code console output can be enabled for quick timing tests.
-	double EndTiming();
+	// Hold a frame rate. See ofxNDIpacer for fractional rates.
 	void HoldFps(int fps);
 #if defined(TARGET_WIN32)
 	// Windows minimum time period
@@ -163,6 +318,7 @@ namespace ofxNDIutils {
 	//
 
 	// Create an audio frame number sequence for a given video fps
+	// See ofxNDIcadence for an exact sequence without allocation
 	std::vector<int> AudioFrameSequence(int audioSampleRate, double videoFps, int &maxSample, int length = 100);
 
 	// Convert interleaved audio to a single planar buffer for NDI v2
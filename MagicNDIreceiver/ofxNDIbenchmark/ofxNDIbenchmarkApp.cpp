@@ -0,0 +1,93 @@
+/*
+
+	ofxNDIbenchmarkApp
+
+	Console program to run ofxNDIbenchmark
+
+	ofxNDIbenchmark [-kernels] [-frames N] [-fps N] [file.json]
+
+	  -kernels   compare and time the ofxNDIutils kernels only
+	  -frames N  frames sent by each stream for each case (default 300)
+	  -fps N     frame rate of clocked senders (default 60)
+	  file.json  results file (default ofxNDIbenchmark.json)
+
+	Set the environment variable OFXNDI_MOCK=1 to use the loopback
+	mock runtime so that no network or NDI runtime is needed.
+	Memory allocations are counted (OFXNDI_BENCHMARK_ALLOCATIONS).
+	Returns 1 if a kernel is different to its reference
+	or if a case received no frames.
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create file
+
+*/
+#include "ofxNDIbenchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char* argv[])
+{
+	bool bKernelsOnly = false;
+	int frames = 300;
+	int fps = 60;
+	const char* path = "ofxNDIbenchmark.json";
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-kernels") == 0) {
+			bKernelsOnly = true;
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && i+1 < argc) {
+			frames = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-fps") == 0 && i+1 < argc) {
+			fps = atoi(argv[++i]);
+		}
+		else if (argv[i][0] != '-') {
+			path = argv[i];
+		}
+		else {
+			printf("ofxNDIbenchmark [-kernels] [-frames N] [-fps N] [file.json]\n");
+			return 1;
+		}
+	}
+
+	ofxNDIbenchmark bench;
+	if (frames > 0)
+		bench.SetFrames(frames);
+	if (fps > 0)
+		bench.SetFrameRate(fps);
+
+	bool bResult = bench.RunKernels();
+	if (!bKernelsOnly) {
+		bench.AddDefaultCases();
+		if (!bench.Run())
+			bResult = false;
+	}
+
+	if (!bench.WriteJSON(path))
+		return 1;
+	printf("ofxNDIbenchmark - results written to [%s]\n", path);
+
+	return bResult ? 0 : 1;
+}
@@ -131,6 +131,29 @@
 // 16.05.26		- Set all fbo pixels opaque in FlipTexture
 //				  Rebuild with latest ofxNDI - NDI 6.3.1.0 x64/MT
 //				  Version 1.026
+// 18.10.26		- Textures from a pool for re-use when the size changes
+//				  Textures have immutable storage
+//				  FlipTexture - do not re-create textures every frame
+//				  if YUV is not selected
+//				- CPU and GPU timing of flip, alpha clear, YUV conversion,
+//				  readback, copy and NDI send stages
+//				  Add "Profile" option to write timing to a CSV file
+//				  Show timing in help text
+//				- Add "Trace" option to record each stage and NDI send
+//				  to a chrome://tracing JSON file
+//				- Add "Capture fps" option to capture and send frames
+//				  at the Fps rate independent of the Magic frame rate.
+//				  Captures wait for the previous readback to complete.
+//				- Add "Skip duplicates" option to hash each frame and
+//				  not send it if it is the same as the last frame sent.
+//				  "Keep alive" sends a duplicate after that many seconds.
+//				- Add "Audio" option to send Magic's audio with the video.
+//				  New samples of each Magic frame are written to an audio FIFO
+//				  and each frame sent has the samples of the ofxNDIsend audio
+//				  cadence for the frame rate. Video and audio timecodes are
+//				  from the same start with "Capture fps". Add "Audio rate".
+//				  Without "Capture fps", frames are not paced and each
+//				  has the samples for the time since the last.
 //
 // =======================================================================================
 
@@ -150,9 +173,14 @@
 #include "MagicModule.h"
 #include "ofxNDIsend.h"
 #include "ofxNDIutils.h" // for SSE CopyImage function
+#include "ofxNDIfifo.h" // Audio FIFO
 // Spout extensions (with standaloneExtensions define)
 #include "SpoutGL\SpoutGLextensions.h"
 #include "SpoutGL\YuvShaders.h" // Compute shaders
+#include "SpoutGL\ResourcePool.h" // Texture re-use
+#include "SpoutGL\StageTimer.h" // Stage timing
+#include "SpoutGL\CaptureScheduler.h" // Capture rate
+#include <chrono> // for profile file interval
 
 // Convenience definitions
 #define PARAM_SenderName 0
@@ -161,9 +189,16 @@
 #define PARAM_Async      3
 #define PARAM_Buffer     4
 #define PARAM_YUV        5
+#define PARAM_Profile    6
+#define PARAM_Trace      7
+#define PARAM_Capture    8
+#define PARAM_Duplicate  9
+#define PARAM_KeepAlive  10
+#define PARAM_Audio      11
+#define PARAM_AudioRate  12
 
 // Number of parameters
-#define NumParams 6
+#define NumParams 13
 
 #ifndef GL_READ_FRAMEBUFFER_EXT
 #define GL_READ_FRAMEBUFFER_EXT 0x8CA8
@@ -202,6 +237,21 @@ public:
 		bClock = true;
 		bBuffer = true;
 		bAsync = false;
+		bCapture = true;
+		bDuplicate = false;
+		bLastHash = false;
+		m_lastHash = 0;
+		m_keepAlive = 1.0; // seconds
+		m_duplicates = 0;
+		bAudio = false;
+		m_audioRate = 48000;
+		bAudioCapture = false;
+		bAudioPrimed = false;
+		bTimecodeStart = false;
+		m_audioFraction = 0.0;
+		bAudioSend = false;
+		m_audioSendFraction = 0.0;
+		m_timecodeStart = 0;
 		m_pbo[0] = 0;
 		m_pbo[1] = 0;
 		m_pbo[2] = 0;
@@ -209,8 +259,24 @@ public:
 		NextPboIndex = 0;
 		m_frate_N = 60000; // default 60 fps
 		m_frate_D = 1000;
+		m_scheduler.SetRate(m_frate_N, m_frate_D);
 		hlp.reserve(1024); // reserve plenty instead of allocate on the stack
 
+		// Stages timed for each frame
+		STAGE_Flip     = m_timer.AddStage("Flip");
+		STAGE_Clear    = m_timer.AddStage("Alpha clear");
+		STAGE_YUV      = m_timer.AddStage("YUV");
+		STAGE_Readback = m_timer.AddStage("Readback");
+		STAGE_Copy     = m_timer.AddStage("Map/copy");
+		STAGE_Hash     = m_timer.AddStage("Hash", false);
+		STAGE_Send     = m_timer.AddStage("NDI send", false);
+		STAGE_Audio    = m_timer.AddStage("NDI audio", false);
+		m_profileTime = std::chrono::steady_clock::now();
+		m_lastSend = m_profileTime;
+		m_audioTime = m_profileTime;
+		m_audioSendTime = m_profileTime;
+		m_timeStart = m_profileTime;
+
 	}
 
 	~MagicNDIsenderModule() {
@@ -240,14 +306,14 @@ public:
 		if (m_fbo) glDeleteFramebuffersEXT(1, &m_fbo);
 		glGenFramebuffersEXT(1, &m_fbo);
 
-		if (bYUV) {
-			if (m_yuvTexture) glDeleteTextures(1, &m_yuvTexture);
-			glGenTextures(1, &m_yuvTexture);
-		}
+		// Textures for sending pixel data are created by FlipTexture
+		m_pool.Clear();
+		m_glTexture = 0;
+		m_yuvTexture = 0;
 
-		// RGBA texture for sending pixel data
-		if (m_glTexture) glDeleteTextures(1, &m_glTexture);
-		glGenTextures(1, &m_glTexture);
+		// Timer queries are re-created for the new context
+		m_timer.Release();
+		m_scheduler.Release();
 
 	};
 	
@@ -258,14 +324,25 @@ public:
 		ReleaseNDIsender();
 		if (m_pbo[0]) glDeleteBuffers(3, m_pbo);
 		if (m_fbo) glDeleteFramebuffersEXT(1, &m_fbo);
-		if (m_glTexture) glDeleteTextures(1, &m_glTexture);
-		if (m_yuvTexture) glDeleteTextures(1, &m_yuvTexture);
+		m_pool.Clear();
+		m_glTexture = 0;
+		m_yuvTexture = 0;
+		m_timer.Release();
+		m_scheduler.Release();
+
+		// Write the trace if recording
+		if (ofxNDIutils::IsTracing()) {
+			ofxNDIutils::StopTrace();
+			ofxNDIutils::WriteTrace(m_traceFile.c_str());
+		}
 
 	};
 
 
 	void drawAfter(MagicUserData *userData) {
 
+		ofxNDIutils::TraceSpan span("MagicNDIsender::drawAfter");
+
 		if (userData->glState->currentFramebuffer > 0) {
 
 			// If there is no sender name yet, the sender cannot be created
@@ -299,23 +376,37 @@ public:
 
 			if (ndisender.SenderCreated()) {
 
+				// New audio samples of every Magic frame
+				if (bAudio)
+					CaptureAudio(userData);
+
+				// Capture at the output frame rate and skip other frames
+				bool bCaptureFrame = m_scheduler.Capture();
+
 				// Get a texture (m_glTexture) from the host fbo and flip at the same time
 				// to avoid flipping the pixel buffer using cpu memory
-				if (FlipTexture(m_Width, m_Height, userData->glState->currentFramebuffer)) {
+				if (bCaptureFrame && FlipTexture(m_Width, m_Height, userData->glState->currentFramebuffer)) {
 
 					if (bYUV) {
 						// Compute shader to convert texture from RGBA to YUV
+						BeginStage(STAGE_YUV);
+						ofxNDIutils::TraceBegin("yuvShaders::RgbaToYUV");
 						m_shaders.RgbaToYUV(m_glTexture, m_yuvTexture, m_Width, m_Height, false);
+						ofxNDIutils::TraceEnd();
+						EndStage(STAGE_YUV);
 						if (bBuffer) {
 							UnloadTexturePixels(m_yuvTexture, m_Width/2, m_Height, spout_buffer,
 								GL_RGBA, userData->glState->currentFramebuffer);
 						}
 						else {
+							// Readback and copy together
+							BeginStage(STAGE_Readback);
 							glBindTexture(GL_TEXTURE_2D, m_yuvTexture);
 							glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, (void *)spout_buffer);
 							glBindTexture(GL_TEXTURE_2D, 0);
+							EndStage(STAGE_Readback);
 						}
-						ndisender.SendImage(spout_buffer, m_Width, m_Height, false, false);
+						SendFrame();
 					}
 					else {
 						if (bBuffer) {
@@ -323,14 +414,20 @@ public:
 								GL_RGBA, userData->glState->currentFramebuffer);
 						}
 						else {
+							BeginStage(STAGE_Readback);
 							glBindTexture(GL_TEXTURE_2D, m_glTexture);
 							glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, (void *)spout_buffer);
 							glBindTexture(GL_TEXTURE_2D, 0);
+							EndStage(STAGE_Readback);
 						}
-						ndisender.SendImage(spout_buffer, m_Width, m_Height, false, false);
+						SendFrame();
 					}
 				}
 
+				// Collect GPU times that are ready
+				m_timer.Update();
+				WriteProfile();
+
 				// RGBA			Buffered	Non-buffer
 				// 1280x720		3-4 msec	3-4
 				// 1920x1080	5-6 msec	7-8
@@ -352,7 +449,8 @@ public:
 		if (!newValue)
 			return false;
 
-		if(newValue[0] == 0)
+		// The profile and trace file names can be empty
+		if(newValue[0] == 0 && whichParam != PARAM_Profile && whichParam != PARAM_Trace)
 			return false;
 
 		int iValue = atoi(newValue);
@@ -368,11 +466,13 @@ public:
 			case PARAM_Fps:
 				m_frate_N = (int)(atof(newValue) * 1000.0);
 				m_frate_D = 1000;
-				if (bClock) {
+				m_scheduler.SetRate(m_frate_N, m_frate_D);
+				if (bClock || bCapture) {
 					ndisender.SetFrameRate(m_frate_N, m_frate_D);
 					if (ndisender.SenderCreated())
 						ndisender.UpdateSender(m_Width, m_Height);
 				}
+				SetupAudio(); // Samples for the frame rate
 				break;
 
 			case PARAM_YUV:
@@ -390,7 +490,7 @@ public:
 			case PARAM_Clock:
 				bClock = (iValue == 1);
 				ndisender.SetClockVideo(bClock);
-				if (!bClock) {
+				if (!bClock && !bCapture) {
 					// default to 60 fps
 					ndisender.SetFrameRate(60000, 1000);
 				}
@@ -403,7 +503,7 @@ public:
 					// Re-create the sender because clock_video is
 					// part of NDI_send_create_desc used to create the sender
 				}
-
+				SetupAudio();
 				break;
 
 			// Async mode
@@ -420,6 +520,67 @@ public:
 				bBuffer = (iValue == 1);
 				break;
 
+			// Capture at the Fps rate
+			case PARAM_Capture:
+				bCapture = (iValue == 1);
+				m_scheduler.SetActive(bCapture);
+				// The sender frame rate is the capture rate
+				if (bClock || bCapture)
+					ndisender.SetFrameRate(m_frate_N, m_frate_D);
+				else
+					ndisender.SetFrameRate(60000, 1000);
+				if (ndisender.SenderCreated())
+					ndisender.UpdateSender(m_Width, m_Height);
+				SetupAudio();
+				break;
+
+			// Skip frames that are the same as the last frame sent
+			case PARAM_Duplicate:
+				bDuplicate = (iValue == 1);
+				bLastHash = false;
+				m_duplicates = 0;
+				break;
+
+			// Seconds after which a duplicate frame is sent
+			case PARAM_KeepAlive:
+				m_keepAlive = atof(newValue);
+				if (m_keepAlive < 0.0)
+					m_keepAlive = 0.0;
+				break;
+
+			// Send Magic's audio
+			case PARAM_Audio:
+				bAudio = (iValue == 1);
+				SetupAudio();
+				break;
+
+			// Sample rate of Magic's audio
+			case PARAM_AudioRate:
+				if (iValue > 0) {
+					m_audioRate = iValue;
+					SetupAudio();
+				}
+				break;
+
+			// Timing CSV file
+			case PARAM_Profile:
+				m_profileFile = newValue;
+				m_timer.Reset();
+				break;
+
+			// Trace JSON file
+			// Recording starts when a file name is entered
+			// and the file is written when it is cleared
+			case PARAM_Trace:
+				if (ofxNDIutils::IsTracing()) {
+					ofxNDIutils::StopTrace();
+					ofxNDIutils::WriteTrace(m_traceFile.c_str());
+				}
+				m_traceFile = newValue;
+				if (!m_traceFile.empty())
+					ofxNDIutils::StartTrace();
+				break;
+
 			default:
 				break;
 
@@ -437,7 +598,17 @@ public:
 		switch (whichParam) {
 
 			case PARAM_Fps:
-				if (!bClock)
+				if (!bClock && !bCapture)
+					return false;
+				break;
+
+			case PARAM_KeepAlive:
+				if (!bDuplicate)
+					return false;
+				break;
+
+			case PARAM_AudioRate:
+				if (!bAudio)
 					return false;
 				break;
 
@@ -460,7 +631,14 @@ public:
 			"    Clock video : clock frame rate to fps\n"
 			"    Async : asynchronous sending\n"
 			"    Buffering : use OpenGL pixel buffering\n"
-			"    YUV : Send YUV data (default RGBA)\n\n"
+			"    YUV : Send YUV data (default RGBA)\n"
+			"    Profile : file to write stage timing (CSV)\n"
+			"    Trace : file to record a trace (JSON)\n"
+			"    Capture fps : capture at fps, not every frame\n"
+			"    Skip duplicates : do not send repeated frames\n"
+			"    Keep alive : seconds to send a repeated frame\n"
+			"    Audio : send Magic's audio with the video\n"
+			"    Audio rate : sample rate of Magic's audio\n\n"
 			"  Lynn Jarvis 2018-2026\n  https://spout.zeal.co \n"
 			"  ofxNDI Version ";
 		hlp += ofxNDIutils::GetVersion(); hlp += "\n";
@@ -474,6 +652,29 @@ public:
 			  std::string NDInumber = ndisender.GetNDIversion().substr(NDIversion.length() - 8, 8);
 			  hlp += NDInumber;
 
+		// Stage timing
+		if (ndisender.SenderCreated()) {
+			hlp += "\n\n";
+			if (bCapture) {
+				char tmp[128]{};
+				sprintf_s(tmp, 128, "  Capture %.1f fps, skipped %lld, deferred %lld\n",
+					m_scheduler.GetFps(), m_scheduler.GetSkipped(), m_scheduler.GetDeferred());
+				hlp += tmp;
+			}
+			if (bDuplicate) {
+				char tmp[128]{};
+				sprintf_s(tmp, 128, "  Duplicate frames skipped %lld\n", m_duplicates);
+				hlp += tmp;
+			}
+			if (bAudio) {
+				char tmp[128]{};
+				sprintf_s(tmp, 128, "  Audio %d Hz, buffered %d, silence %lld, dropped %lld\n",
+					m_audioRate, m_audioFifo.GetAvailable(), m_audioFifo.GetUnderruns(), m_audioFifo.GetOverruns());
+				hlp += tmp;
+			}
+			hlp += m_timer.GetText();
+		}
+
 		return hlp.c_str();
 
 	}
@@ -493,6 +694,27 @@ protected:
 	bool bClock;
 	bool bBuffer;
 	bool bAsync;
+	bool bCapture;
+	bool bDuplicate; // skip frames the same as the last sent
+	bool bLastHash; // m_lastHash is for the current sender
+	uint64_t m_lastHash; // hash of the last frame sent
+	double m_keepAlive; // seconds to send a duplicate frame
+	long long m_duplicates; // frames skipped
+	std::chrono::steady_clock::time_point m_lastSend; // time of the last frame sent
+	bool bAudio; // send Magic's audio
+	int m_audioRate; // sample rate of Magic's audio
+	ofxNDIfifo m_audioFifo; // new samples of each Magic frame
+	std::vector<float> m_audioBuffer; // samples of one frame sent
+	bool bAudioCapture; // m_audioTime is the last capture
+	bool bAudioPrimed; // the FIFO has reached the latency
+	double m_audioFraction; // part sample not yet captured
+	std::chrono::steady_clock::time_point m_audioTime; // last capture
+	bool bAudioSend; // m_audioSendTime is the last audio frame sent without "Capture fps"
+	double m_audioSendFraction; // part sample not yet sent
+	std::chrono::steady_clock::time_point m_audioSendTime; // last audio frame sent
+	bool bTimecodeStart; // timecodes have started
+	int64_t m_timecodeStart; // NDI timecode of the first frame (100 nsec)
+	std::chrono::steady_clock::time_point m_timeStart; // time of the first frame
 	unsigned char* spout_buffer;
 	GLuint m_pbo[3];
 	int PboIndex;
@@ -501,8 +723,236 @@ protected:
 	GLuint m_glTexture;
 	GLuint m_yuvTexture;
 	yuvShaders m_shaders; // compute shaders
+	resourcePool m_pool; // textures for re-use
+	stageTimer m_timer; // stage timing
+	captureScheduler m_scheduler; // capture at the output frame rate
+	int STAGE_Flip, STAGE_Clear, STAGE_YUV;
+	int STAGE_Readback, STAGE_Copy, STAGE_Hash, STAGE_Send, STAGE_Audio;
+	std::string m_profileFile; // CSV file for stage timing
+	std::chrono::steady_clock::time_point m_profileTime; // last written
+	std::string m_traceFile; // JSON file for tracing
 	std::string hlp;
-	
+
+	// Time a stage and record it in the trace
+	void BeginStage(int stage)
+	{
+		ofxNDIutils::TraceBegin(m_timer.GetName(stage));
+		m_timer.Begin(stage);
+	}
+
+	void EndStage(int stage)
+	{
+		m_timer.End(stage);
+		ofxNDIutils::TraceEnd();
+	}
+
+	// Send the pixel buffer to NDI
+	// If duplicates are skipped, a frame with the same hash as the
+	// last frame sent is not sent unless the keep alive time has passed.
+	// NDI receivers keep showing the last frame received.
+	// Audio is sent for every frame captured, including duplicates.
+	void SendFrame()
+	{
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (bAudio)
+			SetTimecodes(now);
+		bool bSend = true;
+		if (bDuplicate) {
+			BeginStage(STAGE_Hash);
+			const uint64_t hash = ofxNDIutils::HashBuffer(spout_buffer,
+				(size_t)m_Width*(size_t)m_Height*(bYUV ? 2 : 4));
+			EndStage(STAGE_Hash);
+			if (bLastHash && hash == m_lastHash
+				&& (m_keepAlive <= 0.0 || std::chrono::duration<double>(now - m_lastSend).count() < m_keepAlive)) {
+				m_duplicates++;
+				bSend = false;
+			}
+			else {
+				m_lastHash = hash;
+				bLastHash = true;
+			}
+		}
+		if (bSend) {
+			BeginStage(STAGE_Send);
+			ndisender.SendImage(spout_buffer, m_Width, m_Height, false, false);
+			EndStage(STAGE_Send);
+			m_lastSend = now;
+		}
+		if (bAudio)
+			SendAudioFrame();
+	}
+
+	// Set up to send Magic's audio with each frame.
+	// The FIFO and the buffer for one frame are allocated here
+	// for the frame rate and audio rate, not for each frame.
+	void SetupAudio()
+	{
+		ndisender.SetAudio(bAudio);
+		// Synthesized unless set by SetTimecodes
+		ndisender.SetVideoTimecode();
+		ndisender.SetAudioTimecode();
+		bAudioCapture = false;
+		bAudioPrimed = false;
+		bAudioSend = false;
+		bTimecodeStart = false;
+
+		if (!bAudio) {
+			ndisender.SetAudioData(nullptr);
+			m_audioFifo.Release();
+			std::vector<float>().swap(m_audioBuffer);
+			return;
+		}
+
+		ndisender.SetAudioType(0); // planar float
+		ndisender.SetAudioChannels(1); // Magic's audio is mono
+		ndisender.SetAudioSampleRate(m_audioRate); // starts the audio cadence again
+		// Frames that are not paced can be longer than the frame rate.
+		// Up to 100 msec of samples are sent with one frame.
+		int maxSamples = ndisender.GetMaxAudioSamples();
+		if (!bCapture && maxSamples < m_audioRate/10)
+			maxSamples = m_audioRate/10;
+		m_audioBuffer.assign((size_t)maxSamples, 0.0f);
+		ndisender.SetAudioSamples(ndisender.GetMaxAudioSamples());
+		ndisender.SetAudioData(m_audioBuffer.data());
+		m_audioFifo.Allocate(1, m_audioRate); // one second
+	}
+
+	// Write the new samples of Magic's audio to the FIFO.
+	// Magic's fifo buffer has the latest numSamples samples with the
+	// newest last. The new samples are those for the time since
+	// the last Magic frame at the audio rate.
+	void CaptureAudio(MagicUserData *userData)
+	{
+		if (!m_audioFifo.IsAllocated() || !userData->samplesFifo || userData->numSamples <= 0)
+			return;
+
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (!bAudioCapture) {
+			m_audioTime = now;
+			m_audioFraction = 0.0;
+			bAudioCapture = true;
+			return;
+		}
+
+		const double samples = std::chrono::duration<double>(now - m_audioTime).count()*(double)m_audioRate + m_audioFraction;
+		m_audioTime = now;
+		int n = (int)samples;
+		m_audioFraction = samples - (double)n;
+		// No more than Magic has after a long frame
+		if (n > userData->numSamples)
+			n = userData->numSamples;
+		if (n > 0)
+			m_audioFifo.Write(userData->samplesFifo + userData->numSamples - n, 0, n, 1, m_audioRate);
+	}
+
+	// Video and audio timecodes of the next frame.
+	// With "Capture fps", frames are at the frame rate of the audio cadence,
+	// so both are counted from the same start and audio frames follow each
+	// other exactly. The count starts again if frames are more than 100 msec
+	// from the cadence, e.g. after a pause. Otherwise frames are at the Magic
+	// frame rate and NDI synthesizes the timecodes.
+	void SetTimecodes(std::chrono::steady_clock::time_point now)
+	{
+		if (!bCapture)
+			return;
+
+		ofxNDIcadence &cadence = ndisender.GetAudioCadence();
+		const double elapsed = std::chrono::duration<double>(now - m_timeStart).count();
+		const double expected = (double)cadence.GetFrameTimecode()/10000000.0;
+		if (!bTimecodeStart || std::fabs(elapsed - expected) > 0.1) {
+			cadence.Reset();
+			m_timeStart = now;
+			// 100 nsec from the UTC epoch as for synthesized timecodes
+			m_timecodeStart = std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(
+				std::chrono::system_clock::now().time_since_epoch()).count();
+			bTimecodeStart = true;
+		}
+		ndisender.SetVideoTimecode(m_timecodeStart + cadence.GetFrameTimecode());
+		ndisender.SetAudioTimecode(m_timecodeStart + cadence.GetTimecode());
+	}
+
+	// Samples of the next audio frame.
+	// With "Capture fps", frames are at the frame rate and have
+	// the samples of the audio cadence. Otherwise frames are sent
+	// at the Magic frame rate, or the NDI clock rate if not skipped,
+	// and have the samples for the time since the last frame sent,
+	// so that the FIFO is read at the audio rate. The first has none.
+	int NextAudioSamples()
+	{
+		if (bCapture)
+			return ndisender.NextAudioFrame();
+
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (!bAudioSend) {
+			m_audioSendTime = now;
+			m_audioSendFraction = 0.0;
+			bAudioSend = true;
+			return 0;
+		}
+
+		const double samples = std::chrono::duration<double>(now - m_audioSendTime).count()*(double)m_audioRate + m_audioSendFraction;
+		m_audioSendTime = now;
+		int n = (int)samples;
+		m_audioSendFraction = samples - (double)n;
+		// No more than the buffer after a long frame
+		if (n > (int)m_audioBuffer.size())
+			n = (int)m_audioBuffer.size();
+		if (n > 0)
+			ndisender.SetAudioSamples(n);
+		return n;
+	}
+
+	// Send Magic's audio for one frame.
+	// The samples of each frame are from NextAudioSamples, e.g.
+	// 800 or 801 for 48 kHz at 59.94 fps.
+	// Reading starts when the FIFO has two frames, so that there are
+	// samples for frames that are early. Silence is sent until then.
+	// After late frames, more than four frames are reduced to two.
+	void SendAudioFrame()
+	{
+		const int samples = NextAudioSamples();
+		if (samples <= 0 || samples > (int)m_audioBuffer.size())
+			return;
+
+		float* buffer = m_audioBuffer.data();
+		const int available = m_audioFifo.GetAvailable();
+		if (!bAudioPrimed && available >= samples*2)
+			bAudioPrimed = true;
+
+		if (bAudioPrimed) {
+			if (available > samples*4) {
+				int excess = available - samples*2;
+				while (excess > 0) {
+					const int n = (excess < samples) ? excess : samples;
+					m_audioFifo.Read(buffer, n, 1);
+					excess -= n;
+				}
+			}
+			// Silence for samples not available
+			if (m_audioFifo.Read(buffer, samples, 1) < samples)
+				bAudioPrimed = false;
+		}
+		else {
+			memset(buffer, 0, (size_t)samples*sizeof(float));
+		}
+
+		BeginStage(STAGE_Audio);
+		ndisender.SendAudio();
+		EndStage(STAGE_Audio);
+	}
+
+	// Write stage timing to the profile file every 5 seconds
+	void WriteProfile()
+	{
+		if (m_profileFile.empty())
+			return;
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now - m_profileTime > std::chrono::seconds(5)) {
+			m_timer.WriteCSV(m_profileFile.c_str());
+			m_profileTime = now;
+		}
+	}
+
 	bool FlipTexture(unsigned int width, unsigned int height, GLuint HostFBO)
 	{
 		GLenum status = 0;
@@ -519,7 +969,7 @@ protected:
 			glGenBuffers(3, m_pbo);
 
 		// Resize textures and global size if necessary
-		if (m_glTexture == 0 || m_yuvTexture == 0 || width != m_Width || height != m_Height) {
+		if (m_glTexture == 0 || (bYUV && m_yuvTexture == 0) || width != m_Width || height != m_Height) {
 			m_Width = width;
 			m_Height = height;
 			if(bYUV) InitTexture(m_yuvTexture, GL_RGBA, width/2, height);
@@ -537,7 +987,9 @@ protected:
 		status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
 		if (status == GL_FRAMEBUFFER_COMPLETE_EXT) {
 			// copy one texture buffer to the other while flipping upside down 
+			BeginStage(STAGE_Flip);
 			glBlitFramebufferEXT(0, 0, width, height, 0, height, width, 0, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+			EndStage(STAGE_Flip);
 		}
 		else {
 			// PrintFBOstatus(status);
@@ -546,11 +998,13 @@ protected:
 		}
 
 		// Set all pixels opaque
+		BeginStage(STAGE_Clear);
 		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo);
 		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE);
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0); // 1.0 for opaque
 		glClear(GL_COLOR_BUFFER_BIT);
 		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		EndStage(STAGE_Clear);
 
 		// restore the host fbo
 		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
@@ -591,7 +1045,12 @@ protected:
 		glBufferData(GL_PIXEL_PACK_BUFFER, width*height*4, 0, GL_STREAM_READ);
 
 		// Read pixels from framebuffer to PBO - glReadPixels() should return immediately.
+		BeginStage(STAGE_Readback);
 		glReadPixels(0, 0, width, height, glFormat, GL_UNSIGNED_BYTE, (GLvoid*)0);
+		EndStage(STAGE_Readback);
+
+		// The next capture waits until this readback is complete
+		m_scheduler.ReadbackStarted();
 
 		// If there is data in the next pbo from the previous call, read it back
 
@@ -600,14 +1059,17 @@ protected:
 
 		// glMapBuffer can return NULL when called the first time
 		// when the next pbo has not been filled with data yet
+		BeginStage(STAGE_Copy);
 		pboMemory = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
 
 		if (pboMemory) {
 			// Update data directly from the mapped pbo buffer with SSE optimisations
 			ofxNDIutils::CopyImage((const unsigned char*)pboMemory, (unsigned char*)data, width, height, width*4);
 			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			EndStage(STAGE_Copy);
 		}
 		else {
+			EndStage(STAGE_Copy);
 			glGetError(); // soak up the last error
 			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
@@ -660,20 +1122,12 @@ protected:
 	}
 
 	// Initialize local OpenGL texture
+	// The texture is taken from the pool and the existing one returned to it.
+	// Textures for a previous size are kept, so that changing back is fast.
 	void InitTexture(GLuint &texID, GLenum GLformat, unsigned int width, unsigned int height)
 	{
-		if (texID != 0) 
-			glDeleteTextures(1, &texID);
-		glGenTextures(1, &texID);
-
-		glBindTexture(GL_TEXTURE_2D, texID);
-		glTexImage2D(GL_TEXTURE_2D, 0, GLformat, width, height, 0, GLformat, GL_UNSIGNED_BYTE, NULL);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glBindTexture(GL_TEXTURE_2D, 0);
-
+		m_pool.ReleaseTexture(texID);
+		texID = m_pool.GetTexture(width, height, GLformat);
 	}
 
 	bool CreateNDIsender(const char * name, MagicUserData * userdata)
@@ -717,6 +1171,9 @@ protected:
 			ndisender.SetFormat(NDIlib_FourCC_video_type_RGBA);
 		ndisender.SetAsync(bAsync);
 		ndisender.SetClockVideo(bClock);
+		m_scheduler.Reset();
+		bLastHash = false;
+		SetupAudio();
 
 		// Create a new sender
 		return(ndisender.CreateSender(SenderName, m_Width, m_Height));
@@ -759,6 +1216,7 @@ protected:
 		// Update global width and height
 		m_Width = width;
 		m_Height = height;
+		bLastHash = false;
 
 		// Update existing sender
 		return(ndisender.UpdateSender(m_Width, m_Height));
@@ -789,7 +1247,7 @@ MagicModule *CreateInstance() {
 	return new MagicNDIsenderModule();
 }
 
-const MagicModuleSettings MagicNDIsenderModule::settings = MagicModuleSettings(NumParams);
+const MagicModuleSettings MagicNDIsenderModule::settings = MagicModuleSettings(NumParams, true, false);
 
 const MagicModuleParam MagicNDIsenderModule::params[NumParams] ={
 	MagicModuleParam("Sender", NULL, NULL, NULL, MVT_STRING, MWT_TEXTBOX, true, "Sender name"),
@@ -800,6 +1258,23 @@ const MagicModuleParam MagicNDIsenderModule::params[NumParams] ={
 	MagicModuleParam("YUV", "1", "0", "1", MVT_BOOL, MWT_TOGGLEBUTTON, true, "Send YUV data (default RGBA).\n"
 		"RGBA is uncompressed and highest quality with alpha. "
 		"YUV is a compressed format but is more speed efficient. "
-		"The difference is more noticeable at high resolutions.")
+		"The difference is more noticeable at high resolutions."),
+	MagicModuleParam("Profile", "", NULL, NULL, MVT_STRING, MWT_TEXTBOX, false, "File to write the CPU and GPU time "
+		"of each stage of sending, as CSV, every 5 seconds. Clear to stop."),
+	MagicModuleParam("Trace", "", NULL, NULL, MVT_STRING, MWT_TEXTBOX, false, "File to record the start and duration "
+		"of each stage and NDI send. Clear to stop and write the file, which can be opened with "
+		"chrome://tracing or https://ui.perfetto.dev"),
+	MagicModuleParam("Capture fps", "1", "0", "1", MVT_BOOL, MWT_TOGGLEBUTTON, true, "Capture and send frames at the Fps rate "
+		"rather than every Magic frame. Frames between are skipped without readback."),
+	MagicModuleParam("Skip duplicates", "0", "0", "1", MVT_BOOL, MWT_TOGGLEBUTTON, true, "Do not send a frame "
+		"that is the same as the last frame sent. Receivers keep the last frame. "
+		"Saves NDI compression and network bandwidth for static content."),
+	MagicModuleParam("Keep alive", "1", NULL, NULL, MVT_STRING, MWT_TEXTBOX, true, "Seconds after which "
+		"a duplicate frame is sent so that receivers do not time out. 0 never sends duplicates."),
+	MagicModuleParam("Audio", "0", "0", "1", MVT_BOOL, MWT_TOGGLEBUTTON, true, "Send Magic's audio with the video "
+		"in the same NDI stream. Use with \"Capture fps\" so that frames are sent at the Fps rate "
+		"and audio and video have the same timecodes."),
+	MagicModuleParam("Audio rate", "48000", NULL, NULL, MVT_STRING, MWT_TEXTBOX, true, "Sample rate of "
+		"Magic's audio input, e.g. 44100 or 48000")
 
 };
@@ -0,0 +1,106 @@
+/*
+
+				CaptureScheduler.h
+
+		Frame capture at an output rate independent of the render rate
+		
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	Copyright (c) 2026, Lynn Jarvis. All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, 
+	are permitted provided that the following conditions are met:
+
+		1. Redistributions of source code must retain the above copyright notice, 
+		   this list of conditions and the following disclaimer.
+
+		2. Redistributions in binary form must reproduce the above copyright notice, 
+		   this list of conditions and the following disclaimer in the documentation 
+		   and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"	AND ANY 
+	EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+	OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE	ARE DISCLAIMED. 
+	IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*/
+#pragma once
+#ifndef __captureScheduler__
+#define __captureScheduler__
+
+#include <windows.h>
+#include <stdint.h>
+#include <chrono>
+
+// Spout OpenGL extensions including sync objects
+#include "SpoutGLextensions.h"
+
+class captureScheduler {
+
+	public:
+
+		captureScheduler();
+		~captureScheduler();
+
+		// Set the output frame rate as a ratio, e.g. 60000/1001.
+		// The phase is reset.
+		void SetRate(int numerator, int denominator);
+
+		// Capture every frame if not active
+		void SetActive(bool bActive);
+		bool GetActive();
+
+		// Decide whether to capture this render frame.
+		// Call once for each render frame.
+		// A frame is captured when at least one output period has
+		// accumulated and the previous readback has completed.
+		bool Capture();
+
+		// Insert a fence after the readback commands of a capture
+		// so that the next capture does not wait for them
+		void ReadbackStarted();
+
+		// Whether the last readback has completed, without waiting
+		bool ReadbackComplete();
+
+		// Frames captured and skipped since Reset,
+		// and captures deferred for an incomplete readback
+		int64_t GetCaptured();
+		int64_t GetSkipped();
+		int64_t GetDeferred();
+
+		// Captured frames per second over the last second
+		double GetFps();
+
+		// Reset the phase and counts
+		void Reset();
+
+		// Delete the fence.
+		// Required before the OpenGL context is closed or changed.
+		void Release();
+
+	protected :
+
+		int m_numerator = 60000;
+		int m_denominator = 1000;
+		bool m_bActive = true;
+		bool m_bStarted = false;
+		// Phase in units of 1/(numerator*1e9) second
+		// so that the period of D*1e9 units is exact
+		int64_t m_phase = 0;
+		std::chrono::steady_clock::time_point m_last;
+		GLsync m_fence = nullptr;
+		int64_t m_captured = 0;
+		int64_t m_skipped = 0;
+		int64_t m_deferred = 0;
+		// Captures counted for the fps
+		std::chrono::steady_clock::time_point m_fpsStart;
+		int m_fpsCount = 0;
+		double m_fps = 0.0;
+
+};
+
+#endif
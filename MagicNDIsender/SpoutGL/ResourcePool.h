@@ -0,0 +1,106 @@
+/*
+
+				ResourcePool.h
+
+		Pool of OpenGL textures and pixel buffers for re-use
+		
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	Copyright (c) 2026, Lynn Jarvis. All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, 
+	are permitted provided that the following conditions are met:
+
+		1. Redistributions of source code must retain the above copyright notice, 
+		   this list of conditions and the following disclaimer.
+
+		2. Redistributions in binary form must reproduce the above copyright notice, 
+		   this list of conditions and the following disclaimer in the documentation 
+		   and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"	AND ANY 
+	EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+	OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE	ARE DISCLAIMED. 
+	IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+#ifndef __resourcePool__
+#define __resourcePool__
+
+#include <windows.h>
+#include <vector>
+
+// Spout OpenGL extensions
+#include "SpoutGLextensions.h"
+
+class resourcePool {
+
+	public:
+
+		resourcePool();
+		~resourcePool();
+
+		// Get a texture of the given size and format.
+		// A released texture is re-used if there is one that matches,
+		// otherwise a new texture is created with immutable storage.
+		// The contents of a re-used texture are undefined.
+		GLuint GetTexture(unsigned int width, unsigned int height, GLenum internalformat = GL_RGBA8);
+
+		// Return a texture to the pool and zero the caller's ID
+		void ReleaseTexture(GLuint &texID);
+
+		// Get a pixel buffer of at least the given size with immutable storage.
+		// If flags include GL_MAP_PERSISTENT_BIT, the buffer is mapped
+		// and "memory" receives the address. The mapping is kept while
+		// the buffer is in the pool.
+		GLuint GetBuffer(unsigned int size, GLbitfield flags, void** memory = nullptr);
+
+		// Return a buffer to the pool and zero the caller's ID
+		void ReleaseBuffer(GLuint &bufID);
+
+		// Number of released resources of each type kept for re-use.
+		// The least recently released are deleted first.
+		// Default 8 textures and 6 buffers.
+		void SetMaxFree(unsigned int textures, unsigned int buffers);
+
+		// Delete all textures and buffers, including those in use.
+		// Required before the OpenGL context is closed or changed.
+		void Clear();
+
+	protected :
+
+		struct poolTexture {
+			GLuint id;
+			unsigned int width;
+			unsigned int height;
+			GLenum format;
+			bool bUsed;
+		};
+
+		struct poolBuffer {
+			GLuint id;
+			unsigned int size;
+			GLbitfield flags;
+			void* memory;
+			bool bUsed;
+		};
+
+		// In order of release for free resources
+		std::vector<poolTexture> m_textures;
+		std::vector<poolBuffer> m_buffers;
+		unsigned int m_maxFreeTextures = 8;
+		unsigned int m_maxFreeBuffers = 6;
+
+		GLuint CreateTexture(unsigned int width, unsigned int height, GLenum internalformat);
+		void TrimTextures();
+		void TrimBuffers();
+
+};
+
+#endif
@@ -122,6 +122,9 @@
 // Remove for Processing library build (JSpoutLib)
 #define USE_COMPUTE_EXTENSIONS
 
+// Timer query extensions for GPU timing
+#define USE_QUERY_EXTENSIONS
+
 // If load of context creation extension conflicts, disable it here
 // Only used for testing
 #define USE_CONTEXT_EXTENSION
@@ -277,6 +280,28 @@ enum ExtLogLevel {
 #define GL_TEXTURE_SWIZZLE_RGBA        0x8E46
 #endif
 
+// Alpha of formats without alpha
+#ifndef GL_TEXTURE_SWIZZLE_A
+#define GL_TEXTURE_SWIZZLE_A           0x8E45
+#endif
+
+// Single and two channel formats for planar YUV textures
+#ifndef GL_RG
+#define GL_RG                          0x8227
+#endif
+#ifndef GL_R8
+#define GL_R8                          0x8229
+#endif
+#ifndef GL_R16
+#define GL_R16                         0x822A
+#endif
+#ifndef GL_RG8
+#define GL_RG8                         0x822B
+#endif
+#ifndef GL_RG16
+#define GL_RG16                        0x822C
+#endif
+
 // OpenGL floating point formats
 
 // gl3.h
@@ -310,6 +335,7 @@ enum ExtLogLevel {
 #define GLEXT_SUPPORT_COPY			 64
 #define GLEXT_SUPPORT_COMPUTE		128
 #define GLEXT_SUPPORT_CONTEXT       256
+#define GLEXT_SUPPORT_QUERY         512
 
 //-----------------------------------------------------
 // GL consts that are needed and aren't present in GL.h
@@ -657,9 +683,9 @@ typedef GLenum(APIENTRY *glClientWaitSyncPROC) (GLsync sync, GLbitfield flags, G
 typedef void   (APIENTRY *glDeleteSyncPROC) (GLsync sync);
 typedef GLsync(APIENTRY *glFenceSyncPROC) (GLenum condition, GLbitfield flags);
 
-extern glClientWaitSyncPROC glClientWaitSyncEXT;
-extern glDeleteSyncPROC     glDeleteSyncEXT;
-extern glFenceSyncPROC      glFenceSyncEXT;
+extern glClientWaitSyncPROC glClientWaitSync;
+extern glDeleteSyncPROC     glDeleteSync;
+extern glFenceSyncPROC      glFenceSync;
 
 #endif // USE_PBO_EXTENSIONS
 
@@ -674,6 +700,42 @@ typedef void(APIENTRY * glGetInternalFormativPROC)(GLenum target, GLenum interna
 extern glGetInternalFormativPROC glGetInternalFormativ;
 #endif // USE_COPY_EXTENSIONS
 
+//-------------------
+// Timer query extensions
+//-------------------
+#ifdef USE_QUERY_EXTENSIONS
+
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT                0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE      0x8867
+#endif
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED                0x88BF
+#endif
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP                   0x8E28
+#endif
+
+typedef void (APIENTRY * glGenQueriesPROC) (GLsizei n, GLuint *ids);
+typedef void (APIENTRY * glDeleteQueriesPROC) (GLsizei n, const GLuint *ids);
+typedef void (APIENTRY * glBeginQueryPROC) (GLenum target, GLuint id);
+typedef void (APIENTRY * glEndQueryPROC) (GLenum target);
+typedef void (APIENTRY * glQueryCounterPROC) (GLuint id, GLenum target);
+typedef void (APIENTRY * glGetQueryObjectivPROC) (GLuint id, GLenum pname, GLint *params);
+typedef void (APIENTRY * glGetQueryObjectui64vPROC) (GLuint id, GLenum pname, GLuint64 *params);
+
+extern glGenQueriesPROC          glGenQueries;
+extern glDeleteQueriesPROC       glDeleteQueries;
+extern glBeginQueryPROC          glBeginQuery;
+extern glEndQueryPROC            glEndQuery;
+extern glQueryCounterPROC        glQueryCounter;
+extern glGetQueryObjectivPROC    glGetQueryObjectiv;
+extern glGetQueryObjectui64vPROC glGetQueryObjectui64v;
+
+#endif // USE_QUERY_EXTENSIONS
+
 //---------------------------
 // Compute shader extensions
 //---------------------------
@@ -912,6 +974,7 @@ bool loadPBOextensions();
 bool loadCopyExtensions();
 bool loadComputeShaderExtensions();
 bool loadContextExtension();
+bool loadQueryExtensions();
 bool isExtensionSupported(const char *extension);
 void ExtLog(ExtLogLevel level, const char* format, ...);
 
@@ -0,0 +1,1300 @@
+/*
+
+	ofxNDIbenchmark
+
+	Throughput and latency of ofxNDIsend to ofxNDIreceive
+
+	Each stream has a sender and a receiver, each with its own thread.
+	Senders send the same frame repeatedly and receivers capture
+	without a receiving buffer, so that the time measured is for
+	the NDI pipeline rather than for the application.
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+
+	18.10.26	- Create file
+				- Add RunKernels
+				- Add ofxNDIresampler to RunKernels
+				- Add ofxNDIcadence to RunKernels
+				- Scalar CopyImage, FlipBuffer, memcpy, memequal and audio
+				  variants. Time every variant that is checked and
+				  print only those with both results
+
+*/
+#include "ofxNDIbenchmark.h"
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#if !defined(TARGET_WIN32)
+#include <time.h>
+#endif
+#if !defined(_MSC_VER) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h> // for __rdtsc
+#endif
+
+//
+// Allocation counting
+//
+// Global operator new is replaced for the whole program
+// so this is only compiled if OFXNDI_BENCHMARK_ALLOCATIONS is defined.
+// malloc is not counted.
+//
+#ifdef OFXNDI_BENCHMARK_ALLOCATIONS
+#include <new>
+static std::atomic<int64_t> benchAllocations(0);
+void* operator new(size_t size)
+{
+	benchAllocations.fetch_add(1, std::memory_order_relaxed);
+	void* p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+void* operator new[](size_t size)
+{
+	benchAllocations.fetch_add(1, std::memory_order_relaxed);
+	void* p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+#endif
+
+// Frame timestamps are UTC since the Unix Epoch in 100 ns intervals
+static int64_t BenchNow100ns()
+{
+	return std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// CPU time of the calling thread (msec)
+static double BenchThreadCpu()
+{
+#if defined(TARGET_WIN32)
+	FILETIME created{}, exited{}, kernel{}, user{};
+	if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user))
+		return 0.0;
+	ULARGE_INTEGER k{}, u{};
+	k.LowPart = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+	return (double)(k.QuadPart + u.QuadPart)/10000.0; // 100 ns units
+#else
+	struct timespec ts{};
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (double)ts.tv_sec*1000.0 + (double)ts.tv_nsec/1000000.0;
+#endif
+}
+
+// Bytes of an image for the format
+static size_t BenchFrameSize(unsigned int width, unsigned int height, NDIlib_FourCC_video_type_e format)
+{
+	const size_t pixels = (size_t)width*(size_t)height;
+	switch (format) {
+		case NDIlib_FourCC_video_type_NV12:
+		case NDIlib_FourCC_video_type_I420:
+		case NDIlib_FourCC_video_type_YV12:
+			return pixels*3/2;
+		case NDIlib_FourCC_video_type_UYVY:
+			return pixels*2;
+		default:
+			return pixels*4;
+	}
+}
+
+static const char* BenchFormatName(NDIlib_FourCC_video_type_e format)
+{
+	switch (format) {
+		case NDIlib_FourCC_video_type_RGBA: return "RGBA";
+		case NDIlib_FourCC_video_type_BGRA: return "BGRA";
+		case NDIlib_FourCC_video_type_RGBX: return "RGBX";
+		case NDIlib_FourCC_video_type_BGRX: return "BGRX";
+		case NDIlib_FourCC_video_type_UYVY: return "UYVY";
+		case NDIlib_FourCC_video_type_NV12: return "NV12";
+		case NDIlib_FourCC_video_type_I420: return "I420";
+		case NDIlib_FourCC_video_type_YV12: return "YV12";
+		default: return "other";
+	}
+}
+
+// Value at a fraction of sorted samples
+static double BenchPercentile(const std::vector<double> &sorted, double fraction)
+{
+	if (sorted.empty())
+		return 0.0;
+	size_t i = (size_t)(fraction*(double)(sorted.size()-1) + 0.5);
+	return sorted[std::min(i, sorted.size()-1)];
+}
+
+//
+// Kernels
+//
+
+// Cycle counter for x86, otherwise 0
+static uint64_t BenchCycles()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+// Buffer with guard bytes before and after the data
+// and an offset from 64 byte alignment
+struct benchBuffer {
+	std::vector<unsigned char> data;
+	unsigned char* p = nullptr;
+	size_t size = 0;
+	void Create(size_t bytes, size_t offset, unsigned char fill) {
+		data.assign(bytes + offset + 256, fill);
+		uintptr_t base = (reinterpret_cast<uintptr_t>(data.data()) + 64 + 63) & ~(uintptr_t)63;
+		p = reinterpret_cast<unsigned char*>(base) + offset;
+		size = bytes;
+	}
+	// Repeatable contents
+	void Random(uint32_t seed) {
+		for (size_t i = 0; i < size; i++) {
+			seed = seed*1664525u + 1013904223u;
+			p[i] = (unsigned char)(seed >> 24);
+		}
+	}
+	// The data and 64 guard bytes each side must be the same
+	bool Equal(const benchBuffer &other) const {
+		return size == other.size && memcmp(p - 64, other.p - 64, size + 128) == 0;
+	}
+};
+
+// Swap red and blue with option invert
+static void RefSwapRB(const unsigned char* src, unsigned char* dst, unsigned int width, unsigned int height, bool bInvert)
+{
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned char* s = src + (size_t)(bInvert ? height - 1 - y : y)*width*4;
+		unsigned char* d = dst + (size_t)y*width*4;
+		for (unsigned int x = 0; x < width; x++) {
+			d[x*4 + 0] = s[x*4 + 2];
+			d[x*4 + 1] = s[x*4 + 1];
+			d[x*4 + 2] = s[x*4 + 0];
+			d[x*4 + 3] = s[x*4 + 3];
+		}
+	}
+}
+
+// Copy rows with option invert
+static void RefCopyRows(const unsigned char* src, unsigned char* dst, unsigned int rowbytes, unsigned int height,
+	unsigned int srcPitch, unsigned int dstPitch, bool bInvert)
+{
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned char* s = src + (size_t)(bInvert ? height - 1 - y : y)*srcPitch;
+		unsigned char* d = dst + (size_t)y*dstPitch;
+		for (unsigned int x = 0; x < rowbytes; x++)
+			d[x] = s[x];
+	}
+}
+
+// Rows copied by memcpy with option invert
+// CopyImage and FlipBuffer without SSE2
+static void BenchCopyRows(const unsigned char* src, unsigned char* dst, unsigned int width, unsigned int height, bool bInvert)
+{
+	if (!bInvert) {
+		memcpy(dst, src, (size_t)width*height*4);
+		return;
+	}
+	for (unsigned int y = 0; y < height; y++)
+		memcpy(dst + (size_t)y*width*4, src + (size_t)(height - 1 - y)*width*4, (size_t)width*4);
+}
+
+static void RefRgb2Rgba(const unsigned char* src, unsigned char* dst, unsigned int width, unsigned int height, bool bInvert)
+{
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned char* s = src + (size_t)(bInvert ? height - 1 - y : y)*width*3;
+		unsigned char* d = dst + (size_t)y*width*4;
+		for (unsigned int x = 0; x < width; x++) {
+			d[x*4 + 0] = s[x*3 + 0];
+			d[x*4 + 1] = s[x*3 + 1];
+			d[x*4 + 2] = s[x*3 + 2];
+			d[x*4 + 3] = 255;
+		}
+	}
+}
+
+// UYVY to RGBA with the same integer coefficients as YUV422_to_RGBA
+// BT.601 for widths <= 720, otherwise BT.709
+static void RefYUV422(const unsigned char* src, unsigned char* dst, unsigned int width, unsigned int height, unsigned int stride)
+{
+	const bool b709 = (width > 720);
+	const int vr = b709 ? 457 : 407;
+	const int vg = b709 ? -136 : -207;
+	const int ug = b709 ? -54 : -100;
+	const int ub = b709 ? 539 : 514;
+	if (stride == 0) stride = width*2;
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned char* s = src + (size_t)y*stride;
+		unsigned char* d = dst + (size_t)y*width*4;
+		for (unsigned int x = 0; x < width; x++) {
+			const int u = s[(x/2)*4 + 0] - 128;
+			const int v = s[(x/2)*4 + 2] - 128;
+			const int luma = 297*std::max(s[(x/2)*4 + 1 + (x & 1)*2] - 16, 0);
+			const int rgb[3] = {
+				(luma + vr*v + 127) >> 8,
+				(luma + ug*u + vg*v + 127) >> 8,
+				(luma + ub*u + 127) >> 8 };
+			for (int c = 0; c < 3; c++)
+				d[x*4 + c] = (unsigned char)std::min(std::max(rgb[c], 0), 255);
+			d[x*4 + 3] = 255;
+		}
+	}
+}
+
+// Changed 64x64 tiles of a 4 byte per pixel image
+static unsigned int RefDirtyTiles(const unsigned char* current, const unsigned char* previous,
+	unsigned int width, unsigned int height, unsigned int pitch, std::vector<unsigned char> &dirty)
+{
+	const unsigned int tilesX = (width + 63)/64;
+	const unsigned int tilesY = (height + 63)/64;
+	dirty.assign((size_t)tilesX*tilesY, 0);
+	unsigned int changed = 0;
+	for (unsigned int y = 0; y < height; y++) {
+		for (unsigned int x = 0; x < width*4; x++) {
+			unsigned char &tile = dirty[(size_t)(y/64)*tilesX + x/256];
+			if (!tile && current[(size_t)y*pitch + x] != previous[(size_t)y*width*4 + x]) {
+				tile = 1;
+				changed++;
+			}
+		}
+	}
+	return changed;
+}
+
+// Result for a kernel variant, added if not found
+static ofxNDIkernelResult &BenchKernel(std::vector<ofxNDIkernelResult> &kernels, const char* kernel, const char* variant)
+{
+	for (ofxNDIkernelResult &result : kernels) {
+		if (result.kernel == kernel && result.variant == variant)
+			return result;
+	}
+	ofxNDIkernelResult result;
+	result.kernel = kernel;
+	result.variant = variant;
+	kernels.push_back(result);
+	return kernels.back();
+}
+
+// Record a comparison and report the first failure
+static void BenchCheck(ofxNDIkernelResult &result, bool bEqual,
+	unsigned int width, unsigned int height, size_t offset, unsigned int pitch, bool bInvert)
+{
+	result.cases++;
+	if (!bEqual) {
+		if (result.failed == 0)
+			printf("ofxNDIbenchmark::RunKernels - %s (%s) differs %ux%u offset %d pitch %u invert %d\n",
+				result.kernel.c_str(), result.variant.c_str(), width, height, (int)offset, pitch, (int)bInvert);
+		result.failed++;
+	}
+}
+
+// Best time of repeated calls
+// - bytes | read and written by one call
+// - units | pixels or audio samples of one call
+static void BenchTime(ofxNDIkernelResult &result, double bytes, double units, const std::function<void()> &kernel)
+{
+	double best = 0.0;
+	uint64_t bestCycles = 0;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < 200; i++) {
+		const uint64_t c0 = BenchCycles();
+		const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		kernel();
+		const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+		const uint64_t c1 = BenchCycles();
+		const double seconds = std::chrono::duration<double>(t1 - t0).count();
+		if (i == 0 || seconds < best) {
+			best = seconds;
+			bestCycles = c1 - c0;
+		}
+		if (i >= 4 && t1 - start > std::chrono::milliseconds(250))
+			break;
+	}
+	if (best > 0.0)
+		result.gbps = bytes/best/1.0e9;
+	result.cycles = (bestCycles > 0 && units > 0.0) ? (double)bestCycles/units : -1.0;
+	result.bTimed = true;
+}
+
+// Each stream has a sender and a receiver
+struct benchStream {
+	ofxNDIsend sender;
+	ofxNDIreceive receiver;
+	std::vector<unsigned char> pixels;
+	std::vector<double> latency; // msec
+	int64_t sent = 0;
+	int64_t received = 0;
+	double sendCpu = 0.0; // msec
+	double receiveTime = 0.0; // msec
+	std::chrono::steady_clock::time_point last;
+};
+
+
+ofxNDIbenchmark::ofxNDIbenchmark()
+{
+	m_frames = 300;
+	m_fps = 60;
+}
+
+ofxNDIbenchmark::~ofxNDIbenchmark()
+{
+
+}
+
+// Frames sent by each stream for each case
+void ofxNDIbenchmark::SetFrames(int frames)
+{
+	m_frames = std::max(frames, 1);
+}
+
+// Frame rate of clocked senders
+void ofxNDIbenchmark::SetFrameRate(int fps)
+{
+	m_fps = std::max(fps, 1);
+}
+
+// Add a case to run
+void ofxNDIbenchmark::AddCase(unsigned int width, unsigned int height,
+	NDIlib_FourCC_video_type_e format, bool bClocked, int streams)
+{
+	ofxNDIbenchmarkCase test;
+	test.width = width;
+	test.height = height;
+	test.format = format;
+	test.bClocked = bClocked;
+	test.streams = std::max(streams, 1);
+	m_cases.push_back(test);
+}
+
+// Add the default cases
+void ofxNDIbenchmark::AddDefaultCases()
+{
+	const unsigned int sizes[4][2] = { { 1280, 720 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 } };
+	const NDIlib_FourCC_video_type_e formats[4] = {
+		NDIlib_FourCC_video_type_RGBA, NDIlib_FourCC_video_type_BGRA,
+		NDIlib_FourCC_video_type_UYVY, NDIlib_FourCC_video_type_NV12 };
+
+	for (int c = 0; c < 2; c++) {
+		for (int s = 0; s < 4; s++) {
+			for (int f = 0; f < 4; f++)
+				AddCase(sizes[s][0], sizes[s][1], formats[f], c == 0, 1);
+		}
+	}
+
+	for (int streams = 2; streams <= 32; streams *= 2)
+		AddCase(1920, 1080, NDIlib_FourCC_video_type_RGBA, false, streams);
+}
+
+// Run all cases
+bool ofxNDIbenchmark::Run()
+{
+	if (m_cases.empty()) {
+		printf("ofxNDIbenchmark::Run - no cases\n");
+		return false;
+	}
+
+	m_results.clear();
+
+	printf("ofxNDIbenchmark - %d cases, %d frames per stream\n", (int)m_cases.size(), m_frames);
+	printf("  size       format  mode     streams      fps   p50 ms   p99 ms p99.9 ms  send ms  recv ms  allocs\n");
+	for (size_t i = 0; i < m_cases.size(); i++) {
+		ofxNDIbenchmarkResult result = RunCase(m_cases[i]);
+		m_results.push_back(result);
+		printf("  %4ux%-4u  %-6s  %-7s  %7d  %7.1f  %7.2f  %7.2f  %7.2f  %7.3f  %7.3f  %6.1f\n",
+			result.test.width, result.test.height, BenchFormatName(result.test.format),
+			result.test.bClocked ? "clocked" : "async", result.test.streams,
+			result.fps, result.latencyP50, result.latencyP99, result.latencyP999,
+			result.sendCpu, result.receiveTime, result.allocations);
+		if (result.received == 0) {
+			printf("ofxNDIbenchmark::Run - no frames received\n");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Run one case
+ofxNDIbenchmarkResult ofxNDIbenchmark::RunCase(const ofxNDIbenchmarkCase &test)
+{
+	ofxNDIbenchmarkResult result;
+	result.test = test;
+
+	const int nStreams = std::max(test.streams, 1);
+	std::vector<std::unique_ptr<benchStream>> streams;
+
+	// Senders
+	for (int i = 0; i < nStreams; i++) {
+		std::unique_ptr<benchStream> stream(new benchStream);
+		stream->pixels.resize(BenchFrameSize(test.width, test.height, test.format));
+		for (size_t j = 0; j < stream->pixels.size(); j++)
+			stream->pixels[j] = (unsigned char)(j*7 + i);
+		stream->sender.SetFormat(test.format);
+		if (test.bClocked) {
+			stream->sender.SetAsync(false);
+			stream->sender.SetClockVideo(true);
+			stream->sender.SetFrameRate(m_fps);
+		}
+		else {
+			stream->sender.SetAsync(true); // disables clocked video
+		}
+		std::string name = "ofxNDIbenchmark " + std::to_string(i);
+		if (!stream->sender.CreateSender(name.c_str(), test.width, test.height)) {
+			printf("ofxNDIbenchmark::RunCase - could not create sender [%s]\n", name.c_str());
+			return result;
+		}
+		if (m_runtime.empty())
+			m_runtime = stream->sender.GetNDIversion();
+		streams.push_back(std::move(stream));
+	}
+
+	// Receivers connect by name to their sender
+	for (int i = 0; i < nStreams; i++) {
+		benchStream* stream = streams[i].get();
+		stream->receiver.SetSenderName(stream->sender.GetNDIname());
+		stream->receiver.FindSenders();
+		stream->receiver.CreateReceiver(NDIlib_recv_color_format_fastest);
+		stream->latency.reserve((size_t)m_frames);
+	}
+
+#ifdef OFXNDI_BENCHMARK_ALLOCATIONS
+	const int64_t allocations = benchAllocations.load();
+#endif
+
+	std::atomic<int> sending(nStreams);
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < nStreams; i++) {
+		benchStream* stream = streams[i].get();
+		stream->last = start;
+
+		// Receive until the sender has finished and no frame
+		// has arrived for 250 msec. Frames received are not copied.
+		threads.push_back(std::thread([stream, &sending] {
+			ofxNDIutils::TraceThreadName("ofxNDIbenchmark receive");
+			std::chrono::steady_clock::time_point idle = stream->last;
+			bool bIdle = false;
+			while (true) {
+				unsigned int width = 0;
+				unsigned int height = 0;
+				const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+				if (stream->receiver.ReceiveImage(width, height)) {
+					const int64_t now = BenchNow100ns();
+					stream->receiver.FreeVideoData();
+					const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+					stream->receiveTime += std::chrono::duration<double, std::milli>(t1 - t0).count();
+					stream->latency.push_back((double)(now - stream->receiver.GetVideoTimestamp())/10000.0);
+					stream->received++;
+					stream->last = t1;
+				}
+				else {
+					if (sending.load() == 0) {
+						const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+						if (!bIdle) {
+							idle = std::max(now, stream->last);
+							bIdle = true;
+						}
+						if (now - std::max(idle, stream->last) > std::chrono::milliseconds(250))
+							break;
+					}
+					std::this_thread::yield();
+				}
+			}
+		}));
+
+		threads.push_back(std::thread([this, stream, &test, &sending] {
+			ofxNDIutils::TraceThreadName("ofxNDIbenchmark send");
+			const double cpu = BenchThreadCpu();
+			for (int f = 0; f < m_frames; f++) {
+				if (stream->sender.SendImage(stream->pixels.data(), test.width, test.height, false, false))
+					stream->sent++;
+			}
+			stream->sendCpu = BenchThreadCpu() - cpu;
+			sending--;
+		}));
+	}
+
+	for (std::thread &t : threads)
+		t.join();
+
+	// Collect results
+	std::vector<double> latency;
+	double sendCpu = 0.0;
+	double receiveTime = 0.0;
+	std::chrono::steady_clock::time_point last = start;
+	for (int i = 0; i < nStreams; i++) {
+		benchStream* stream = streams[i].get();
+		result.sent += stream->sent;
+		result.received += stream->received;
+		sendCpu += stream->sendCpu;
+		receiveTime += stream->receiveTime;
+		latency.insert(latency.end(), stream->latency.begin(), stream->latency.end());
+		if (stream->received > 0 && stream->last > last)
+			last = stream->last;
+	}
+
+#ifdef OFXNDI_BENCHMARK_ALLOCATIONS
+	if (result.sent > 0)
+		result.allocations = (double)(benchAllocations.load() - allocations)/(double)result.sent;
+#endif
+
+	result.dropped = result.sent - result.received;
+	result.seconds = std::chrono::duration<double>(last - start).count();
+	if (result.seconds > 0.0)
+		result.fps = (double)result.received/(double)nStreams/result.seconds;
+	if (result.sent > 0)
+		result.sendCpu = sendCpu/(double)result.sent;
+	if (result.received > 0)
+		result.receiveTime = receiveTime/(double)result.received;
+
+	std::sort(latency.begin(), latency.end());
+	result.latencyP50  = BenchPercentile(latency, 0.5);
+	result.latencyP99  = BenchPercentile(latency, 0.99);
+	result.latencyP999 = BenchPercentile(latency, 0.999);
+	result.latencyMax  = latency.empty() ? 0.0 : latency.back();
+
+	// Receivers before senders
+	for (int i = 0; i < nStreams; i++)
+		streams[i]->receiver.ReleaseReceiver();
+	for (int i = 0; i < nStreams; i++)
+		streams[i]->sender.ReleaseSender();
+
+	return result;
+}
+
+// Results of the cases run
+std::vector<ofxNDIbenchmarkResult> ofxNDIbenchmark::GetResults()
+{
+	return m_results;
+}
+
+// Compare ofxNDIutils kernels with scalar references and time them
+bool ofxNDIbenchmark::RunKernels()
+{
+	m_kernels.clear();
+
+	// Odd widths and heights and sizes large enough for the SSE2 paths
+	const unsigned int sizes[10][2] = {
+		{ 1, 1 }, { 3, 2 }, { 15, 7 }, { 17, 5 }, { 33, 9 },
+		{ 127, 31 }, { 514, 258 }, { 513, 513 }, { 1283, 517 }, { 1920, 1080 } };
+	// Offsets from 64 byte alignment
+	const size_t offsets[4] = { 0, 1, 4, 8 };
+
+	benchBuffer src, dst, ref;
+
+	for (int s = 0; s < 10; s++) {
+		const unsigned int w = sizes[s][0];
+		const unsigned int h = sizes[s][1];
+		const size_t rgba = (size_t)w*(size_t)h*4;
+
+		for (int o = 0; o < 4; o++) {
+			const size_t offset = offsets[o];
+
+			for (int inv = 0; inv < 2; inv++) {
+				const bool bInvert = (inv == 1);
+
+				src.Create(rgba, offset, 0);
+				src.Random(w*31 + h);
+
+				// CopyImage same size
+				dst.Create(rgba, offset, 0xCD);
+				ref.Create(rgba, offset, 0xCD);
+				ofxNDIutils::CopyImage(src.p, dst.p, w, h, bInvert);
+				RefCopyRows(src.p, ref.p, w*4, h, w*4, w*4, bInvert);
+				BenchCheck(BenchKernel(m_kernels, "CopyImage", "dispatch"), dst.Equal(ref), w, h, offset, w*4, bInvert);
+				dst.Create(rgba, offset, 0xCD);
+				BenchCopyRows(src.p, dst.p, w, h, bInvert);
+				BenchCheck(BenchKernel(m_kernels, "CopyImage", "scalar"), dst.Equal(ref), w, h, offset, w*4, bInvert);
+
+				// CopyImage with rgba<>bgra
+				dst.Create(rgba, offset, 0xCD);
+				ofxNDIutils::CopyImage(src.p, dst.p, w, h, w*4, true, bInvert);
+				ref.Create(rgba, offset, 0xCD);
+				RefSwapRB(src.p, ref.p, w, h, bInvert);
+				BenchCheck(BenchKernel(m_kernels, "CopyImage swap", "dispatch"), dst.Equal(ref), w, h, offset, w*4, bInvert);
+
+				dst.Create(rgba, offset, 0xCD);
+				ofxNDIutils::rgba_bgra(src.p, dst.p, w, h, bInvert);
+				BenchCheck(BenchKernel(m_kernels, "rgba_bgra", "scalar"), dst.Equal(ref), w, h, offset, w*4, bInvert);
+
+#if defined(OFXNDI_SIMD)
+				dst.Create(rgba, offset, 0xCD);
+				ofxNDIutils::rgba_bgra_sse2(src.p, dst.p, w, h, bInvert);
+				BenchCheck(BenchKernel(m_kernels, "rgba_bgra", "sse2"), dst.Equal(ref), w, h, offset, w*4, bInvert);
+#endif
+
+				// FlipBuffer
+				if (bInvert) {
+					dst.Create(rgba, offset, 0xCD);
+					ref.Create(rgba, offset, 0xCD);
+					ofxNDIutils::FlipBuffer(src.p, dst.p, w, h);
+					RefCopyRows(src.p, ref.p, w*4, h, w*4, w*4, true);
+					BenchCheck(BenchKernel(m_kernels, "FlipBuffer", "dispatch"), dst.Equal(ref), w, h, offset, w*4, true);
+					dst.Create(rgba, offset, 0xCD);
+					BenchCopyRows(src.p, dst.p, w, h, true);
+					BenchCheck(BenchKernel(m_kernels, "FlipBuffer", "scalar"), dst.Equal(ref), w, h, offset, w*4, true);
+				}
+
+				// CopyImage line by line with source and dest pitch
+				// not a multiple of 16 or of 4
+				const unsigned int pads[3] = { 4, 12, 3 };
+				for (int p = 0; p < 3; p++) {
+					const unsigned int srcPitch = w*4 + pads[p];
+					const unsigned int dstPitch = w*4 + pads[2 - p];
+					benchBuffer psrc;
+					psrc.Create((size_t)srcPitch*h, offset, 0);
+					psrc.Random(w + h*17);
+					dst.Create((size_t)dstPitch*h, offset, 0xCD);
+					ref.Create((size_t)dstPitch*h, offset, 0xCD);
+					ofxNDIutils::CopyImage((const void*)psrc.p, (void*)dst.p, w, h, srcPitch, dstPitch, bInvert);
+					RefCopyRows(psrc.p, ref.p, w*4, h, srcPitch, dstPitch, bInvert);
+					BenchCheck(BenchKernel(m_kernels, "CopyImage pitch", "dispatch"), dst.Equal(ref), w, h, offset, srcPitch, bInvert);
+				}
+
+				// rgb2rgba
+				benchBuffer rgb;
+				rgb.Create((size_t)w*h*3, offset, 0);
+				rgb.Random(w*h);
+				dst.Create(rgba, offset, 0xCD);
+				ref.Create(rgba, offset, 0xCD);
+				ofxNDIutils::rgb2rgba(rgb.p, dst.p, w, h, bInvert);
+				RefRgb2Rgba(rgb.p, ref.p, w, h, bInvert);
+				BenchCheck(BenchKernel(m_kernels, "rgb2rgba", "scalar"), dst.Equal(ref), w, h, offset, w*3, bInvert);
+			}
+
+			// CopyImage with a stride that is not a multiple of 4
+			src.Create((size_t)(w*4 + 3)*h, offset, 0);
+			src.Random(w*5 + h);
+			dst.Create(src.size, offset, 0xCD);
+			ref.Create(src.size, offset, 0xCD);
+			ofxNDIutils::CopyImage(src.p, dst.p, w, h, w*4 + 3, false, false);
+			RefCopyRows(src.p, ref.p, (unsigned int)src.size, 1, 0, 0, false);
+			BenchCheck(BenchKernel(m_kernels, "CopyImage", "dispatch"), dst.Equal(ref), w, h, offset, w*4 + 3, false);
+
+			// memcpy with remaining bytes after the last block
+			const size_t tails[3] = { 0, 3, 127 };
+			for (int t = 0; t < 3; t++) {
+				const size_t bytes = rgba + tails[t];
+				src.Create(bytes, offset, 0);
+				src.Random((uint32_t)bytes);
+				ref.Create(bytes, offset, 0xCD);
+				RefCopyRows(src.p, ref.p, (unsigned int)bytes, 1, 0, 0, false);
+				dst.Create(bytes, offset, 0xCD);
+				memcpy(dst.p, src.p, bytes);
+				BenchCheck(BenchKernel(m_kernels, "memcpy", "scalar"), dst.Equal(ref), w, h, offset, (unsigned int)bytes, false);
+#if defined(OFXNDI_SIMD)
+				dst.Create(bytes, offset, 0xCD);
+				ofxNDIutils::memcpy_sse2(dst.p, src.p, bytes);
+				BenchCheck(BenchKernel(m_kernels, "memcpy", "sse2"), dst.Equal(ref), w, h, offset, (unsigned int)bytes, false);
+				dst.Create(bytes, offset, 0xCD);
+				ofxNDIutils::memcpy_movsd(dst.p, src.p, bytes);
+				BenchCheck(BenchKernel(m_kernels, "memcpy", "movsd"), dst.Equal(ref), w, h, offset, (unsigned int)bytes, false);
+#endif
+			}
+
+			// YUV422_to_RGBA requires an even width
+			if (w >= 2) {
+				const unsigned int ew = w & ~1u;
+				const unsigned int strides[2] = { 0, ew*2 + 12 };
+				for (int st = 0; st < 2; st++) {
+					const unsigned int stride = strides[st];
+					src.Create((size_t)(stride ? stride : ew*2)*h, offset, 0);
+					src.Random(ew + h*3);
+					dst.Create((size_t)ew*h*4, offset, 0xCD);
+					ref.Create((size_t)ew*h*4, offset, 0xCD);
+					ofxNDIutils::YUV422_to_RGBA(src.p, dst.p, ew, h, stride);
+					RefYUV422(src.p, ref.p, ew, h, stride);
+					BenchCheck(BenchKernel(m_kernels, "YUV422_to_RGBA", "scalar"), dst.Equal(ref), ew, h, offset, stride, false);
+				}
+			}
+
+			// HashBuffer must not depend on alignment and must change
+			// if one byte changes. The SSE2 result must equal the scalar one.
+			const size_t hashTails[3] = { 0, 5, 63 };
+			for (int t = 0; t < 3; t++) {
+				const size_t bytes = rgba + hashTails[t];
+				src.Create(bytes, offset, 0);
+				src.Random((uint32_t)bytes + 7);
+				ref.Create(bytes, 0, 0);
+				memcpy(ref.p, src.p, bytes);
+				const uint64_t hash = ofxNDIutils::hash64(src.p, bytes);
+				bool bEqual = (hash == ofxNDIutils::hash64(ref.p, bytes));
+				if (bytes > 0) {
+					ref.p[bytes/2] ^= 0x01;
+					if (ofxNDIutils::hash64(ref.p, bytes) == hash)
+						bEqual = false;
+				}
+				BenchCheck(BenchKernel(m_kernels, "HashBuffer", "scalar"), bEqual, w, h, offset, (unsigned int)bytes, false);
+#if defined(OFXNDI_SIMD)
+				BenchCheck(BenchKernel(m_kernels, "HashBuffer", "sse2"), ofxNDIutils::hash64_sse2(src.p, bytes) == hash,
+					w, h, offset, (unsigned int)bytes, false);
+#endif
+			}
+
+			// DirtyTiles must find the tiles with changed bytes
+			// and copy them to the previous image
+			const unsigned int pitch = w*4 + 12;
+			src.Create((size_t)pitch*h, offset, 0);
+			src.Random(w*7 + h);
+			dst.Create(rgba, offset, 0);
+			for (unsigned int y = 0; y < h; y++)
+				memcpy(dst.p + (size_t)y*w*4, src.p + (size_t)y*pitch, w*4);
+			dst.p[rgba/2] ^= 0x10; // middle
+			dst.p[rgba - 1] ^= 0x01; // last byte
+			if (w > 64)
+				dst.p[(size_t)(h - 1)*w*4 + 256] ^= 0x80; // first byte of the second tile of the last row
+			std::vector<unsigned char> dirty, refdirty;
+			const unsigned int refchanged = RefDirtyTiles(src.p, dst.p, w, h, pitch, refdirty);
+			const unsigned int changed = ofxNDIutils::DirtyTiles(src.p, dst.p, w*4, h, pitch, 256, 64, dirty);
+			bool bEqual = (changed == refchanged && dirty == refdirty);
+			for (unsigned int y = 0; bEqual && y < h; y++)
+				bEqual = (memcmp(dst.p + (size_t)y*w*4, src.p + (size_t)y*pitch, w*4) == 0);
+			BenchCheck(BenchKernel(m_kernels, "DirtyTiles", "dispatch"), bEqual, w, h, offset, pitch, false);
+
+			// memequal with a difference at each position of the last block
+			for (size_t t = 0; t < 3; t++) {
+				const size_t bytes = rgba + t*7;
+				src.Create(bytes, offset, 0);
+				src.Random((uint32_t)bytes);
+				ref.Create(bytes, 0, 0);
+				memcpy(ref.p, src.p, bytes);
+				const size_t first = (bytes > 80) ? bytes - 80 : 0;
+				bEqual = ofxNDIutils::memequal(src.p, ref.p, bytes);
+				for (size_t i = first; bEqual && i < bytes; i++) {
+					ref.p[i] ^= 0x01;
+					if (ofxNDIutils::memequal(src.p, ref.p, bytes))
+						bEqual = false;
+					ref.p[i] ^= 0x01;
+				}
+				BenchCheck(BenchKernel(m_kernels, "memequal", "scalar"), bEqual, w, h, offset, (unsigned int)bytes, false);
+#if defined(OFXNDI_SIMD)
+				bEqual = ofxNDIutils::memequal_sse2(src.p, ref.p, bytes);
+				for (size_t i = first; bEqual && i < bytes; i++) {
+					ref.p[i] ^= 0x01;
+					if (ofxNDIutils::memequal_sse2(src.p, ref.p, bytes))
+						bEqual = false;
+					ref.p[i] ^= 0x01;
+				}
+				BenchCheck(BenchKernel(m_kernels, "memequal", "sse2"), bEqual, w, h, offset, (unsigned int)bytes, false);
+#endif
+			}
+		}
+	}
+
+	// Audio conversion
+	// The scalar functions must be the same as one sample at a time
+	// and each other variant the same as the scalar function.
+	// Dithered 16 bit audio must be within 1 of the audio without dither.
+	{
+		const int achannels[7] = { 1, 2, 3, 4, 6, 16, 64 };
+		const int asamples[4] = { 1, 7, 1601, 1602 };
+		for (int c = 0; c < 7; c++) {
+			for (int n = 0; n < 4; n++) {
+				const int nc = achannels[c];
+				const int ns = asamples[n];
+				const int stride = ns + 3; // planar channels not contiguous
+				const size_t size = (size_t)nc*ns;
+				std::vector<float> interleaved(size), planar((size_t)nc*stride, -9.0f);
+				std::vector<float> refplanar((size_t)nc*stride, -9.0f), back(size), refback(size);
+				uint32_t seed = (uint32_t)(nc*7919 + ns);
+				for (size_t i = 0; i < size; i++) {
+					seed = seed*1664525u + 1013904223u;
+					interleaved[i] = ((float)(seed >> 8)/8388608.0f - 1.0f)*1.25f; // includes values to clip
+				}
+
+				ofxNDIutils::interleaved_planar(interleaved.data(), refplanar.data(), nc, ns, stride);
+				bool bEqual = true;
+				for (int ch = 0; ch < nc; ch++) {
+					for (int i = 0; i < ns; i++) {
+						if (refplanar[(size_t)ch*stride + i] != interleaved[(size_t)i*nc + ch])
+							bEqual = false;
+					}
+				}
+				BenchCheck(BenchKernel(m_kernels, "InterleavedToPlanar", "scalar"), bEqual, nc, ns, 0, stride, false);
+				ofxNDIutils::planar_interleaved(refplanar.data(), refback.data(), nc, ns, stride);
+				BenchCheck(BenchKernel(m_kernels, "PlanarToInterleaved", "scalar"), refback == interleaved, nc, ns, 0, stride, false);
+				ofxNDIutils::InterleavedToPlanar(interleaved.data(), planar.data(), nc, ns, stride);
+				BenchCheck(BenchKernel(m_kernels, "InterleavedToPlanar", "dispatch"), planar == refplanar, nc, ns, 0, stride, false);
+				ofxNDIutils::PlanarToInterleaved(refplanar.data(), back.data(), nc, ns, stride);
+				BenchCheck(BenchKernel(m_kernels, "PlanarToInterleaved", "dispatch"), back == refback, nc, ns, 0, stride, false);
+#if defined(OFXNDI_SIMD)
+				std::fill(planar.begin(), planar.end(), -9.0f);
+				ofxNDIutils::interleaved_planar_sse2(interleaved.data(), planar.data(), nc, ns, stride);
+				BenchCheck(BenchKernel(m_kernels, "InterleavedToPlanar", "sse2"), planar == refplanar, nc, ns, 0, stride, false);
+				std::fill(back.begin(), back.end(), -9.0f);
+				ofxNDIutils::planar_interleaved_sse2(refplanar.data(), back.data(), nc, ns, stride);
+				BenchCheck(BenchKernel(m_kernels, "PlanarToInterleaved", "sse2"), back == refback, nc, ns, 0, stride, false);
+#endif
+
+				// Sample formats of all the samples
+				std::vector<int16_t> s16(size), refs16(size);
+				std::vector<int32_t> s32(size), refs32(size);
+				std::vector<float> f(size), reff(size);
+				const float gain = 0.8f;
+				ofxNDIutils::float_int16(interleaved.data(), refs16.data(), size, gain, false);
+				bEqual = true;
+				for (size_t i = 0; i < size; i++) {
+					const float x = std::min(std::max(interleaved[i]*(gain*32768.0f), -32768.0f), 32767.0f);
+					if (refs16[i] != (int16_t)std::lrint(x))
+						bEqual = false;
+				}
+				BenchCheck(BenchKernel(m_kernels, "FloatToInt16", "scalar"), bEqual, nc, ns, 0, 0, false);
+				ofxNDIutils::FloatToInt16(interleaved.data(), s16.data(), size, gain, false);
+				BenchCheck(BenchKernel(m_kernels, "FloatToInt16", "dispatch"), s16 == refs16, nc, ns, 0, 0, false);
+				ofxNDIutils::FloatToInt16(interleaved.data(), s16.data(), size, gain, true);
+				bEqual = true;
+				for (size_t i = 0; i < size; i++) {
+					if (std::abs((int)s16[i] - (int)refs16[i]) > 1)
+						bEqual = false;
+				}
+				BenchCheck(BenchKernel(m_kernels, "FloatToInt16 dither", "dispatch"), bEqual, nc, ns, 0, 0, false);
+				ofxNDIutils::float_int32(interleaved.data(), refs32.data(), size, gain);
+				bEqual = true;
+				for (size_t i = 0; i < size; i++) {
+					const float x = std::min(std::max(interleaved[i]*(gain*2147483648.0f), -2147483648.0f), 2147483520.0f);
+					if (refs32[i] != (int32_t)std::lrint(x))
+						bEqual = false;
+				}
+				BenchCheck(BenchKernel(m_kernels, "FloatToInt32", "scalar"), bEqual, nc, ns, 0, 0, false);
+				ofxNDIutils::FloatToInt32(interleaved.data(), s32.data(), size, gain);
+				BenchCheck(BenchKernel(m_kernels, "FloatToInt32", "dispatch"), s32 == refs32, nc, ns, 0, 0, false);
+				ofxNDIutils::int16_float(refs16.data(), reff.data(), size, 1.0f/gain);
+				bEqual = true;
+				for (size_t i = 0; i < size; i++) {
+					if (reff[i] != (float)refs16[i]*((1.0f/gain)/32768.0f))
+						bEqual = false;
+				}
+				BenchCheck(BenchKernel(m_kernels, "Int16ToFloat", "scalar"), bEqual, nc, ns, 0, 0, false);
+				ofxNDIutils::Int16ToFloat(refs16.data(), f.data(), size, 1.0f/gain);
+				BenchCheck(BenchKernel(m_kernels, "Int16ToFloat", "dispatch"), f == reff, nc, ns, 0, 0, false);
+				ofxNDIutils::int32_float(refs32.data(), reff.data(), size, 1.0f/gain);
+				bEqual = true;
+				for (size_t i = 0; i < size; i++) {
+					if (reff[i] != (float)refs32[i]*((1.0f/gain)/2147483648.0f))
+						bEqual = false;
+				}
+				BenchCheck(BenchKernel(m_kernels, "Int32ToFloat", "scalar"), bEqual, nc, ns, 0, 0, false);
+				ofxNDIutils::Int32ToFloat(refs32.data(), f.data(), size, 1.0f/gain);
+				BenchCheck(BenchKernel(m_kernels, "Int32ToFloat", "dispatch"), f == reff, nc, ns, 0, 0, false);
+				ofxNDIutils::audio_gain(interleaved.data(), reff.data(), size, gain);
+				bEqual = true;
+				for (size_t i = 0; i < size; i++) {
+					if (reff[i] != interleaved[i]*gain)
+						bEqual = false;
+				}
+				BenchCheck(BenchKernel(m_kernels, "AudioGain", "scalar"), bEqual, nc, ns, 0, 0, false);
+				f = interleaved;
+				ofxNDIutils::AudioGain(f.data(), f.data(), size, gain); // in place
+				BenchCheck(BenchKernel(m_kernels, "AudioGain", "dispatch"), f == reff, nc, ns, 0, 0, false);
+#if defined(OFXNDI_SIMD)
+				ofxNDIutils::float_int16_sse2(interleaved.data(), s16.data(), size, gain, false);
+				BenchCheck(BenchKernel(m_kernels, "FloatToInt16", "sse2"), s16 == refs16, nc, ns, 0, 0, false);
+				ofxNDIutils::float_int32_sse2(interleaved.data(), s32.data(), size, gain);
+				BenchCheck(BenchKernel(m_kernels, "FloatToInt32", "sse2"), s32 == refs32, nc, ns, 0, 0, false);
+				ofxNDIutils::int16_float(refs16.data(), reff.data(), size, 1.0f/gain);
+				ofxNDIutils::int16_float_sse2(refs16.data(), f.data(), size, 1.0f/gain);
+				BenchCheck(BenchKernel(m_kernels, "Int16ToFloat", "sse2"), f == reff, nc, ns, 0, 0, false);
+				ofxNDIutils::int32_float(refs32.data(), reff.data(), size, 1.0f/gain);
+				ofxNDIutils::int32_float_sse2(refs32.data(), f.data(), size, 1.0f/gain);
+				BenchCheck(BenchKernel(m_kernels, "Int32ToFloat", "sse2"), f == reff, nc, ns, 0, 0, false);
+				ofxNDIutils::audio_gain(interleaved.data(), reff.data(), size, gain);
+				ofxNDIutils::audio_gain_sse2(interleaved.data(), f.data(), size, gain);
+				BenchCheck(BenchKernel(m_kernels, "AudioGain", "sse2"), f == reff, nc, ns, 0, 0, false);
+#endif
+			}
+		}
+	}
+
+	// ofxNDIresampler - a sine through the FIFO must have the same amplitude
+	// and a noise level for the quality. The FIFO is filled to the latency
+	// before each block so that there is no drift correction.
+	const double snrMin[4] = { 55.0, 70.0, 80.0, 85.0 }; // dB
+	const int rateIn[3] = { 44100, 48000, 96000 };
+	for (int q = 0; q < 4; q++) {
+		for (int r = 0; r < 3; r++) {
+			const int rateOut = (rateIn[r] == 44100) ? 48000 : 44100;
+			const double nominal = (double)rateIn[r]/(double)rateOut;
+			const double f = 997.0;
+			ofxNDIfifo fifo;
+			fifo.Allocate(2, 16384);
+			ofxNDIresampler resampler;
+			resampler.Setup(2, rateOut, q);
+			resampler.SetLatency(20.0);
+			std::vector<float> in(2*4096), out((size_t)rateOut*2);
+			int64_t written = 0;
+			for (int done = 0; done < rateOut; ) {
+				const int block = (rateOut - done < 512) ? rateOut - done : 512;
+				// 20 msec is a whole number of samples at these rates
+				const int n = rateIn[r]/50 - fifo.GetAvailable();
+				for (int i = 0; i < n; i++) {
+					const double t = (double)(written + i)/(double)rateIn[r];
+					in[i] = (float)(0.5*std::sin(2.0*3.14159265358979323846*f*t));
+					in[4096 + i] = -in[i];
+				}
+				fifo.Write(in.data(), 4096, n, 2, rateIn[r]);
+				written += n;
+				resampler.Process(fifo, out.data() + done, block, 2, rateOut);
+				done += block;
+			}
+			// Fit a sine at the output frequency to the second half
+			const double fo = f*resampler.GetRatio()/nominal;
+			const int start = rateOut/2;
+			const int count = rateOut - start;
+			double s = 0.0, c = 0.0;
+			for (int i = 0; i < count; i++) {
+				const double a = 2.0*3.14159265358979323846*fo*(double)i/(double)rateOut;
+				s += (double)out[start + i]*std::sin(a);
+				c += (double)out[start + i]*std::cos(a);
+			}
+			s *= 2.0/(double)count;
+			c *= 2.0/(double)count;
+			double noise = 0.0, signal = 0.0;
+			bool bEqual = true;
+			for (int i = 0; i < count; i++) {
+				const double a = 2.0*3.14159265358979323846*fo*(double)i/(double)rateOut;
+				const double ref = s*std::sin(a) + c*std::cos(a);
+				noise += ((double)out[start + i] - ref)*((double)out[start + i] - ref);
+				signal += ref*ref;
+				if (out[rateOut + start + i] != -out[start + i])
+					bEqual = false;
+			}
+			const double amplitude = std::sqrt(s*s + c*c);
+			const double snr = (noise > 0.0) ? 10.0*std::log10(signal/noise) : 200.0;
+			if (std::fabs(amplitude - 0.5) > 0.0025 || snr < snrMin[q])
+				bEqual = false;
+			BenchCheck(BenchKernel(m_kernels, "ofxNDIresampler", "dispatch"), bEqual, rateIn[r], rateOut, 0, resampler.GetTaps(), false);
+		}
+	}
+
+#ifdef USE_CHRONO
+	// InterleavedToPlanar returning a vector
+	const int channels[3] = { 1, 2, 6 };
+	const int samples[4] = { 1, 3, 1601, 1602 };
+	for (int c = 0; c < 3; c++) {
+		for (int n = 0; n < 4; n++) {
+			std::vector<float> interleaved((size_t)channels[c]*samples[n]);
+			for (size_t i = 0; i < interleaved.size(); i++)
+				interleaved[i] = (float)i*0.25f - 3.0f;
+			std::vector<float> planar = ofxNDIutils::InterleavedToPlanar(interleaved.data(), channels[c], samples[n]);
+			bool bEqual = (planar.size() == interleaved.size());
+			for (int ch = 0; bEqual && ch < channels[c]; ch++) {
+				for (int i = 0; i < samples[n]; i++) {
+					if (planar[(size_t)ch*samples[n] + i] != interleaved[(size_t)i*channels[c] + ch]) {
+						bEqual = false;
+						break;
+					}
+				}
+			}
+			BenchCheck(BenchKernel(m_kernels, "InterleavedToPlanar vector", "dispatch"), bEqual, channels[c], samples[n], 0, 0, false);
+		}
+	}
+
+	// AudioFrameSequence values must be the nearest integers
+	// either side of the ideal samples per frame for the
+	// expected N/D and the sequence sum that of the first frames.
+	// Whole number rates must not be taken as 1000/1001 rates.
+	const int rates[3] = { 44100, 48000, 96000 };
+	const double fps[10] = { 23.976, 24.0, 25.0, 29.97, 30.0, 50.0, 59.94, 60.0, 10.0, 5.0 };
+	const int fpsND[10][2] = { { 24000, 1001 }, { 24, 1 }, { 25, 1 }, { 30000, 1001 },
+		{ 30, 1 }, { 50, 1 }, { 60000, 1001 }, { 60, 1 }, { 10, 1 }, { 5, 1 } };
+	for (int r = 0; r < 3; r++) {
+		for (int f = 0; f < 10; f++) {
+			int maxSample = 0;
+			std::vector<int> sequence = ofxNDIutils::AudioFrameSequence(rates[r], fps[f], maxSample);
+			const int64_t N = fpsND[f][0];
+			const int64_t D = fpsND[f][1];
+			const int lower = (int)((int64_t)rates[r]*D/N);
+			bool bEqual = !sequence.empty();
+			int64_t sum = 0;
+			for (int n : sequence) {
+				if (n != lower && n != lower + 1)
+					bEqual = false;
+				sum += n;
+			}
+			if (bEqual && (maxSample != *std::max_element(sequence.begin(), sequence.end())
+				|| sum != (int64_t)sequence.size()*rates[r]*D/N))
+				bEqual = false;
+			BenchCheck(BenchKernel(m_kernels, "AudioFrameSequence", "scalar"), bEqual, rates[r], (unsigned int)(fps[f]*1000.0), 0, 0, false);
+		}
+	}
+#endif
+
+	// ofxNDIcadence - the samples of the first k frames must be
+	// exactly floor(k x rate x D / N) for a day of frames
+	const int cadenceRates[4] = { 44100, 48000, 96000, 32000 };
+	const int cadenceFps[8][2] = { { 24000, 1001 }, { 24, 1 }, { 25, 1 }, { 30000, 1001 },
+		{ 30, 1 }, { 50, 1 }, { 60000, 1001 }, { 60, 1 } };
+	for (int r = 0; r < 4; r++) {
+		for (int f = 0; f < 8; f++) {
+			const int N = cadenceFps[f][0];
+			const int D = cadenceFps[f][1];
+			ofxNDIcadence cadence;
+			bool bEqual = cadence.Set(cadenceRates[r], N, D);
+			const int64_t frames = (int64_t)N*86400/D;
+			int64_t total = 0;
+			for (int64_t k = 1; bEqual && k <= frames; k++) {
+				const int peek = cadence.Peek();
+				const int samples = cadence.Next();
+				total += samples;
+				if (samples != peek || samples < cadence.GetMinSamples() || samples > cadence.GetMaxSamples()
+					|| total != k*(int64_t)cadenceRates[r]*D/N)
+					bEqual = false;
+			}
+			if (bEqual && cadence.GetSamples() != total)
+				bEqual = false;
+			BenchCheck(BenchKernel(m_kernels, "ofxNDIcadence", "scalar"), bEqual, cadenceRates[r], (unsigned int)N, 0, (unsigned int)D, false);
+		}
+	}
+
+	//
+	// Timing at 1920x1080
+	//
+	const unsigned int w = 1920;
+	const unsigned int h = 1080;
+	const double pixels = (double)w*(double)h;
+	const double bytes = pixels*4.0*2.0; // read and write rgba
+	src.Create((size_t)w*h*4, 0, 0);
+	src.Random(1);
+	dst.Create((size_t)w*h*4, 0, 0);
+
+	BenchTime(BenchKernel(m_kernels, "CopyImage", "dispatch"), bytes, pixels,
+		[&] { ofxNDIutils::CopyImage(src.p, dst.p, w, h, false); });
+	BenchTime(BenchKernel(m_kernels, "CopyImage", "scalar"), bytes, pixels,
+		[&] { BenchCopyRows(src.p, dst.p, w, h, false); });
+	BenchTime(BenchKernel(m_kernels, "CopyImage swap", "dispatch"), bytes, pixels,
+		[&] { ofxNDIutils::CopyImage(src.p, dst.p, w, h, w*4, true, false); });
+	BenchTime(BenchKernel(m_kernels, "CopyImage pitch", "dispatch"), bytes, pixels,
+		[&] { ofxNDIutils::CopyImage((const void*)src.p, (void*)dst.p, w, h, w*4, w*4, true); });
+	BenchTime(BenchKernel(m_kernels, "FlipBuffer", "dispatch"), bytes, pixels,
+		[&] { ofxNDIutils::FlipBuffer(src.p, dst.p, w, h); });
+	BenchTime(BenchKernel(m_kernels, "FlipBuffer", "scalar"), bytes, pixels,
+		[&] { BenchCopyRows(src.p, dst.p, w, h, true); });
+	BenchTime(BenchKernel(m_kernels, "memcpy", "scalar"), bytes, pixels,
+		[&] { memcpy(dst.p, src.p, (size_t)w*h*4); });
+	BenchTime(BenchKernel(m_kernels, "rgba_bgra", "scalar"), bytes, pixels,
+		[&] { ofxNDIutils::rgba_bgra(src.p, dst.p, w, h, false); });
+#if defined(OFXNDI_SIMD)
+	BenchTime(BenchKernel(m_kernels, "rgba_bgra", "sse2"), bytes, pixels,
+		[&] { ofxNDIutils::rgba_bgra_sse2(src.p, dst.p, w, h, false); });
+	BenchTime(BenchKernel(m_kernels, "memcpy", "sse2"), bytes, pixels,
+		[&] { ofxNDIutils::memcpy_sse2(dst.p, src.p, (size_t)w*h*4); });
+	BenchTime(BenchKernel(m_kernels, "memcpy", "movsd"), bytes, pixels,
+		[&] { ofxNDIutils::memcpy_movsd(dst.p, src.p, (size_t)w*h*4); });
+#endif
+	BenchTime(BenchKernel(m_kernels, "rgb2rgba", "scalar"), pixels*7.0, pixels,
+		[&] { ofxNDIutils::rgb2rgba(src.p, dst.p, w, h, false); });
+	BenchTime(BenchKernel(m_kernels, "YUV422_to_RGBA", "scalar"), pixels*6.0, pixels,
+		[&] { ofxNDIutils::YUV422_to_RGBA(src.p, dst.p, w, h, 0); });
+	BenchTime(BenchKernel(m_kernels, "HashBuffer", "scalar"), pixels*4.0, pixels,
+		[&] { dst.p[0] = (unsigned char)ofxNDIutils::hash64(src.p, (size_t)w*h*4); });
+#if defined(OFXNDI_SIMD)
+	BenchTime(BenchKernel(m_kernels, "HashBuffer", "sse2"), pixels*4.0, pixels,
+		[&] { dst.p[0] = (unsigned char)ofxNDIutils::hash64_sse2(src.p, (size_t)w*h*4); });
+#endif
+	// No change, so every byte is compared
+	std::vector<unsigned char> dirty;
+	memcpy(dst.p, src.p, (size_t)w*h*4);
+	BenchTime(BenchKernel(m_kernels, "DirtyTiles", "dispatch"), bytes, pixels,
+		[&] { ofxNDIutils::DirtyTiles(src.p, dst.p, w*4, h, w*4, 256, 64, dirty); });
+	int same = 0;
+	BenchTime(BenchKernel(m_kernels, "memequal", "scalar"), bytes, pixels,
+		[&] { same += ofxNDIutils::memequal(src.p, dst.p, (size_t)w*h*4) ? 1 : 0; });
+#if defined(OFXNDI_SIMD)
+	BenchTime(BenchKernel(m_kernels, "memequal", "sse2"), bytes, pixels,
+		[&] { same += ofxNDIutils::memequal_sse2(src.p, dst.p, (size_t)w*h*4) ? 1 : 0; });
+#endif
+	dst.p[0] = (unsigned char)same;
+	// 16 channels of 1602 samples (29.97 fps at 48 kHz)
+	{
+		const size_t asize = 16*1602;
+		const double asamples = (double)asize;
+		std::vector<float> ain(asize, 0.25f), aout(asize);
+		std::vector<int16_t> a16(asize, 1000);
+		std::vector<int32_t> a32(asize, 1000000);
+		BenchTime(BenchKernel(m_kernels, "InterleavedToPlanar", "scalar"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::interleaved_planar(ain.data(), aout.data(), 16, 1602); });
+		BenchTime(BenchKernel(m_kernels, "InterleavedToPlanar", "dispatch"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::InterleavedToPlanar(ain.data(), aout.data(), 16, 1602); });
+		BenchTime(BenchKernel(m_kernels, "PlanarToInterleaved", "scalar"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::planar_interleaved(ain.data(), aout.data(), 16, 1602); });
+		BenchTime(BenchKernel(m_kernels, "PlanarToInterleaved", "dispatch"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::PlanarToInterleaved(ain.data(), aout.data(), 16, 1602); });
+		BenchTime(BenchKernel(m_kernels, "FloatToInt16", "scalar"), asamples*6.0, asamples,
+			[&] { ofxNDIutils::float_int16(ain.data(), a16.data(), asize, 1.0f, false); });
+		BenchTime(BenchKernel(m_kernels, "FloatToInt16", "dispatch"), asamples*6.0, asamples,
+			[&] { ofxNDIutils::FloatToInt16(ain.data(), a16.data(), asize, 1.0f, false); });
+		BenchTime(BenchKernel(m_kernels, "FloatToInt16 dither", "dispatch"), asamples*6.0, asamples,
+			[&] { ofxNDIutils::FloatToInt16(ain.data(), a16.data(), asize, 1.0f, true); });
+		BenchTime(BenchKernel(m_kernels, "FloatToInt32", "scalar"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::float_int32(ain.data(), a32.data(), asize, 1.0f); });
+		BenchTime(BenchKernel(m_kernels, "FloatToInt32", "dispatch"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::FloatToInt32(ain.data(), a32.data(), asize); });
+		BenchTime(BenchKernel(m_kernels, "Int16ToFloat", "scalar"), asamples*6.0, asamples,
+			[&] { ofxNDIutils::int16_float(a16.data(), aout.data(), asize, 1.0f); });
+		BenchTime(BenchKernel(m_kernels, "Int16ToFloat", "dispatch"), asamples*6.0, asamples,
+			[&] { ofxNDIutils::Int16ToFloat(a16.data(), aout.data(), asize); });
+		BenchTime(BenchKernel(m_kernels, "Int32ToFloat", "scalar"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::int32_float(a32.data(), aout.data(), asize, 1.0f); });
+		BenchTime(BenchKernel(m_kernels, "Int32ToFloat", "dispatch"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::Int32ToFloat(a32.data(), aout.data(), asize); });
+		BenchTime(BenchKernel(m_kernels, "AudioGain", "scalar"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::audio_gain(ain.data(), aout.data(), asize, 0.5f); });
+		BenchTime(BenchKernel(m_kernels, "AudioGain", "dispatch"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::AudioGain(ain.data(), aout.data(), asize, 0.5f); });
+#if defined(OFXNDI_SIMD)
+		BenchTime(BenchKernel(m_kernels, "InterleavedToPlanar", "sse2"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::interleaved_planar_sse2(ain.data(), aout.data(), 16, 1602, 1602); });
+		BenchTime(BenchKernel(m_kernels, "PlanarToInterleaved", "sse2"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::planar_interleaved_sse2(ain.data(), aout.data(), 16, 1602, 1602); });
+		BenchTime(BenchKernel(m_kernels, "FloatToInt16", "sse2"), asamples*6.0, asamples,
+			[&] { ofxNDIutils::float_int16_sse2(ain.data(), a16.data(), asize, 1.0f, false); });
+		BenchTime(BenchKernel(m_kernels, "FloatToInt32", "sse2"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::float_int32_sse2(ain.data(), a32.data(), asize, 1.0f); });
+		BenchTime(BenchKernel(m_kernels, "Int16ToFloat", "sse2"), asamples*6.0, asamples,
+			[&] { ofxNDIutils::int16_float_sse2(a16.data(), aout.data(), asize, 1.0f); });
+		BenchTime(BenchKernel(m_kernels, "Int32ToFloat", "sse2"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::int32_float_sse2(a32.data(), aout.data(), asize, 1.0f); });
+		BenchTime(BenchKernel(m_kernels, "AudioGain", "sse2"), asamples*8.0, asamples,
+			[&] { ofxNDIutils::audio_gain_sse2(ain.data(), aout.data(), asize, 0.5f); });
+#endif
+	}
+	// Stereo 44.1 kHz to 48 kHz with 32 taps in blocks of 512
+	{
+		ofxNDIfifo fifo;
+		fifo.Allocate(2, 16384);
+		ofxNDIresampler resampler;
+		resampler.Setup(2, 48000, 2);
+		resampler.SetLatency(20.0);
+		std::vector<float> ain(2*1024, 0.25f), aout(2*512);
+		fifo.Write(ain.data(), 1024, 1024, 2, 44100);
+		resampler.Process(fifo, aout.data(), 512, 2); // Make the filter
+		BenchTime(BenchKernel(m_kernels, "ofxNDIresampler", "dispatch"), 512.0*2.0*4.0*2.0, 512.0*2.0,
+			[&] {
+				fifo.Write(ain.data(), 1024, 471, 2, 44100);
+				resampler.Process(fifo, aout.data(), 512, 2);
+			});
+	}
+	// A second of 29.97 fps frames at 48 kHz
+	// Cycles are per audio sample of the frames
+	{
+		ofxNDIcadence cadence;
+		cadence.Set(48000, 30000, 1001);
+		int total = 0;
+		BenchTime(BenchKernel(m_kernels, "ofxNDIcadence", "scalar"), 0.0, 48000.0,
+			[&] {
+				for (int i = 0; i < 30; i++)
+					total += cadence.Next();
+			});
+		dst.p[0] = (unsigned char)total;
+	}
+#ifdef USE_CHRONO
+	std::vector<float> interleaved(1602*2, 0.5f);
+	BenchTime(BenchKernel(m_kernels, "InterleavedToPlanar vector", "dispatch"), 1602.0*2.0*4.0*2.0, 1602.0*2.0,
+		[&] { ofxNDIutils::InterleavedToPlanar(interleaved.data(), 2, 1602); });
+	BenchTime(BenchKernel(m_kernels, "AudioFrameSequence", "scalar"), 0.0, 8008.0,
+		[&] {
+			int maxSample = 0;
+			dst.p[0] = (unsigned char)ofxNDIutils::AudioFrameSequence(48000, 29.97, maxSample).size();
+		});
+#endif
+
+	bool bResult = true;
+	printf("ofxNDIbenchmark - kernels (%s)\n", ofxNDIutils::GetSIMD().c_str());
+	printf("  kernel               variant    cases  failed     GB/s  cycles/px\n");
+	for (const ofxNDIkernelResult &result : m_kernels) {
+		if (result.failed > 0)
+			bResult = false;
+		if (result.cases == 0 || !result.bTimed)
+			continue;
+		printf("  %-20s %-8s  %6d  %6d  %7.2f  %9.2f\n", result.kernel.c_str(), result.variant.c_str(),
+			result.cases, result.failed, result.gbps, result.cycles);
+	}
+
+	return bResult;
+}
+
+// Results of RunKernels
+std::vector<ofxNDIkernelResult> ofxNDIbenchmark::GetKernelResults()
+{
+	return m_kernels;
+}
+
+// Write results as JSON
+bool ofxNDIbenchmark::WriteJSON(const char* path)
+{
+	if (!path || !*path)
+		return false;
+
+	std::ofstream file(path, std::ios::out | std::ios::trunc);
+	if (!file.is_open()) {
+		printf("ofxNDIbenchmark::WriteJSON - could not open [%s]\n", path);
+		return false;
+	}
+
+	char tmp[512]{};
+	file << "{\"ofxNDI\":\"" << ofxNDIutils::GetVersion() << "\",";
+	file << "\"runtime\":\"" << m_runtime << "\",";
+	file << "\"simd\":\"" << ofxNDIutils::GetSIMD() << "\",";
+	file << "\"frames\":" << m_frames << ",\"fps\":" << m_fps << ",\"results\":[\n";
+	for (size_t i = 0; i < m_results.size(); i++) {
+		const ofxNDIbenchmarkResult &r = m_results[i];
+		snprintf(tmp, 512, "{\"width\":%u,\"height\":%u,\"format\":\"%s\",\"mode\":\"%s\",\"streams\":%d,"
+			"\"sent\":%lld,\"received\":%lld,\"dropped\":%lld,\"seconds\":%.3f,\"fps\":%.2f,"
+			"\"latency_ms\":{\"p50\":%.3f,\"p99\":%.3f,\"p99_9\":%.3f,\"max\":%.3f},"
+			"\"send_cpu_ms\":%.4f,\"receive_ms\":%.4f,\"allocations\":%.2f}",
+			r.test.width, r.test.height, BenchFormatName(r.test.format),
+			r.test.bClocked ? "clocked" : "async", r.test.streams,
+			(long long)r.sent, (long long)r.received, (long long)r.dropped, r.seconds, r.fps,
+			r.latencyP50, r.latencyP99, r.latencyP999, r.latencyMax,
+			r.sendCpu, r.receiveTime, r.allocations);
+		file << tmp << (i + 1 < m_results.size() ? ",\n" : "\n");
+	}
+	file << "],\"kernels\":[\n";
+	for (size_t i = 0; i < m_kernels.size(); i++) {
+		const ofxNDIkernelResult &k = m_kernels[i];
+		snprintf(tmp, 512, "{\"kernel\":\"%s\",\"variant\":\"%s\",\"cases\":%d,\"failed\":%d,"
+			"\"gbps\":%.3f,\"cycles_per_pixel\":%.3f}",
+			k.kernel.c_str(), k.variant.c_str(), k.cases, k.failed, k.gbps, k.cycles);
+		file << tmp << (i + 1 < m_kernels.size() ? ",\n" : "\n");
+	}
+	file << "]}\n";
+	file.close();
+
+	return true;
+}
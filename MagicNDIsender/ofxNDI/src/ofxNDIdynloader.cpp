@@ -67,9 +67,19 @@
 	21.07.25	- Update headers to NDI version 6.2.0.3
 	21.10.25	- Update headers to NDI version 6.2.1.0
 	13.03.26	- Update headers to NDI version 6.3.1.0
+	18.10.26	- Load the loopback mock runtime (ofxNDImock)
+				  if the environment variable OFXNDI_MOCK is set
+				  and the build defines OFXNDI_USE_MOCK
+				- Load the library and initialize NDI once for the process.
+				  Loaders are reference counted and the last to be destroyed
+				  de-initializes NDI and unloads the library.
+				- Initialize NDI for OSX and Linux
 
 */
 #include "ofxNDIdynloader.h"
+#if defined(OFXNDI_USE_MOCK)
+#include "ofxNDImock.h" // loopback runtime for testing
+#endif
 
 #if defined(__APPLE__)
 #include <mach-o/dyld.h> // for _NSGetExecutablePath function
@@ -81,36 +91,74 @@
 #include <io.h> // for _access (Windows only)
 #endif
 
-ofxNDIdynloader::ofxNDIdynloader()
-{
-	p_NDILib = nullptr;
 #if defined(TARGET_WIN32)
-	m_hNDILib = NULL;
+HMODULE ofxNDIdynloader::m_hNDILib = NULL;
 #elif defined(TARGET_OSX) || defined(TARGET_LINUX)
-	m_hNDILib = nullptr;
+void* ofxNDIdynloader::m_hNDILib = nullptr;
 #endif
+std::mutex ofxNDIdynloader::m_loaderMutex;
+const NDIlib_v5* ofxNDIdynloader::m_pLibrary = nullptr;
+int ofxNDIdynloader::m_nReferences = 0;
+
+ofxNDIdynloader::ofxNDIdynloader()
+{
+	p_NDILib = nullptr;
 }
 
 ofxNDIdynloader::~ofxNDIdynloader()
 {
-	if (p_NDILib) p_NDILib->destroy();
+	if (!p_NDILib)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_loaderMutex);
+
+	// Other loaders are still using the library
+	if (--m_nReferences > 0)
+		return;
+
+	m_pLibrary->destroy();
+	m_pLibrary = nullptr;
 #if defined(TARGET_WIN32)
 	if (m_hNDILib)
 		FreeLibrary(m_hNDILib);
+	m_hNDILib = NULL;
 #elif defined(TARGET_OSX) || defined(TARGET_LINUX)
 	if (m_hNDILib)
 		dlclose(m_hNDILib);
+	m_hNDILib = nullptr;
 #endif
 }
 
-
-#if defined(TARGET_WIN32)
 const NDIlib_v5* ofxNDIdynloader::Load()
 {
 	// Guard against reloading
 	if (p_NDILib)
 		return p_NDILib;
 
+	std::lock_guard<std::mutex> lock(m_loaderMutex);
+
+	// Load once for the process
+	if (!m_pLibrary)
+		m_pLibrary = LoadRuntime();
+
+	if (m_pLibrary) {
+		m_nReferences++;
+		p_NDILib = m_pLibrary;
+	}
+
+	return p_NDILib;
+}
+
+
+#if defined(TARGET_WIN32)
+const NDIlib_v5* ofxNDIdynloader::LoadRuntime()
+{
+#if defined(OFXNDI_USE_MOCK)
+	// Loopback runtime for testing without NDI
+	if (ofxNDImock::IsSelected())
+		return LoadMock();
+#endif
+
 	// Look for the NDI dll
 	std::string ndi_path;
 	if (!FindWinRuntime(ndi_path)) {
@@ -149,8 +197,8 @@ const NDIlib_v5* ofxNDIdynloader::Load()
 	}
 
 	// Get all of the DLL entry points
-	p_NDILib = NDIlib_v5_load();
-	if (!p_NDILib) {
+	const NDIlib_v5* pLib = NDIlib_v5_load();
+	if (!pLib) {
 		MessageBoxA(NULL, "Could not get NDI library functions", "Warning", MB_OK);
 		if (m_hNDILib) FreeLibrary(m_hNDILib);
 		m_hNDILib = NULL;
@@ -158,7 +206,7 @@ const NDIlib_v5* ofxNDIdynloader::Load()
 	}
 
 	// Check cpu compatibility
-	if (!p_NDILib->is_supported_CPU()) {
+	if (!pLib->is_supported_CPU()) {
 		MessageBoxA(NULL, "CPU does not support NDI\nNDILib requires SSE4.1", "Warning", MB_OK);
 		if (m_hNDILib) FreeLibrary(m_hNDILib);
 		m_hNDILib = NULL;
@@ -166,7 +214,7 @@ const NDIlib_v5* ofxNDIdynloader::Load()
 	}
 	else {
 		// Initialize the library
-		if (!p_NDILib->initialize()) {
+		if (!pLib->initialize()) {
 			MessageBoxA(NULL, "Could not run NDI - NDILib initialization failed", "Warning", MB_OK);
 			if (m_hNDILib) FreeLibrary(m_hNDILib);
 			m_hNDILib = NULL;
@@ -175,9 +223,9 @@ const NDIlib_v5* ofxNDIdynloader::Load()
 	}
 	
 	std::cout << "\nLoaded NDI library - " << ndi_path.c_str() << std::endl;
-	std::cout << p_NDILib->version() << " (https://ndi.video/)" << std::endl;
+	std::cout << pLib->version() << " (https://ndi.video/)" << std::endl;
 
-	return p_NDILib;
+	return pLib;
 
 }
 
@@ -290,11 +338,13 @@ bool ofxNDIdynloader::ReadPathFromRegistry(HKEY hKey, const char* subkey, const
 
 #elif defined(TARGET_OSX) || defined(TARGET_LINUX)
 // OSX and LINUX
-const NDIlib_v5* ofxNDIdynloader::Load()
+const NDIlib_v5* ofxNDIdynloader::LoadRuntime()
 {
- 	// Guard against reloading
-	if (p_NDILib)
-		return p_NDILib;
+#if defined(OFXNDI_USE_MOCK)
+	// Loopback runtime for testing without NDI
+	if (ofxNDImock::IsSelected())
+		return LoadMock();
+#endif
 
     std::string ndi_path = FindRuntime();
     OUTS << "NDI runtime location " << ndi_path << std::endl;
@@ -322,9 +372,15 @@ const NDIlib_v5* ofxNDIdynloader::Load()
         return nullptr;
     }
 
-    p_NDILib = lib_load(); // this loads the library and returns a pointer to the dynamic binding
+    const NDIlib_v5* pLib = lib_load(); // this loads the library and returns a pointer to the dynamic binding
+	if (!pLib || !pLib->initialize()) {
+		ERRS << "Could not run NDI - NDILib initialization failed" << std::endl;
+		dlclose(m_hNDILib);
+		m_hNDILib = nullptr;
+		return nullptr;
+	}
 
-	return p_NDILib;
+	return pLib;
 }
 
 const std::string ofxNDIdynloader::FindRuntime() {
@@ -385,9 +441,29 @@ const std::string ofxNDIdynloader::GetCurrentExePath()
 }
 
 #else
-const NDIlib_v5* ofxNDIdynloader::Load()
+const NDIlib_v5* ofxNDIdynloader::LoadRuntime()
+{
+#if defined(OFXNDI_USE_MOCK)
+    return ofxNDImock::IsSelected() ? LoadMock() : nullptr;
+#else
+    return nullptr;
+#endif
+}
+#endif
+
+#if defined(OFXNDI_USE_MOCK)
+//
+// Use the loopback mock runtime if the environment variable
+// OFXNDI_MOCK is set, e.g. OFXNDI_MOCK=1
+// See ofxNDImock.h for network conditions
+//
+const NDIlib_v5* ofxNDIdynloader::LoadMock()
 {
-    return p_NDILib;
+	const NDIlib_v5* pLib = ofxNDImock::Load();
+	pLib->initialize();
+	std::cout << "\nLoaded NDI mock runtime - " << pLib->version() << std::endl;
+
+	return pLib;
 }
 #endif
 
@@ -0,0 +1,255 @@
+/*
+
+	ofxNDIfifo
+
+	Lock-free planar float audio FIFO
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+				- Write stride in floats as for Read
+
+*/
+#include "ofxNDIfifo.h"
+#include <stdio.h>
+#include <string.h>
+
+ofxNDIfifo::ofxNDIfifo()
+{
+	m_maxChannels = 0;
+	m_capacity = 0;
+	m_mask = 0;
+	m_write = 0;
+	m_read = 0;
+	m_channels = 0;
+	m_samplerate = 0;
+	m_overruns = 0;
+	m_underruns = 0;
+}
+
+ofxNDIfifo::~ofxNDIfifo()
+{
+	Release();
+}
+
+// Allocate for up to "channels" channels of "samples" samples each
+bool ofxNDIfifo::Allocate(int channels, int samples)
+{
+	if (channels <= 0 || samples <= 0) {
+		printf("ofxNDIfifo::Allocate - invalid size %d channels %d samples\n", channels, samples);
+		return false;
+	}
+
+	// Round up to a power of two so that a position
+	// is converted to an index with a mask
+	uint64_t capacity = 1;
+	while (capacity < (uint64_t)samples)
+		capacity <<= 1;
+
+	try {
+		m_buffer.assign((size_t)channels*(size_t)capacity, 0.0f);
+	}
+	catch (...) {
+		printf("ofxNDIfifo::Allocate - could not allocate %d channels %d samples\n", channels, (int)capacity);
+		Release();
+		return false;
+	}
+
+	m_maxChannels = channels;
+	m_capacity = capacity;
+	m_mask = capacity - 1;
+	m_write = 0;
+	m_read = 0;
+	m_channels = 0;
+	m_samplerate = 0;
+	m_overruns = 0;
+	m_underruns = 0;
+
+	return true;
+}
+
+// Free the buffer
+void ofxNDIfifo::Release()
+{
+	std::vector<float>().swap(m_buffer);
+	m_maxChannels = 0;
+	m_capacity = 0;
+	m_mask = 0;
+	m_write = 0;
+	m_read = 0;
+	m_channels = 0;
+	m_samplerate = 0;
+}
+
+// Is the buffer allocated
+bool ofxNDIfifo::IsAllocated()
+{
+	return m_capacity > 0;
+}
+
+// Write planar float audio
+int ofxNDIfifo::Write(const float* data, int stride, int samples, int channels, int samplerate)
+{
+	if (!data || samples <= 0 || channels <= 0 || m_capacity == 0)
+		return 0;
+
+	if (stride <= 0)
+		stride = samples;
+
+	const uint64_t write = m_write.load(std::memory_order_relaxed);
+	const uint64_t read = m_read.load(std::memory_order_acquire);
+	const uint64_t space = m_capacity - (write - read);
+
+	uint64_t n = (uint64_t)samples;
+	if (n > space) {
+		m_overruns.fetch_add((int64_t)(n - space), std::memory_order_relaxed);
+		n = space;
+	}
+
+	if (channels > m_maxChannels)
+		channels = m_maxChannels;
+	m_channels.store(channels, std::memory_order_relaxed);
+	m_samplerate.store(samplerate, std::memory_order_relaxed);
+
+	if (n == 0)
+		return 0;
+
+	// Copy in up to two parts if the ring wraps
+	const uint64_t start = write & m_mask;
+	const uint64_t first = (n < m_capacity - start) ? n : m_capacity - start;
+	for (int c = 0; c < channels; c++) {
+		const float* src = data + (size_t)c*(size_t)stride;
+		float* ring = &m_buffer[(size_t)c*(size_t)m_capacity];
+		memcpy(ring + start, src, (size_t)first*sizeof(float));
+		if (n > first)
+			memcpy(ring, src + first, (size_t)(n - first)*sizeof(float));
+	}
+
+	// Publish the samples after they have been copied
+	m_write.store(write + n, std::memory_order_release);
+
+	return (int)n;
+}
+
+// Read exactly "samples" samples of "channels" channels
+int ofxNDIfifo::Read(float* output, int samples, int channels, int stride)
+{
+	if (!output || samples <= 0 || channels <= 0)
+		return 0;
+
+	if (stride <= 0)
+		stride = samples;
+
+	uint64_t n = 0;
+	int written = 0; // Channels of the data
+	if (m_capacity > 0) {
+		const uint64_t read = m_read.load(std::memory_order_relaxed);
+		const uint64_t write = m_write.load(std::memory_order_acquire);
+		n = write - read;
+		if (n > (uint64_t)samples)
+			n = (uint64_t)samples;
+		written = m_channels.load(std::memory_order_relaxed);
+
+		if (n > 0) {
+			const uint64_t start = read & m_mask;
+			const uint64_t first = (n < m_capacity - start) ? n : m_capacity - start;
+			for (int c = 0; c < channels && c < written; c++) {
+				const float* ring = &m_buffer[(size_t)c*(size_t)m_capacity];
+				float* dst = output + (size_t)c*(size_t)stride;
+				memcpy(dst, ring + start, (size_t)first*sizeof(float));
+				if (n > first)
+					memcpy(dst + first, ring, (size_t)(n - first)*sizeof(float));
+			}
+			// Release the space after the samples have been copied
+			m_read.store(read + n, std::memory_order_release);
+		}
+	}
+
+	// Silence for channels that have not been written
+	for (int c = written; c < channels; c++)
+		memset(output + (size_t)c*(size_t)stride, 0, (size_t)samples*sizeof(float));
+
+	// Silence for samples not available
+	if (n < (uint64_t)samples) {
+		m_underruns.fetch_add((int64_t)((uint64_t)samples - n), std::memory_order_relaxed);
+		for (int c = 0; c < channels && c < written; c++)
+			memset(output + (size_t)c*(size_t)stride + n, 0, (size_t)((uint64_t)samples - n)*sizeof(float));
+	}
+
+	return (int)n;
+}
+
+// Discard all samples available
+void ofxNDIfifo::Clear()
+{
+	m_read.store(m_write.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+// Samples of each channel available to read
+int ofxNDIfifo::GetAvailable()
+{
+	const uint64_t read = m_read.load(std::memory_order_acquire);
+	const uint64_t write = m_write.load(std::memory_order_acquire);
+	return (int)(write - read);
+}
+
+// Samples of each channel that can be written
+int ofxNDIfifo::GetSpace()
+{
+	return (int)m_capacity - GetAvailable();
+}
+
+// Samples of each channel allocated
+int ofxNDIfifo::GetCapacity()
+{
+	return (int)m_capacity;
+}
+
+// Channels allocated
+int ofxNDIfifo::GetMaxChannels()
+{
+	return m_maxChannels;
+}
+
+// Channels of the last data written
+int ofxNDIfifo::GetChannels()
+{
+	return m_channels.load(std::memory_order_relaxed);
+}
+
+// Sample rate of the last data written
+int ofxNDIfifo::GetSampleRate()
+{
+	return m_samplerate.load(std::memory_order_relaxed);
+}
+
+// Samples dropped because the buffer was full
+int64_t ofxNDIfifo::GetOverruns()
+{
+	return m_overruns.load(std::memory_order_relaxed);
+}
+
+// Samples of silence returned because the buffer was empty
+int64_t ofxNDIfifo::GetUnderruns()
+{
+	return m_underruns.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,156 @@
+/*
+
+	ofxNDIfifo
+
+	Lock-free planar float audio FIFO
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+				- Write stride in floats as for Read
+
+*/
+#pragma once
+#ifndef __ofxNDIfifo__
+#define __ofxNDIfifo__
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+//
+// Ring buffer of planar float audio for one writing thread
+// and one reading thread. No locks and no allocation after Allocate.
+//
+// Each channel has its own ring of "capacity" samples, rounded up
+// to a power of two. Write and read positions are sample counts
+// that only increase, so that the samples available are the
+// difference with no ambiguity between full and empty.
+//
+// If there is not enough space, Write drops the samples that do not
+// fit and adds them to the overrun count. If there are not enough
+// samples, Read returns silence for the rest and adds it to the
+// underrun count, so that the reader always has the samples it asked for.
+//
+// Strides of Write and Read are in floats, as for the ofxNDIutils
+// audio functions. For an NDI audio frame, divide
+// channel_stride_in_bytes by sizeof(float).
+//
+// Allocate and Release change the buffer and are not safe while
+// another thread writes or reads. The owner must stop those threads
+// or guard the calls, as ofxNDIreceive does for ReceiveImage.
+//
+// Example :
+//
+//    ofxNDIfifo fifo;
+//    fifo.Allocate(16, 48000); // Up to 16 channels, 1 second at 48 kHz
+//    // Receiving thread
+//    fifo.Write(planar, stride, samples, channels, samplerate);
+//    // Audio thread
+//    fifo.Read(output, 512, 2);
+//
+
+class ofxNDIfifo {
+
+public:
+
+	ofxNDIfifo();
+	~ofxNDIfifo();
+
+	// Allocate for up to "channels" channels of "samples" samples each
+	// Not while another thread is writing or reading
+	bool Allocate(int channels, int samples);
+
+	// Free the buffer
+	// Not while another thread is writing or reading
+	void Release();
+
+	// Is the buffer allocated
+	bool IsAllocated();
+
+	//
+	// Writing thread
+	//
+
+	// Write planar float audio
+	// - data | first sample of the first channel
+	// - stride | floats from one channel to the next (0 for samples)
+	// - samples | samples of each channel
+	// - channels | channels of the data, more than allocated are not written
+	// - samplerate | sample rate of the data
+	// Returns the samples written
+	int Write(const float* data, int stride, int samples, int channels, int samplerate);
+
+	//
+	// Reading thread
+	//
+
+	// Read exactly "samples" samples of "channels" channels (planar)
+	// - stride | floats from one output channel to the next (0 for samples)
+	// Channels that have not been written and any samples
+	// not available are returned as silence.
+	// Returns the samples read.
+	int Read(float* output, int samples, int channels, int stride = 0);
+
+	// Discard all samples available
+	void Clear();
+
+	//
+	// Either thread
+	//
+
+	// Samples of each channel available to read
+	int GetAvailable();
+	// Samples of each channel that can be written
+	int GetSpace();
+	// Samples of each channel allocated
+	int GetCapacity();
+	// Channels allocated
+	int GetMaxChannels();
+	// Channels of the last data written
+	int GetChannels();
+	// Sample rate of the last data written
+	int GetSampleRate();
+	// Samples dropped by Write because the buffer was full
+	int64_t GetOverruns();
+	// Samples of silence returned by Read because the buffer was empty
+	int64_t GetUnderruns();
+
+private:
+
+	std::vector<float> m_buffer; // channels x capacity
+	int m_maxChannels;
+	uint64_t m_capacity; // Power of two
+	uint64_t m_mask;
+
+	// Positions are on separate cache lines
+	// so that the threads do not share them
+	alignas(64) std::atomic<uint64_t> m_write;
+	alignas(64) std::atomic<uint64_t> m_read;
+	alignas(64) std::atomic<int> m_channels;
+	std::atomic<int> m_samplerate;
+	std::atomic<int64_t> m_overruns; // Written by the writing thread only
+	std::atomic<int64_t> m_underruns; // Written by the reading thread only
+
+};
+
+#endif
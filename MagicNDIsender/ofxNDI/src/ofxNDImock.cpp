@@ -0,0 +1,956 @@
+/*
+
+	ofxNDImock
+
+	Loopback stand-in for the NDI runtime
+
+	Implements the NDIlib_v5 function table for senders, finders,
+	receivers and frame synchronizers within the same process.
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create file
+
+*/
+#include "ofxNDImock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <algorithm>
+
+namespace ofxNDImock {
+
+	// Frame types queued for receivers
+	#define MOCK_VIDEO    0
+	#define MOCK_AUDIO    1
+	#define MOCK_METADATA 2
+
+	// Maximum frames queued by a receiver before the oldest are dropped
+	static const size_t maxQueue[3] = { 16, 64, 64 };
+
+	// A frame is copied once when it is sent
+	// and the memory is shared by all receivers
+	struct mockFrame {
+		NDIlib_video_frame_v2_t video;
+		NDIlib_audio_frame_v3_t audio;
+		NDIlib_metadata_frame_t metadata;
+		std::vector<uint8_t> data; // Pixels, planar float audio or metadata text
+		std::string framemetadata; // Metadata of a video or audio frame
+	};
+	typedef std::shared_ptr<mockFrame> framePtr;
+
+	// Frame waiting for the delivery time
+	struct mockDelivery {
+		framePtr frame;
+		std::chrono::steady_clock::time_point time;
+	};
+
+	struct mockSender {
+		std::string name; // Full NDI name
+		NDIlib_source_t source;
+		bool bClockVideo;
+		std::chrono::steady_clock::time_point nextFrame; // For clocked video
+	};
+
+	struct mockReceiver {
+		std::string source; // Full name of the sender connected to
+		std::deque<mockDelivery> queue[3];
+		std::vector<framePtr> captured; // Frames not yet freed
+		std::condition_variable condition;
+		int64_t total[3];
+		int64_t dropped[3];
+	};
+
+	struct mockFinder {
+		std::vector<std::string> names;
+		std::vector<NDIlib_source_t> sources;
+		unsigned int changes;
+	};
+
+	struct mockFramesync {
+		mockReceiver* receiver;
+		framePtr video; // Latest video frame
+		std::vector<framePtr> captured;
+		std::vector<std::deque<float>> audio; // Samples for each channel
+		int sampleRate;
+	};
+
+	// All objects are protected by one mutex
+	static std::mutex mockMutex;
+	static std::condition_variable senderCondition; // Senders created or destroyed
+	static unsigned int senderChanges = 1;
+	static std::vector<mockSender*> senders;
+	static std::vector<mockReceiver*> receivers;
+	static int initCount = 0;
+
+	// Network conditions
+	static double netLatency = 0.0; // msec
+	static double netJitter = 0.0; // msec
+	static double netLoss = 0.0; // fraction
+	static std::mt19937 netRandom(1);
+
+	static NDIlib_v5 mockLib;
+
+	//
+	// Utilities
+	//
+
+	// Read an environment variable
+	static std::string GetEnv(const char* name)
+	{
+		std::string value;
+#if defined(_MSC_VER)
+		char* p_value = nullptr;
+		_dupenv_s(&p_value, NULL, name);
+		if (p_value) {
+			value = p_value;
+			free(p_value);
+		}
+#else
+		const char* p_value = getenv(name);
+		if (p_value)
+			value = p_value;
+#endif
+		return value;
+	}
+
+	// Time now in 100ns intervals for timecodes and timestamps
+	static int64_t Now100ns()
+	{
+		return std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+
+	// Bytes of video data for the format
+	static size_t VideoSize(const NDIlib_video_frame_v2_t* frame, int stride)
+	{
+		const size_t height = (size_t)frame->yres;
+		switch (frame->FourCC) {
+			case NDIlib_FourCC_type_NV12:
+			case NDIlib_FourCC_type_I420:
+			case NDIlib_FourCC_type_YV12:
+				return (size_t)stride*height*3/2;
+			case NDIlib_FourCC_video_type_P216:
+				return (size_t)stride*height*2;
+			case NDIlib_FourCC_video_type_PA16:
+				return (size_t)stride*height*3;
+			case NDIlib_FourCC_type_UYVA:
+				return (size_t)stride*height + (size_t)frame->xres*height;
+			default:
+				return (size_t)stride*height;
+		}
+	}
+
+	// Line stride if the sender has not set it
+	static int VideoStride(const NDIlib_video_frame_v2_t* frame)
+	{
+		switch (frame->FourCC) {
+			case NDIlib_FourCC_type_UYVY:
+			case NDIlib_FourCC_type_UYVA:
+				return frame->xres*2;
+			case NDIlib_FourCC_type_NV12:
+			case NDIlib_FourCC_type_I420:
+			case NDIlib_FourCC_type_YV12:
+				return frame->xres;
+			case NDIlib_FourCC_video_type_P216:
+			case NDIlib_FourCC_video_type_PA16:
+				return frame->xres*2;
+			default:
+				return frame->xres*4;
+		}
+	}
+
+	// Copy planar float audio into a new frame
+	static framePtr NewAudioFrame(int sample_rate, int no_channels, int no_samples, int64_t timecode, const char* p_metadata)
+	{
+		framePtr frame = std::make_shared<mockFrame>();
+		frame->data.resize((size_t)no_channels*(size_t)no_samples*sizeof(float));
+		frame->audio.sample_rate = sample_rate;
+		frame->audio.no_channels = no_channels;
+		frame->audio.no_samples = no_samples;
+		frame->audio.timecode = (timecode == NDIlib_send_timecode_synthesize) ? Now100ns() : timecode;
+		frame->audio.FourCC = NDIlib_FourCC_audio_type_FLTP;
+		frame->audio.p_data = frame->data.data();
+		frame->audio.channel_stride_in_bytes = no_samples*(int)sizeof(float);
+		frame->audio.p_metadata = nullptr;
+		if (p_metadata) {
+			frame->framemetadata = p_metadata;
+			frame->audio.p_metadata = frame->framemetadata.c_str();
+		}
+		frame->audio.timestamp = Now100ns();
+		return frame;
+	}
+
+	// Queue a frame for each receiver connected to the sender.
+	// Frames are lost at random and delivered after the latency
+	// plus jitter but never before an earlier frame.
+	static void Deliver(mockSender* sender, const framePtr &frame, int type)
+	{
+		std::lock_guard<std::mutex> lock(mockMutex);
+		std::uniform_real_distribution<double> uniform(0.0, 1.0);
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		for (mockReceiver* receiver : receivers) {
+			if (receiver->source != sender->name)
+				continue;
+			receiver->total[type]++;
+			if (netLoss > 0.0 && uniform(netRandom) < netLoss) {
+				receiver->dropped[type]++;
+				continue;
+			}
+			double delay = netLatency;
+			if (netJitter > 0.0)
+				delay += netJitter*uniform(netRandom);
+			mockDelivery delivery;
+			delivery.frame = frame;
+			delivery.time = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double, std::milli>(delay));
+			std::deque<mockDelivery> &queue = receiver->queue[type];
+			if (!queue.empty() && delivery.time < queue.back().time)
+				delivery.time = queue.back().time;
+			queue.push_back(delivery);
+			if (queue.size() > maxQueue[type]) {
+				queue.pop_front();
+				receiver->dropped[type]++;
+			}
+			receiver->condition.notify_all();
+		}
+	}
+
+	// Remove the frames of a type that are due
+	static std::vector<framePtr> TakeDue(mockReceiver* receiver, int type)
+	{
+		std::vector<framePtr> frames;
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		std::deque<mockDelivery> &queue = receiver->queue[type];
+		while (!queue.empty() && queue.front().time <= now) {
+			frames.push_back(queue.front().frame);
+			queue.pop_front();
+		}
+		return frames;
+	}
+
+	// Release a captured frame by data pointer
+	static void Release(std::vector<framePtr> &captured, const void* p_data)
+	{
+		for (auto it = captured.begin(); it != captured.end(); it++) {
+			if ((*it)->data.data() == p_data) {
+				captured.erase(it);
+				return;
+			}
+		}
+	}
+
+	//
+	// Library
+	//
+
+	static bool initialize()
+	{
+		std::lock_guard<std::mutex> lock(mockMutex);
+		initCount++;
+		return true;
+	}
+
+	static void destroy()
+	{
+		std::lock_guard<std::mutex> lock(mockMutex);
+		if (initCount > 0)
+			initCount--;
+	}
+
+	static const char* version()
+	{
+		return "NDI SDK MOCK 6.3.1.0";
+	}
+
+	static bool is_supported_CPU()
+	{
+		return true;
+	}
+
+	//
+	// Find
+	//
+
+	static NDIlib_find_instance_t find_create_v2(const NDIlib_find_create_t* /*p_create_settings*/)
+	{
+		mockFinder* finder = new mockFinder;
+		finder->changes = 0;
+		return (NDIlib_find_instance_t)finder;
+	}
+
+	static void find_destroy(NDIlib_find_instance_t p_instance)
+	{
+		delete (mockFinder*)p_instance;
+	}
+
+	static const NDIlib_source_t* find_get_current_sources(NDIlib_find_instance_t p_instance, uint32_t* p_no_sources)
+	{
+		mockFinder* finder = (mockFinder*)p_instance;
+		if (!finder)
+			return nullptr;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		finder->names.clear();
+		for (mockSender* sender : senders)
+			finder->names.push_back(sender->name);
+		finder->sources.resize(finder->names.size());
+		for (size_t i = 0; i < finder->names.size(); i++) {
+			finder->sources[i].p_ndi_name = finder->names[i].c_str();
+			finder->sources[i].p_url_address = nullptr;
+		}
+		finder->changes = senderChanges;
+		if (p_no_sources)
+			*p_no_sources = (uint32_t)finder->sources.size();
+		return finder->sources.empty() ? nullptr : finder->sources.data();
+	}
+
+	static bool find_wait_for_sources(NDIlib_find_instance_t p_instance, uint32_t timeout_in_ms)
+	{
+		mockFinder* finder = (mockFinder*)p_instance;
+		if (!finder)
+			return false;
+		std::unique_lock<std::mutex> lock(mockMutex);
+		return senderCondition.wait_for(lock, std::chrono::milliseconds(timeout_in_ms),
+			[finder] { return finder->changes != senderChanges; });
+	}
+
+	static const NDIlib_source_t* find_get_sources(NDIlib_find_instance_t p_instance, uint32_t* p_no_sources, uint32_t timeout_in_ms)
+	{
+		find_wait_for_sources(p_instance, timeout_in_ms);
+		return find_get_current_sources(p_instance, p_no_sources);
+	}
+
+	//
+	// Send
+	//
+
+	static NDIlib_send_instance_t send_create(const NDIlib_send_create_t* p_create_settings)
+	{
+		std::string name = "Mock sender";
+		if (p_create_settings && p_create_settings->p_ndi_name && *p_create_settings->p_ndi_name)
+			name = p_create_settings->p_ndi_name;
+
+		std::lock_guard<std::mutex> lock(mockMutex);
+
+		// Full names are unique
+		std::string fullname = "MOCK (" + name + ")";
+		for (int n = 2; ; n++) {
+			bool bExists = false;
+			for (mockSender* s : senders) {
+				if (s->name == fullname)
+					bExists = true;
+			}
+			if (!bExists)
+				break;
+			fullname = "MOCK (" + name + " " + std::to_string(n) + ")";
+		}
+
+		mockSender* sender = new mockSender;
+		sender->name = fullname;
+		sender->source.p_ndi_name = sender->name.c_str();
+		sender->source.p_url_address = nullptr;
+		sender->bClockVideo = p_create_settings ? p_create_settings->clock_video : true;
+		sender->nextFrame = std::chrono::steady_clock::now();
+		senders.push_back(sender);
+		senderChanges++;
+		senderCondition.notify_all();
+		return (NDIlib_send_instance_t)sender;
+	}
+
+	static void send_destroy(NDIlib_send_instance_t p_instance)
+	{
+		mockSender* sender = (mockSender*)p_instance;
+		if (!sender)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		senders.erase(std::remove(senders.begin(), senders.end(), sender), senders.end());
+		senderChanges++;
+		senderCondition.notify_all();
+		delete sender;
+	}
+
+	static void send_send_video_v2(NDIlib_send_instance_t p_instance, const NDIlib_video_frame_v2_t* p_video_data)
+	{
+		mockSender* sender = (mockSender*)p_instance;
+		// A null frame synchronizes async sending
+		if (!sender || !p_video_data || !p_video_data->p_data)
+			return;
+
+		// Clock to the frame rate
+		if (sender->bClockVideo && p_video_data->frame_rate_N > 0 && p_video_data->frame_rate_D > 0) {
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (sender->nextFrame > now)
+				std::this_thread::sleep_until(sender->nextFrame);
+			else
+				sender->nextFrame = now;
+			sender->nextFrame += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double>((double)p_video_data->frame_rate_D/(double)p_video_data->frame_rate_N));
+		}
+
+		int stride = p_video_data->line_stride_in_bytes;
+		if (stride <= 0)
+			stride = VideoStride(p_video_data);
+
+		framePtr frame = std::make_shared<mockFrame>();
+		frame->data.resize(VideoSize(p_video_data, stride));
+		memcpy(frame->data.data(), p_video_data->p_data, frame->data.size());
+		frame->video = *p_video_data;
+		frame->video.p_data = frame->data.data();
+		frame->video.line_stride_in_bytes = stride;
+		if (frame->video.timecode == NDIlib_send_timecode_synthesize)
+			frame->video.timecode = Now100ns();
+		frame->video.timestamp = Now100ns();
+		frame->video.p_metadata = nullptr;
+		if (p_video_data->p_metadata) {
+			frame->framemetadata = p_video_data->p_metadata;
+			frame->video.p_metadata = frame->framemetadata.c_str();
+		}
+
+		Deliver(sender, frame, MOCK_VIDEO);
+	}
+
+	// The frame is copied, so the sender's buffer
+	// is free as soon as the function returns
+	static void send_send_video_async_v2(NDIlib_send_instance_t p_instance, const NDIlib_video_frame_v2_t* p_video_data)
+	{
+		send_send_video_v2(p_instance, p_video_data);
+	}
+
+	static void send_send_audio_v2(NDIlib_send_instance_t p_instance, const NDIlib_audio_frame_v2_t* p_audio_data)
+	{
+		mockSender* sender = (mockSender*)p_instance;
+		if (!sender || !p_audio_data || !p_audio_data->p_data)
+			return;
+		const int nsamples = p_audio_data->no_samples;
+		framePtr frame = NewAudioFrame(p_audio_data->sample_rate, p_audio_data->no_channels,
+			nsamples, p_audio_data->timecode, p_audio_data->p_metadata);
+		float* dest = (float*)frame->data.data();
+		for (int c = 0; c < p_audio_data->no_channels; c++) {
+			const float* src = (const float*)((const uint8_t*)p_audio_data->p_data + (size_t)c*(size_t)p_audio_data->channel_stride_in_bytes);
+			memcpy(dest + (size_t)c*(size_t)nsamples, src, (size_t)nsamples*sizeof(float));
+		}
+		Deliver(sender, frame, MOCK_AUDIO);
+	}
+
+	static void send_send_audio_v3(NDIlib_send_instance_t p_instance, const NDIlib_audio_frame_v3_t* p_audio_data)
+	{
+		if (!p_audio_data || p_audio_data->FourCC != NDIlib_FourCC_audio_type_FLTP)
+			return;
+		NDIlib_audio_frame_v2_t frame;
+		frame.sample_rate = p_audio_data->sample_rate;
+		frame.no_channels = p_audio_data->no_channels;
+		frame.no_samples = p_audio_data->no_samples;
+		frame.timecode = p_audio_data->timecode;
+		frame.p_data = (float*)p_audio_data->p_data;
+		frame.channel_stride_in_bytes = p_audio_data->channel_stride_in_bytes;
+		frame.p_metadata = p_audio_data->p_metadata;
+		send_send_audio_v2(p_instance, &frame);
+	}
+
+	// Interleaved audio is converted to planar float.
+	// The reference level is not applied.
+	template <typename T>
+	static void SendInterleaved(NDIlib_send_instance_t p_instance, int sample_rate, int no_channels,
+		int no_samples, int64_t timecode, const T* p_data, float scale)
+	{
+		mockSender* sender = (mockSender*)p_instance;
+		if (!sender || !p_data)
+			return;
+		framePtr frame = NewAudioFrame(sample_rate, no_channels, no_samples, timecode, nullptr);
+		float* dest = (float*)frame->data.data();
+		for (int c = 0; c < no_channels; c++) {
+			for (int s = 0; s < no_samples; s++)
+				dest[(size_t)c*no_samples + s] = (float)p_data[(size_t)s*no_channels + c]*scale;
+		}
+		Deliver(sender, frame, MOCK_AUDIO);
+	}
+
+	static void util_send_send_audio_interleaved_16s(NDIlib_send_instance_t p_instance, const NDIlib_audio_frame_interleaved_16s_t* p_audio_data)
+	{
+		if (p_audio_data)
+			SendInterleaved(p_instance, p_audio_data->sample_rate, p_audio_data->no_channels,
+				p_audio_data->no_samples, p_audio_data->timecode, p_audio_data->p_data, 1.0f/32768.0f);
+	}
+
+	static void util_send_send_audio_interleaved_32s(NDIlib_send_instance_t p_instance, const NDIlib_audio_frame_interleaved_32s_t* p_audio_data)
+	{
+		if (p_audio_data)
+			SendInterleaved(p_instance, p_audio_data->sample_rate, p_audio_data->no_channels,
+				p_audio_data->no_samples, p_audio_data->timecode, p_audio_data->p_data, 1.0f/2147483648.0f);
+	}
+
+	static void util_send_send_audio_interleaved_32f(NDIlib_send_instance_t p_instance, const NDIlib_audio_frame_interleaved_32f_t* p_audio_data)
+	{
+		if (p_audio_data)
+			SendInterleaved(p_instance, p_audio_data->sample_rate, p_audio_data->no_channels,
+				p_audio_data->no_samples, p_audio_data->timecode, p_audio_data->p_data, 1.0f);
+	}
+
+	static void send_send_metadata(NDIlib_send_instance_t p_instance, const NDIlib_metadata_frame_t* p_metadata)
+	{
+		mockSender* sender = (mockSender*)p_instance;
+		if (!sender || !p_metadata || !p_metadata->p_data)
+			return;
+		framePtr frame = std::make_shared<mockFrame>();
+		const size_t length = strlen(p_metadata->p_data);
+		frame->data.assign(p_metadata->p_data, p_metadata->p_data + length + 1);
+		frame->metadata.length = (int)length;
+		frame->metadata.timecode = (p_metadata->timecode == NDIlib_send_timecode_synthesize) ? Now100ns() : p_metadata->timecode;
+		frame->metadata.p_data = (char*)frame->data.data();
+		Deliver(sender, frame, MOCK_METADATA);
+	}
+
+	static const NDIlib_source_t* send_get_source_name(NDIlib_send_instance_t p_instance)
+	{
+		mockSender* sender = (mockSender*)p_instance;
+		return sender ? &sender->source : nullptr;
+	}
+
+	static int send_get_no_connections(NDIlib_send_instance_t p_instance, uint32_t /*timeout_in_ms*/)
+	{
+		mockSender* sender = (mockSender*)p_instance;
+		if (!sender)
+			return 0;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		int connections = 0;
+		for (mockReceiver* receiver : receivers) {
+			if (receiver->source == sender->name)
+				connections++;
+		}
+		return connections;
+	}
+
+	static bool send_get_tally(NDIlib_send_instance_t /*p_instance*/, NDIlib_tally_t* /*p_tally*/, uint32_t /*timeout_in_ms*/)
+	{
+		return false;
+	}
+
+	static void send_clear_connection_metadata(NDIlib_send_instance_t /*p_instance*/)
+	{
+	}
+
+	static void send_add_connection_metadata(NDIlib_send_instance_t /*p_instance*/, const NDIlib_metadata_frame_t* /*p_metadata*/)
+	{
+	}
+
+	//
+	// Receive
+	//
+
+	static void recv_connect(NDIlib_recv_instance_t p_instance, const NDIlib_source_t* p_src)
+	{
+		mockReceiver* receiver = (mockReceiver*)p_instance;
+		if (!receiver)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		receiver->source.clear();
+		if (p_src && p_src->p_ndi_name)
+			receiver->source = p_src->p_ndi_name;
+		for (int i = 0; i < 3; i++)
+			receiver->queue[i].clear();
+	}
+
+	static NDIlib_recv_instance_t recv_create_v3(const NDIlib_recv_create_v3_t* p_create_settings)
+	{
+		mockReceiver* receiver = new mockReceiver;
+		for (int i = 0; i < 3; i++) {
+			receiver->total[i] = 0;
+			receiver->dropped[i] = 0;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mockMutex);
+			receivers.push_back(receiver);
+		}
+		if (p_create_settings)
+			recv_connect((NDIlib_recv_instance_t)receiver, &p_create_settings->source_to_connect_to);
+		return (NDIlib_recv_instance_t)receiver;
+	}
+
+	static void recv_destroy(NDIlib_recv_instance_t p_instance)
+	{
+		mockReceiver* receiver = (mockReceiver*)p_instance;
+		if (!receiver)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		receivers.erase(std::remove(receivers.begin(), receivers.end(), receiver), receivers.end());
+		delete receiver;
+	}
+
+	// Return the earliest frame that is due, waiting up to the timeout.
+	// Frame types with a null pointer are discarded.
+	static NDIlib_frame_type_e recv_capture_v3(NDIlib_recv_instance_t p_instance,
+		NDIlib_video_frame_v2_t* p_video_data, NDIlib_audio_frame_v3_t* p_audio_data,
+		NDIlib_metadata_frame_t* p_metadata, uint32_t timeout_in_ms)
+	{
+		mockReceiver* receiver = (mockReceiver*)p_instance;
+		if (!receiver)
+			return NDIlib_frame_type_error;
+
+		void* wanted[3] = { p_video_data, p_audio_data, p_metadata };
+		std::unique_lock<std::mutex> lock(mockMutex);
+		const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now()
+			+ std::chrono::milliseconds(timeout_in_ms);
+
+		for (;;) {
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			int type = -1;
+			std::chrono::steady_clock::time_point next = deadline;
+			for (int i = 0; i < 3; i++) {
+				std::deque<mockDelivery> &queue = receiver->queue[i];
+				if (!wanted[i]) {
+					while (!queue.empty() && queue.front().time <= now)
+						queue.pop_front();
+				}
+				if (queue.empty())
+					continue;
+				if (queue.front().time <= now) {
+					if (type < 0 || queue.front().time < receiver->queue[type].front().time)
+						type = i;
+				}
+				else if (queue.front().time < next) {
+					next = queue.front().time;
+				}
+			}
+
+			if (type >= 0) {
+				framePtr frame = receiver->queue[type].front().frame;
+				receiver->queue[type].pop_front();
+				receiver->captured.push_back(frame);
+				switch (type) {
+					case MOCK_VIDEO:
+						*p_video_data = frame->video;
+						return NDIlib_frame_type_video;
+					case MOCK_AUDIO:
+						*p_audio_data = frame->audio;
+						return NDIlib_frame_type_audio;
+					default:
+						*p_metadata = frame->metadata;
+						return NDIlib_frame_type_metadata;
+				}
+			}
+
+			if (now >= deadline)
+				return NDIlib_frame_type_none;
+			receiver->condition.wait_until(lock, next);
+		}
+	}
+
+	static void recv_free_video_v2(NDIlib_recv_instance_t p_instance, const NDIlib_video_frame_v2_t* p_video_data)
+	{
+		mockReceiver* receiver = (mockReceiver*)p_instance;
+		if (!receiver || !p_video_data)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		Release(receiver->captured, p_video_data->p_data);
+	}
+
+	static void recv_free_audio_v3(NDIlib_recv_instance_t p_instance, const NDIlib_audio_frame_v3_t* p_audio_data)
+	{
+		mockReceiver* receiver = (mockReceiver*)p_instance;
+		if (!receiver || !p_audio_data)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		Release(receiver->captured, p_audio_data->p_data);
+	}
+
+	static void recv_free_metadata(NDIlib_recv_instance_t p_instance, const NDIlib_metadata_frame_t* p_metadata)
+	{
+		mockReceiver* receiver = (mockReceiver*)p_instance;
+		if (!receiver || !p_metadata)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		Release(receiver->captured, p_metadata->p_data);
+	}
+
+	static void recv_free_string(NDIlib_recv_instance_t /*p_instance*/, const char* /*p_string*/)
+	{
+	}
+
+	static bool recv_set_tally(NDIlib_recv_instance_t p_instance, const NDIlib_tally_t* /*p_tally*/)
+	{
+		return p_instance != nullptr;
+	}
+
+	static void recv_get_performance(NDIlib_recv_instance_t p_instance, NDIlib_recv_performance_t* p_total, NDIlib_recv_performance_t* p_dropped)
+	{
+		mockReceiver* receiver = (mockReceiver*)p_instance;
+		if (!receiver)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		if (p_total) {
+			p_total->video_frames    = receiver->total[MOCK_VIDEO];
+			p_total->audio_frames    = receiver->total[MOCK_AUDIO];
+			p_total->metadata_frames = receiver->total[MOCK_METADATA];
+		}
+		if (p_dropped) {
+			p_dropped->video_frames    = receiver->dropped[MOCK_VIDEO];
+			p_dropped->audio_frames    = receiver->dropped[MOCK_AUDIO];
+			p_dropped->metadata_frames = receiver->dropped[MOCK_METADATA];
+		}
+	}
+
+	static void recv_get_queue(NDIlib_recv_instance_t p_instance, NDIlib_recv_queue_t* p_total)
+	{
+		mockReceiver* receiver = (mockReceiver*)p_instance;
+		if (!receiver || !p_total)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		p_total->video_frames    = (int)receiver->queue[MOCK_VIDEO].size();
+		p_total->audio_frames    = (int)receiver->queue[MOCK_AUDIO].size();
+		p_total->metadata_frames = (int)receiver->queue[MOCK_METADATA].size();
+	}
+
+	static int recv_get_no_connections(NDIlib_recv_instance_t p_instance)
+	{
+		mockReceiver* receiver = (mockReceiver*)p_instance;
+		if (!receiver)
+			return 0;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		for (mockSender* sender : senders) {
+			if (sender->name == receiver->source)
+				return 1;
+		}
+		return 0;
+	}
+
+	//
+	// Frame synchronizer
+	//
+
+	static NDIlib_framesync_instance_t framesync_create(NDIlib_recv_instance_t p_receiver)
+	{
+		if (!p_receiver)
+			return nullptr;
+		mockFramesync* framesync = new mockFramesync;
+		framesync->receiver = (mockReceiver*)p_receiver;
+		framesync->sampleRate = 48000;
+		return (NDIlib_framesync_instance_t)framesync;
+	}
+
+	static void framesync_destroy(NDIlib_framesync_instance_t p_instance)
+	{
+		delete (mockFramesync*)p_instance;
+	}
+
+	// Move due audio frames to the sample queue of each channel
+	static void PullAudio(mockFramesync* framesync)
+	{
+		for (const framePtr &frame : TakeDue(framesync->receiver, MOCK_AUDIO)) {
+			const int channels = frame->audio.no_channels;
+			const int nsamples = frame->audio.no_samples;
+			if ((int)framesync->audio.size() != channels)
+				framesync->audio.assign(channels, std::deque<float>());
+			framesync->sampleRate = frame->audio.sample_rate;
+			const float* src = (const float*)frame->audio.p_data;
+			for (int c = 0; c < channels; c++)
+				framesync->audio[c].insert(framesync->audio[c].end(), src + (size_t)c*nsamples, src + (size_t)(c+1)*nsamples);
+		}
+	}
+
+	// Return the latest video frame, or the previous one if none is due
+	static void framesync_capture_video(NDIlib_framesync_instance_t p_instance, NDIlib_video_frame_v2_t* p_video_data, NDIlib_frame_format_type_e /*field_type*/)
+	{
+		mockFramesync* framesync = (mockFramesync*)p_instance;
+		if (!framesync || !p_video_data)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		std::vector<framePtr> frames = TakeDue(framesync->receiver, MOCK_VIDEO);
+		if (!frames.empty())
+			framesync->video = frames.back();
+		PullAudio(framesync);
+		if (framesync->video) {
+			*p_video_data = framesync->video->video;
+			framesync->captured.push_back(framesync->video);
+		}
+		else {
+			*p_video_data = NDIlib_video_frame_v2_t();
+			p_video_data->xres = 0;
+			p_video_data->yres = 0;
+			p_video_data->p_data = nullptr;
+		}
+	}
+
+	static void framesync_free_video(NDIlib_framesync_instance_t p_instance, NDIlib_video_frame_v2_t* p_video_data)
+	{
+		mockFramesync* framesync = (mockFramesync*)p_instance;
+		if (!framesync || !p_video_data || !p_video_data->p_data)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		Release(framesync->captured, p_video_data->p_data);
+	}
+
+	// Return the number of samples requested,
+	// with silence if not enough have been received.
+	// Zero for rate, channels or samples uses the received values.
+	static void framesync_capture_audio(NDIlib_framesync_instance_t p_instance, NDIlib_audio_frame_v2_t* p_audio_data, int sample_rate, int no_channels, int no_samples)
+	{
+		mockFramesync* framesync = (mockFramesync*)p_instance;
+		if (!framesync || !p_audio_data)
+			return;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		PullAudio(framesync);
+
+		const int available = framesync->audio.empty() ? 0 : (int)framesync->audio[0].size();
+		if (sample_rate <= 0)
+			sample_rate = framesync->sampleRate;
+		if (no_channels <= 0)
+			no_channels = framesync->audio.empty() ? 2 : (int)framesync->audio.size();
+		if (no_samples <= 0)
+			no_samples = available;
+
+		float* data = new float[(size_t)no_channels*(size_t)no_samples]();
+		const int ncopy = std::min(available, no_samples);
+		for (int c = 0; c < no_channels; c++) {
+			if (c < (int)framesync->audio.size())
+				std::copy(framesync->audio[c].begin(), framesync->audio[c].begin() + ncopy, data + (size_t)c*no_samples);
+		}
+		for (std::deque<float> &channel : framesync->audio)
+			channel.erase(channel.begin(), channel.begin() + ncopy);
+
+		p_audio_data->sample_rate = sample_rate;
+		p_audio_data->no_channels = no_channels;
+		p_audio_data->no_samples = no_samples;
+		p_audio_data->timecode = Now100ns();
+		p_audio_data->p_data = data;
+		p_audio_data->channel_stride_in_bytes = no_samples*(int)sizeof(float);
+		p_audio_data->p_metadata = nullptr;
+		p_audio_data->timestamp = Now100ns();
+	}
+
+	static void framesync_free_audio(NDIlib_framesync_instance_t /*p_instance*/, NDIlib_audio_frame_v2_t* p_audio_data)
+	{
+		if (!p_audio_data)
+			return;
+		delete[] p_audio_data->p_data;
+		p_audio_data->p_data = nullptr;
+	}
+
+	static int framesync_audio_queue_depth(NDIlib_framesync_instance_t p_instance)
+	{
+		mockFramesync* framesync = (mockFramesync*)p_instance;
+		if (!framesync)
+			return 0;
+		std::lock_guard<std::mutex> lock(mockMutex);
+		PullAudio(framesync);
+		return framesync->audio.empty() ? 0 : (int)framesync->audio[0].size();
+	}
+
+	//
+	// Public
+	//
+
+	bool IsSelected()
+	{
+		std::string mock = GetEnv("OFXNDI_MOCK");
+		return !mock.empty() && mock != "0";
+	}
+
+	void SetNetwork(double latency, double jitter, double loss, unsigned int seed)
+	{
+		std::lock_guard<std::mutex> lock(mockMutex);
+		netLatency = std::max(latency, 0.0);
+		netJitter = std::max(jitter, 0.0);
+		netLoss = std::min(std::max(loss, 0.0), 1.0);
+		netRandom.seed(seed);
+	}
+
+	const NDIlib_v5* Load()
+	{
+		// Network conditions from the environment
+		std::string value;
+		double latency = 0.0;
+		double jitter = 0.0;
+		double loss = 0.0;
+		unsigned int seed = 1;
+		value = GetEnv("OFXNDI_MOCK_LATENCY");
+		if (!value.empty()) latency = atof(value.c_str());
+		value = GetEnv("OFXNDI_MOCK_JITTER");
+		if (!value.empty()) jitter = atof(value.c_str());
+		value = GetEnv("OFXNDI_MOCK_LOSS");
+		if (!value.empty()) loss = atof(value.c_str());
+		value = GetEnv("OFXNDI_MOCK_SEED");
+		if (!value.empty()) seed = (unsigned int)strtoul(value.c_str(), nullptr, 10);
+		SetNetwork(latency, jitter, loss, seed);
+
+		// Functions not implemented remain null
+		mockLib.initialize = initialize;
+		mockLib.destroy = destroy;
+		mockLib.version = version;
+		mockLib.is_supported_CPU = is_supported_CPU;
+
+		mockLib.find_create_v2 = find_create_v2;
+		mockLib.find_destroy = find_destroy;
+		mockLib.find_get_sources = find_get_sources;
+		mockLib.find_wait_for_sources = find_wait_for_sources;
+		mockLib.find_get_current_sources = find_get_current_sources;
+
+		mockLib.send_create = send_create;
+		mockLib.send_destroy = send_destroy;
+		mockLib.send_send_video_v2 = send_send_video_v2;
+		mockLib.send_send_video_async_v2 = send_send_video_async_v2;
+		mockLib.send_send_audio_v2 = send_send_audio_v2;
+		mockLib.send_send_audio_v3 = send_send_audio_v3;
+		mockLib.util_send_send_audio_interleaved_16s = util_send_send_audio_interleaved_16s;
+		mockLib.util_send_send_audio_interleaved_32s = util_send_send_audio_interleaved_32s;
+		mockLib.util_send_send_audio_interleaved_32f = util_send_send_audio_interleaved_32f;
+		mockLib.send_send_metadata = send_send_metadata;
+		mockLib.send_get_source_name = send_get_source_name;
+		mockLib.send_get_no_connections = send_get_no_connections;
+		mockLib.send_get_tally = send_get_tally;
+		mockLib.send_clear_connection_metadata = send_clear_connection_metadata;
+		mockLib.send_add_connection_metadata = send_add_connection_metadata;
+
+		mockLib.recv_create_v3 = recv_create_v3;
+		mockLib.recv_destroy = recv_destroy;
+		mockLib.recv_connect = recv_connect;
+		mockLib.recv_capture_v3 = recv_capture_v3;
+		mockLib.recv_free_video_v2 = recv_free_video_v2;
+		mockLib.recv_free_audio_v3 = recv_free_audio_v3;
+		mockLib.recv_free_metadata = recv_free_metadata;
+		mockLib.recv_free_string = recv_free_string;
+		mockLib.recv_set_tally = recv_set_tally;
+		mockLib.recv_get_performance = recv_get_performance;
+		mockLib.recv_get_queue = recv_get_queue;
+		mockLib.recv_get_no_connections = recv_get_no_connections;
+
+		mockLib.framesync_create = framesync_create;
+		mockLib.framesync_destroy = framesync_destroy;
+		mockLib.framesync_capture_video = framesync_capture_video;
+		mockLib.framesync_free_video = framesync_free_video;
+		mockLib.framesync_capture_audio = framesync_capture_audio;
+		mockLib.framesync_free_audio = framesync_free_audio;
+		mockLib.framesync_audio_queue_depth = framesync_audio_queue_depth;
+
+		return &mockLib;
+	}
+
+}
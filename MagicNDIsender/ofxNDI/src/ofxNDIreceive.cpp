@@ -171,50 +171,42 @@
 			   FindSenders - allow for no senders left
 	02-05-26 - GetSenderCount() - Add FindSenders so that the function
 			   can be called independently of ReceiveImage
+	18.10.26 - Add receiver statistics
+			   StartStats/StopStats - sampling thread for recv_get_performance and recv_get_queue
+			   GetStats, ResetStats, SetStageTime
+			   ReceiveImage - time capture and record video timestamp jitter
+			 - Add standby receiver pool for fast sender switching
+			   CreateReceiver - use a standby receiver until the new receiver connects
+			   ReceiveImage - capture with CaptureFrame
+			   ReleaseReceiver - free video data before the receiver is destroyed
+			 - Add failover to backup senders with return to the primary sender
+			   The primary is stable while its last frame is within the
+			   failover timeout, not only if a frame arrived since the last check
+			 - Trace spans for ReceiveImage, CaptureFrame, frame copy, FreeVideoData,
+			   failover and the statistics thread
+			 - Add repeated frame detection by timestamp and timecode
+			   and optional hash of sampled rows
+			   SetRepeatHash, IsRepeatFrame, GetRepeatFrames
+			 - Use the monotonic ofxNDIutils clock with nanosecond resolution
+			   for timing and fps instead of timeGetTime and QueryPerformanceCounter.
+			   Remove the Linux gettimeofday versions, which were not monotonic.
+			   Linux timeGetTime returned only the msec within the current second.
+			   UpdateFps - use frame times less than 1 msec
+			 - Add lock-free audio FIFO (ofxNDIfifo) written by ReceiveImage
+			   SetAudioFifo, ReleaseAudioFifo, ReadAudio, GetAudioFifo
+			 - ReceiveImage - audio frames copied by CopyAudioFrame
+			   Allocate the audio buffer only if more samples are needed
+			   Copy each channel using the frame channel stride
+			   Number of samples per channel was divided by the channels
+			 - SetAudioFifo and ReleaseAudioFifo locked against the FIFO write
+			   in ReceiveImage. FIFO stride in floats.
+			 - Add audio resampling (ofxNDIresampler) for ReadAudio
+			   SetAudioResample, GetAudioResampler
 
 */
 
 #include "ofxNDIreceive.h"
 #include <math.h>
-// Linux
-// https://github.com/hugoaboud/ofxNDI
-#if !defined(TARGET_WIN32)
-double timeGetTime() {
-	struct timeval now;
-	gettimeofday(&now, NULL);
-	return now.tv_usec / 1000;
-}
-
-// Helpful conversion constants.
-static const unsigned usec_per_sec = 1000000;
-// static const unsigned usec_per_msec = 1000;
-
-// These functions are written to match the win32
-// signatures and behavior as closely as possible.
-bool QueryPerformanceFrequency(LARGE_INTEGER *frequency)
-{
-	// Sanity check.
-	assert(frequency != NULL);
-	// gettimeofday reports to microsecond accuracy.
-	frequency->QuadPart = usec_per_sec;
-	return true;
-}
-
-bool QueryPerformanceCounter(LARGE_INTEGER *performance_count)
-{
-	struct timeval time;
-
-	// Sanity check.
-	assert(performance_count != NULL);
-
-	// Grab the current time.
-	gettimeofday(&time, NULL);
-	performance_count->QuadPart = time.tv_usec + /* Microseconds. */
-		time.tv_sec * usec_per_sec; /* Seconds. */
-
-	return true;
-}
-#endif
 
 ofxNDIreceive::ofxNDIreceive()
 {
@@ -237,6 +229,7 @@ ofxNDIreceive::ofxNDIreceive()
 	m_senderName = "";
 	// Audio
 	m_AudioData = nullptr;
+	m_AudioDataSize = 0;
 	m_bAudio = false;
 	m_bAudioFrame = false;
 	m_nAudioSampleRate = 0;
@@ -250,12 +243,43 @@ ofxNDIreceive::ofxNDIreceive()
 	m_VideoTimecode = 0LL;
 	m_VideoTimestamp = 0LL;
 
+	// Repeated frames
+	m_bRepeatFrame = false;
+	m_bRepeatHash = false;
+	m_repeatRows = 64;
+	m_repeatFrames = 0LL;
+	ResetRepeat();
+
 	// For received frame fps calculations
-	startTime = lastTime = (double)timeGetTime();
+	CounterStart = ofxNDIutils::GetClockTime();
+	startTime = lastTime = 0.0;
 	m_fps = 30.0; // starting value
 	m_frameTimeTotal = 0.0; // averaging
 	m_frameTimeNumber = 0.0;
 
+	// Statistics
+	m_bStatsActive = false;
+	m_statsInterval = 1000;
+	m_lastTimestamp = 0LL;
+	m_jitterTotal = 0.0;
+	m_jitterCount = 0LL;
+
+	// Standby receivers
+	m_standbyBandwidth = NDIlib_recv_bandwidth_lowest;
+	pNDI_standby = nullptr;
+	pNDI_frame = nullptr;
+
+	// Failover
+	m_failoverTimeout = 500.0;
+	m_failoverHold = 5000.0;
+	m_failoverLatency = 0.0;
+	m_bFailover = false;
+	m_bPrimaryStandby = false;
+	m_primaryFrames = 0LL;
+	m_primaryFrameTime = std::chrono::steady_clock::now();
+	m_bSwitching = false;
+	m_bPrimaryStable = false;
+
 	// NDI documentation :
 	// For most uses you should specify NDIlib_recv_bandwidth_highest, which will
 	// result in the same stream that is being sent from the up-stream source to you.
@@ -274,7 +298,10 @@ ofxNDIreceive::ofxNDIreceive()
 
 ofxNDIreceive::~ofxNDIreceive()
 {
+	StopStats();
 	FreeAudioData();
+	ReleaseReceiver();
+	ClearStandby();
 	if(p_NDILib && pNDI_recv) p_NDILib->recv_destroy(pNDI_recv);
 	if(p_NDILib && pNDI_find) p_NDILib->find_destroy(pNDI_find);
 	// Library is released in ofxNDIdynloader
@@ -390,6 +417,9 @@ bool ofxNDIreceive::FindSenders(int &sendercount)
 				}
 			}
 
+			// Connect standby receivers for new senders
+			UpdateStandby();
+
 			// Network change - return new number of senders
 			sendercount = (int)NDIsenders.size();
 			m_nSenders = sendercount;
@@ -430,12 +460,10 @@ int ofxNDIreceive::RefreshSenders(uint32_t timeout)
 	// If a finder was created, use it to find senders on the network
 	// Give it a timeout in case of connection trouble.
 	if(pNDI_find) {
-		dwStartTime = timeGetTime();
-		dwElapsedTime = 0;
+		const int64_t start = ofxNDIutils::GetClockTime();
 		do {
 			p_sources = p_NDILib->find_get_current_sources(pNDI_find, &nsources);
-			dwElapsedTime = timeGetTime() - dwStartTime;
-		} while(nsources == 0 && (uint32_t)dwElapsedTime < timeout);
+		} while(nsources == 0 && ofxNDIutils::GetElapsedTime(start) < (double)timeout);
 		return nsources;
 	}
 
@@ -686,6 +714,115 @@ int64_t ofxNDIreceive::GetVideoTimecode()
 	return m_VideoTimecode;
 }
 
+// Detect repeated frames by a hash of sampled rows
+// as well as by the timestamp and timecode
+void ofxNDIreceive::SetRepeatHash(bool bHash, unsigned int rows)
+{
+	m_bRepeatHash = bHash;
+	m_repeatRows = (rows == 1) ? 2 : rows; // first and last row at least
+	ResetRepeat();
+}
+
+// Return whether the current video frame is a repeat of the last one
+bool ofxNDIreceive::IsRepeatFrame()
+{
+	return m_bRepeatFrame;
+}
+
+// Number of repeated video frames received
+int64_t ofxNDIreceive::GetRepeatFrames()
+{
+	return m_repeatFrames;
+}
+
+// Compare the video frame received with the last one
+void ofxNDIreceive::UpdateRepeat()
+{
+	// The format and size must be the same
+	const bool bSameFormat = (m_repeatFourCC == video_frame.FourCC
+		&& m_repeatWidth == video_frame.xres && m_repeatHeight == video_frame.yres
+		&& m_repeatStride == video_frame.line_stride_in_bytes);
+
+	// A frame received again has the same timestamp and timecode.
+	// Undefined timestamps are not compared.
+	bool bRepeat = bSameFormat && m_bRepeatValid
+		&& video_frame.timestamp != NDIlib_recv_timestamp_undefined
+		&& video_frame.timestamp == m_repeatTimestamp
+		&& video_frame.timecode == m_repeatTimecode;
+
+	// A frame sent again by the sender has a new timestamp
+	// and is found by the hash if selected
+	if (m_bRepeatHash && video_frame.p_data) {
+		const uint64_t hash = SampleHash();
+		if (!bRepeat)
+			bRepeat = bSameFormat && m_bRepeatValid && hash == m_repeatHashValue;
+		m_repeatHashValue = hash;
+	}
+
+	m_repeatTimestamp = video_frame.timestamp;
+	m_repeatTimecode  = video_frame.timecode;
+	m_repeatFourCC    = video_frame.FourCC;
+	m_repeatWidth     = video_frame.xres;
+	m_repeatHeight    = video_frame.yres;
+	m_repeatStride    = video_frame.line_stride_in_bytes;
+	m_bRepeatValid    = true;
+
+	m_bRepeatFrame = bRepeat;
+	if (bRepeat)
+		m_repeatFrames++;
+}
+
+// Hash of rows sampled evenly through the video frame data
+// All planes are included. Zero rows hashes the whole frame.
+uint64_t ofxNDIreceive::SampleHash()
+{
+	const unsigned int stride = (unsigned int)video_frame.line_stride_in_bytes;
+	const unsigned int yres = (unsigned int)video_frame.yres;
+	size_t size = (size_t)stride*yres;
+	switch (video_frame.FourCC) {
+		case NDIlib_FourCC_type_NV12:
+		case NDIlib_FourCC_type_I420:
+		case NDIlib_FourCC_type_YV12:
+			size = size*3/2;
+			break;
+		case NDIlib_FourCC_video_type_P216:
+			size = size*2;
+			break;
+		case NDIlib_FourCC_video_type_PA16:
+			size = size*3;
+			break;
+		case NDIlib_FourCC_type_UYVA:
+			size += (size_t)video_frame.xres*yres;
+			break;
+		default:
+			break;
+	}
+
+	const unsigned char* data = (const unsigned char*)video_frame.p_data;
+	const size_t rows = (stride > 0) ? size/stride : 0;
+	if (m_repeatRows == 0 || rows <= m_repeatRows)
+		return ofxNDIutils::HashBuffer(data, size);
+
+	uint64_t hash = 0;
+	for (unsigned int i = 0; i < m_repeatRows; i++) {
+		const size_t row = (size_t)i*(rows - 1)/(m_repeatRows - 1);
+		hash = hash*0x9E3779B185EBCA87ULL + ofxNDIutils::HashBuffer(data + row*stride, stride);
+	}
+	return hash;
+}
+
+// Clear the last frame compared
+void ofxNDIreceive::ResetRepeat()
+{
+	m_bRepeatValid = false;
+	m_bRepeatFrame = false;
+	m_repeatTimestamp = 0LL;
+	m_repeatTimecode = 0LL;
+	m_repeatHashValue = 0;
+	m_repeatFourCC = (NDIlib_FourCC_video_type_e)0;
+	m_repeatWidth = m_repeatHeight = m_repeatStride = 0;
+}
+
 // Set to receive Audio
 void ofxNDIreceive::SetAudio(bool bAudio)
 {
@@ -715,7 +852,7 @@ int ofxNDIreceive::GetAudioSamples()
 // Audio sample rate
 int ofxNDIreceive::GetAudioSampleRate()
 {
-	if (m_AudioData) {
+	if (m_AudioData || m_audioFifo.IsAllocated()) {
 		return m_nAudioSampleRate;
 	}
 	return 0;
@@ -746,6 +883,130 @@ void ofxNDIreceive::GetAudioData(float*& output, int& samplerate, int& samples,
 	}
 }
 
+// Receive audio into a lock-free FIFO
+bool ofxNDIreceive::SetAudioFifo(int channels, int samples)
+{
+	std::lock_guard<std::mutex> lock(m_audioFifoMutex);
+	if (!m_audioFifo.Allocate(channels, samples))
+		return false;
+	m_bAudio = true;
+	return true;
+}
+
+// Release the audio FIFO
+void ofxNDIreceive::ReleaseAudioFifo()
+{
+	std::lock_guard<std::mutex> lock(m_audioFifoMutex);
+	m_audioResampler.Release();
+	m_audioFifo.Release();
+}
+
+// Read planar float audio from the FIFO
+int ofxNDIreceive::ReadAudio(float* output, int samples, int channels)
+{
+	if (m_audioResampler.IsSetup())
+		return m_audioResampler.Process(m_audioFifo, output, samples, channels);
+	return m_audioFifo.Read(output, samples, channels);
+}
+
+// Audio FIFO for the sample rate, level and counters
+ofxNDIfifo& ofxNDIreceive::GetAudioFifo()
+{
+	return m_audioFifo;
+}
+
+// Resample audio read from the FIFO to a fixed rate
+bool ofxNDIreceive::SetAudioResample(int samplerate, int quality, double latency)
+{
+	if (samplerate <= 0) {
+		m_audioResampler.Release();
+		return true;
+	}
+
+	if (!m_audioFifo.IsAllocated()) {
+		printf("ofxNDIreceive::SetAudioResample - audio FIFO not set\n");
+		return false;
+	}
+
+	// The FIFO must hold the latency with room for frames
+	// arriving between reads, e.g. 192 kHz for twice the latency
+	if ((double)m_audioFifo.GetCapacity() < latency*2.0*192.0)
+		printf("ofxNDIreceive::SetAudioResample - FIFO of %d samples may be too small for %.0f msec\n",
+			m_audioFifo.GetCapacity(), latency);
+
+	if (!m_audioResampler.Setup(m_audioFifo.GetMaxChannels(), samplerate, quality))
+		return false;
+	m_audioResampler.SetLatency(latency);
+
+	return true;
+}
+
+// Resampler for the ratio and level
+ofxNDIresampler& ofxNDIreceive::GetAudioResampler()
+{
+	return m_audioResampler;
+}
+
+// Copy a received audio frame to the audio FIFO
+// or to the local audio buffer for GetAudioData
+void ofxNDIreceive::CopyAudioFrame(const NDIlib_audio_frame_v3_t &audio_frame)
+{
+	/*
+	printf("Audio frame\n");
+	printf("Number of channels      = %d\n", audio_frame.no_channels);
+	printf("Number of samples       = %d\n", audio_frame.no_samples);
+	printf("Sample rate             = %d\n", audio_frame.sample_rate);
+	printf("FourCC                  = %d\n", audio_frame.FourCC);
+	printf("Data size in bytes      = %d\n", audio_frame.data_size_in_bytes);
+	printf("Channel stride in bytes = %d\n", audio_frame.channel_stride_in_bytes);
+	*/
+
+	// Number of channels
+	m_nAudioChannels   = audio_frame.no_channels;
+	// Number of samples per channel
+	m_nAudioSamples    = audio_frame.no_samples;
+	// Sample rate in hz
+	m_nAudioSampleRate = audio_frame.sample_rate;
+
+	// Planar float (FLTP) with channel_stride_in_bytes between channels.
+	// The lock is held only against SetAudioFifo and ReleaseAudioFifo
+	// from another thread. ReadAudio does not take it.
+	{
+		std::lock_guard<std::mutex> lock(m_audioFifoMutex);
+		if (m_audioFifo.IsAllocated()) {
+			ofxNDIutils::TraceSpan span("ofxNDIreceive::AudioFifo");
+			m_audioFifo.Write((const float*)audio_frame.p_data, audio_frame.channel_stride_in_bytes/(int)sizeof(float),
+				audio_frame.no_samples, audio_frame.no_channels, audio_frame.sample_rate);
+			m_bAudioFrame = true;
+			return;
+		}
+	}
+
+	// Allocate only if more samples are needed
+	const size_t size = (size_t)audio_frame.no_samples * (size_t)audio_frame.no_channels;
+	if (size > m_AudioDataSize) {
+		if (m_AudioData)
+			free((void *)m_AudioData);
+		m_AudioData = (float *)malloc(size * sizeof(float));
+		m_AudioDataSize = m_AudioData ? size : 0;
+	}
+
+	if (m_AudioData) {
+		// Channels are contiguous in the local buffer
+		for (int c = 0; c < audio_frame.no_channels; c++) {
+			memcpy((void *)(m_AudioData + (size_t)c * (size_t)audio_frame.no_samples),
+				(const void *)(audio_frame.p_data + (size_t)c * (size_t)audio_frame.channel_stride_in_bytes),
+				(size_t)audio_frame.no_samples * sizeof(float));
+		}
+		m_AudioDataStride = audio_frame.no_samples * (int)sizeof(float);
+	}
+	else {
+		m_AudioDataStride = 0;
+	}
+
+	m_bAudioFrame = true;
+}
+
 // Test for network change
 // Create receiver if not initialized or a new sender has been selected
 bool ofxNDIreceive::OpenReceiver()
@@ -814,11 +1075,10 @@ bool ofxNDIreceive::CreateReceiver(NDIlib_recv_color_format_e colorFormat , int
 
 		// Check existing sources in case of connection trouble
 		if (pNDI_find) {
-			dwStartTime = (unsigned int)timeGetTime();
+			const int64_t start = ofxNDIutils::GetClockTime();
 			do {
 				p_sources = p_NDILib->find_get_current_sources(pNDI_find, &no_sources);
-				dwElapsedTime = (unsigned int)timeGetTime() - dwStartTime;
-			} while (no_sources == 0 && dwElapsedTime < 4000);
+			} while (no_sources == 0 && ofxNDIutils::GetElapsedTime(start) < 4000.0);
 		}
 
 		if (p_sources && no_sources > 0) {
@@ -905,21 +1165,35 @@ bool ofxNDIreceive::CreateReceiver(NDIlib_recv_color_format_e colorFormat , int
 			// Vers 3.5
 			// pNDI_recv = NDIlib_recv_create_v3(&NDI_recv_create_desc);
 			// Vers 4.0
-			pNDI_recv = p_NDILib->recv_create_v3(&NDI_recv_create_desc);
-			if (!pNDI_recv) {
+			NDIlib_recv_instance_t p_recv = p_NDILib->recv_create_v3(&NDI_recv_create_desc);
+			if (!p_recv) {
 				printf("ofxNDIreceive::CreateReceiver - could not create pNDI_recv\n");
 				return false;
 			}
 
+			// The statistics thread uses the receiver
+			{
+				std::lock_guard<std::mutex> lock(m_statsMutex);
+				pNDI_recv = p_recv;
+				m_lastTimestamp = 0LL;
+			}
+
 			// Reset the current sender name given the index
 			m_senderName = NDIsenders.at(index);
 
+			// Use a standby receiver for this sender if there is one
+			TakeStandby(m_senderName);
+
 			// Reset the current index value
 			m_senderIndex = index;
 
 			// Reset the timestamp, timecode and frame time
 			m_VideoTimestamp = 0LL;
 			m_VideoTimecode = 0LL;
+			ResetRepeat();
+
+			// Failover loss is timed from now until the first frame
+			m_lastFrameTime = std::chrono::steady_clock::now();
 
 			// Start the counter for frame fps calculations
 			StartCounter();
@@ -956,18 +1230,29 @@ void ofxNDIreceive::ReleaseReceiver()
 {
 	if(!bNDIinitialized) return;
 
-	if(pNDI_recv) 
-		p_NDILib->recv_destroy(pNDI_recv);
+	// Free any video frame before the receiver that captured it is released
+	FreeVideoData();
+
+	// Return a standby receiver in use to the pool
+	ReturnStandby();
+
+	// The statistics thread uses the receiver
+	{
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		if (pNDI_recv)
+			p_NDILib->recv_destroy(pNDI_recv);
+		pNDI_recv = nullptr;
+	}
 
 	m_Width = 0;
 	m_Height = 0;
 	m_VideoTimestamp = 0LL;
 	m_VideoTimecode = 0LL;
+	ResetRepeat();
 
 	pNDI_recv = nullptr;
 	bReceiverCreated = false;
 	bReceiverConnected = false;
-	FreeVideoData();
 	FreeAudioData();
 
 	// Don't clear the sender name
@@ -999,10 +1284,15 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 
 	if (pNDI_recv) {
 
+		ofxNDIutils::TraceSpan span("ofxNDIreceive::ReceiveImage");
+
+		// Capture start time for statistics
+		double capturestart = GetCounter();
+
 		// NDI_frame_type = p_NDILib->recv_capture_v2(pNDI_recv, &video_frame, &audio_frame, &metadata_frame, 0);
 		// Vers 4.5
 		// Return immediately  if no frame is available for lowest-latency.
-		NDI_frame_type = p_NDILib->recv_capture_v3(pNDI_recv, &video_frame, &audio_frame, &metadata_frame, 0);
+		NDI_frame_type = CaptureFrame(&audio_frame, &metadata_frame);
 
 		// Set frame type for external access
 		m_FrameType = NDI_frame_type;
@@ -1047,38 +1337,9 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 				if (audio_frame.p_data) {
 					if (m_bAudio) {
 
-						// Copy the audio data to a local audio buffer
-						// Allocate only for sample size change
-						if (m_nAudioSamples != audio_frame.no_samples
-							|| m_nAudioSampleRate != audio_frame.sample_rate
-							|| m_nAudioChannels != audio_frame.no_channels) {
-							if (m_AudioData) {
-								free((void*)m_AudioData);
-								m_AudioDataStride = 0;
-							}
-							m_AudioData = (float *)malloc((size_t)audio_frame.no_samples * (size_t)audio_frame.no_channels * sizeof(float));
-							m_AudioDataStride = audio_frame.channel_stride_in_bytes;
-						}
-						
-						/*
-						printf("Audio frame\n");
-						printf("Number of channels      = %d\n", audio_frame.no_channels);
-						printf("Number of samples       = %d\n", audio_frame.no_samples);
-						printf("Sample rate             = %d\n", audio_frame.sample_rate);
-						printf("FourCC                  = %d\n", audio_frame.FourCC);
-						printf("Data size in bytes      = %d\n", audio_frame.data_size_in_bytes);
-						printf("Channel stride in bytes = %d\n", audio_frame.channel_stride_in_bytes);
-						*/
-
-						// Number of channels
-						m_nAudioChannels   = audio_frame.no_channels;
-						// Number of samples per channel
-						m_nAudioSamples    = audio_frame.no_samples/audio_frame.no_channels;
-						// Sample rate in hz
-						m_nAudioSampleRate = audio_frame.sample_rate;
-						if (m_AudioData)
-							memcpy((void *)m_AudioData, (void *)audio_frame.p_data, ((size_t)m_nAudioSamples * (size_t)audio_frame.no_channels * sizeof(float)));
-						m_bAudioFrame = true;
+						// Copy the audio data to the audio FIFO
+						// or to a local audio buffer
+						CopyAudioFrame(audio_frame);
 
 						// ReceiveImage will return false
 						// Use IsAudioFrame() to determine whether audio has been received
@@ -1110,6 +1371,7 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 					else if (video_frame.p_data && (uint8_t*)pixels) {
 						
 						// Video frame type
+						ofxNDIutils::TraceSpan copyspan("ofxNDIreceive::CopyFrame");
 						switch (video_frame.FourCC) {
 							// Note : If the receiver is set up to prefer BGRA or RGBA format,
 							// the slower YUV422_to_RGBA conversion function here is not used.
@@ -1143,6 +1405,9 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 
 						} // end switch received format
 
+						// Is the frame a repeat of the last one
+						UpdateRepeat();
+
 						// Get the current video frame timecode
 						// UTC time since the Unix Epoch (1/1/1970 00:00) with 100 ns precision.
 						m_VideoTimecode = video_frame.timecode;
@@ -1151,7 +1416,7 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 						m_VideoTimestamp = video_frame.timestamp;
 
 						// Buffers captured must be freed
-						p_NDILib->recv_free_video_v2(pNDI_recv, &video_frame);
+						FreeVideoData();
 
 						// The caller always checks the received dimensions
 						width = m_Width;
@@ -1160,6 +1425,9 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 						// Update received frame counter
 						UpdateFps();
 
+						// Capture and copy time and timestamp jitter
+						UpdateStats(GetCounter() - capturestart);
+
 						// return true for successful video frame received
 						bRet = true;
 
@@ -1213,8 +1481,13 @@ bool ofxNDIreceive::ReceiveImage(unsigned int &width, unsigned int &height)
 
 	if (pNDI_recv) {
 
+		ofxNDIutils::TraceSpan span("ofxNDIreceive::ReceiveImage");
+
+		// Capture start time for statistics
+		double capturestart = GetCounter();
+
 		// Vers 4.5
-		NDI_frame_type = p_NDILib->recv_capture_v3(pNDI_recv, &video_frame, &audio_frame, &metadata_frame, 0);
+		NDI_frame_type = CaptureFrame(&audio_frame, &metadata_frame);
 
 		// Set frame type for external access
 		m_FrameType = NDI_frame_type;
@@ -1262,33 +1535,10 @@ bool ofxNDIreceive::ReceiveImage(unsigned int &width, unsigned int &height)
 				if (audio_frame.p_data) {
 					if (m_bAudio) {
 
-						// Copy the audio data to a local audio buffer
-						// Re-allocate only for sample size change
-						if (m_nAudioSamples       != audio_frame.no_samples
-							|| m_nAudioSampleRate != audio_frame.sample_rate
-							|| m_nAudioChannels   != audio_frame.no_channels) {
-							if (m_AudioData)
-								free((void *)m_AudioData);
-							m_AudioData = nullptr;
-						}
+						// Copy the audio data to the audio FIFO
+						// or to a local audio buffer
+						CopyAudioFrame(audio_frame);
 
-						if (!m_AudioData) {
-							m_AudioData = (float *)malloc((size_t)audio_frame.no_samples * (size_t)audio_frame.no_channels * sizeof(float));
-						}
-
-						m_nAudioChannels   = audio_frame.no_channels;
-						m_nAudioSamples    = audio_frame.no_samples;
-						m_nAudioSampleRate = audio_frame.sample_rate;
-						if (m_AudioData) {
-							memcpy((void*)m_AudioData, (void*)audio_frame.p_data, ((size_t)m_nAudioSamples * (size_t)audio_frame.no_channels * sizeof(float)));
-							m_AudioDataStride = audio_frame.channel_stride_in_bytes;
-						}
-						else {
-							m_AudioDataStride = 0;
-						}
-						
-						m_bAudioFrame = true;
-						
 						// ReceiveImage will return false (no image received)
 						// Use IsAudioFrame() to determine whether audio has been received
 						// and GetAudioData to retrieve the sample buffer
@@ -1317,6 +1567,9 @@ bool ofxNDIreceive::ReceiveImage(unsigned int &width, unsigned int &height)
 					width  = m_Width;
 					height = m_Height;
 
+					// Is the frame a repeat of the last one
+					UpdateRepeat();
+
 					// Get the current video frame timecode
 					// UTC time since the Unix Epoch (1/1/1970 00:00) with 100 ns precision.
 					m_VideoTimecode = video_frame.timecode;
@@ -1327,6 +1580,9 @@ bool ofxNDIreceive::ReceiveImage(unsigned int &width, unsigned int &height)
 					// Update received frame counter
 					UpdateFps();
 
+					// Capture time and timestamp jitter
+					UpdateStats(GetCounter() - capturestart);
+
 					// Only return true for video data
 					bRet = true;
 
@@ -1376,7 +1632,9 @@ unsigned char *ofxNDIreceive::GetVideoData()
 void ofxNDIreceive::FreeVideoData()
 {
 	if (p_NDILib && video_frame.p_data) {
-		p_NDILib->recv_free_video_v2(pNDI_recv, &video_frame);
+		ofxNDIutils::TraceSpan span("ofxNDIreceive::FreeVideoData");
+		// The frame may have been captured by a standby receiver
+		p_NDILib->recv_free_video_v2(pNDI_frame ? pNDI_frame : pNDI_recv, &video_frame);
 		// Check that the video frame data pointer is null
 		// because the function may not reset the pointer
 		// and we return video_frame.p_data in GetVideoData().
@@ -1395,6 +1653,8 @@ void ofxNDIreceive::FreeAudioData()
 	// Free audio data
 	if (m_AudioData) free((void *)m_AudioData);
 	m_AudioData =nullptr;
+	m_AudioDataSize = 0;
+	m_AudioDataStride = 0;
 	m_bAudioFrame = false;
 	m_nAudioSampleRate = 0;
 	m_nAudioSamples = 0;
@@ -1422,6 +1682,197 @@ void ofxNDIreceive::ResetFps(double fps)
 	m_fps = fps;
 }
 
+// Start a thread to sample receiver statistics
+void ofxNDIreceive::StartStats(unsigned int interval)
+{
+	if (!bNDIinitialized || m_bStatsActive)
+		return;
+	m_statsInterval = interval > 0 ? interval : 1;
+	m_bStatsActive = true;
+	m_statsThread = std::thread(&ofxNDIreceive::StatsThread, this);
+}
+
+// Stop the statistics sampling thread
+void ofxNDIreceive::StopStats()
+{
+	if (!m_bStatsActive)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		m_bStatsActive = false;
+	}
+	m_statsCondition.notify_all();
+	if (m_statsThread.joinable())
+		m_statsThread.join();
+}
+
+// Return the current receiver statistics
+ofxNDIreceiveStats ofxNDIreceive::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	return m_stats;
+}
+
+// Clear the receiver statistics
+void ofxNDIreceive::ResetStats()
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_stats = ofxNDIreceiveStats();
+	m_lastTimestamp = 0LL;
+	m_jitterTotal = 0.0;
+	m_jitterCount = 0LL;
+}
+
+// Record the time taken by a pipeline stage
+void ofxNDIreceive::SetStageTime(ofxNDIstage stage, double msec)
+{
+	if (stage < 0 || stage >= ofxNDI_stage_max)
+		return;
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	// Rolling average with the same damping for all stages
+	double &average = m_stats.stageTime[stage];
+	if (average <= 0.0)
+		average = msec;
+	else
+		average = average*0.95 + msec*0.05;
+}
+
+//
+// Standby receivers
+//
+
+// Add a sender to the standby pool
+bool ofxNDIreceive::AddStandby(std::string sendername)
+{
+	if (!bNDIinitialized || sendername.empty())
+		return false;
+
+	for (size_t i = 0; i < m_standby.size(); i++) {
+		if (m_standby[i].name == sendername)
+			return true; // already in the pool
+	}
+
+	ofxNDIstandby standby;
+	standby.name = sendername;
+	standby.recv = nullptr;
+	m_standby.push_back(standby);
+
+	// Connect now if the sender is running
+	UpdateStandby();
+
+	return true;
+}
+
+// Remove a sender from the standby pool
+void ofxNDIreceive::RemoveStandby(std::string sendername)
+{
+	for (size_t i = 0; i < m_standby.size(); i++) {
+		if (m_standby[i].name == sendername) {
+			if (m_standby[i].recv)
+				p_NDILib->recv_destroy(m_standby[i].recv);
+			m_standby.erase(m_standby.begin() + i);
+			return;
+		}
+	}
+}
+
+// Remove all senders from the standby pool
+void ofxNDIreceive::ClearStandby()
+{
+	for (size_t i = 0; i < m_standby.size(); i++) {
+		if (p_NDILib && m_standby[i].recv)
+			p_NDILib->recv_destroy(m_standby[i].recv);
+	}
+	m_standby.clear();
+}
+
+// Return the names of senders in the standby pool
+std::vector<std::string> ofxNDIreceive::GetStandbyList()
+{
+	std::vector<std::string> list;
+	for (size_t i = 0; i < m_standby.size(); i++)
+		list.push_back(m_standby[i].name);
+	return list;
+}
+
+// Return whether a sender standby receiver is connected
+bool ofxNDIreceive::IsStandby(std::string sendername)
+{
+	for (size_t i = 0; i < m_standby.size(); i++) {
+		if (m_standby[i].name == sendername)
+			return (m_standby[i].recv != nullptr || m_standbyName == sendername);
+	}
+	return false;
+}
+
+// Set standby receiver bandwidth
+// Applies to standby receivers connected after this
+void ofxNDIreceive::SetStandbyBandwidth(NDIlib_recv_bandwidth_e bandwidth)
+{
+	m_standbyBandwidth = bandwidth;
+}
+
+// Set the primary and backup senders for failover
+void ofxNDIreceive::SetFailover(std::string primary, std::vector<std::string> backups,
+	double timeout, double holdtime)
+{
+	// A different primary sender starts again.
+	// Loss is timed from now if the primary sender is not received.
+	// If already receiving from another sender, that is a failover
+	// and the receiver returns to the primary sender when it is stable.
+	if (primary != m_primaryName) {
+		if (m_bPrimaryStandby)
+			RemoveStandby(m_primaryName);
+		m_bPrimaryStandby = false;
+		m_bPrimaryStable = false;
+		m_primaryName = primary;
+		m_lastFrameTime = std::chrono::steady_clock::now();
+		m_bFailover = (bReceiverCreated && m_senderName != m_primaryName);
+		if (m_bFailover && holdtime > 0.0)
+			m_bPrimaryStandby = AddPrimaryStandby();
+	}
+
+	// Primary stability is measured again
+	m_primaryFrames = 0LL;
+	m_primaryFrameTime = std::chrono::steady_clock::now();
+	m_bPrimaryStable = false;
+
+	m_backupNames = backups;
+	m_failoverTimeout = timeout;
+	m_failoverHold = holdtime;
+
+	// Keep the backup senders connected
+	for (size_t i = 0; i < m_backupNames.size(); i++) {
+		if (m_backupNames[i] != m_primaryName)
+			AddStandby(m_backupNames[i]);
+	}
+}
+
+// Remove the failover senders
+// Standby receivers for the backup senders remain in the pool
+void ofxNDIreceive::ClearFailover()
+{
+	if (m_bPrimaryStandby)
+		RemoveStandby(m_primaryName);
+	m_bPrimaryStandby = false;
+	m_primaryName.clear();
+	m_backupNames.clear();
+	m_bFailover = false;
+	m_bPrimaryStable = false;
+}
+
+// Return whether receiving from a backup sender
+bool ofxNDIreceive::IsFailover()
+{
+	return m_bFailover;
+}
+
+// Return the time between the last switch and the first video frame (msec)
+double ofxNDIreceive::GetFailoverLatency()
+{
+	return m_failoverLatency;
+}
+
 //
 // Private functions
 //
@@ -1461,7 +1912,7 @@ void ofxNDIreceive::UpdateFps() {
 	lastTime = startTime;
 	startTime = GetCounter(); // msec
 	double frametime = (startTime - lastTime); // msec
-	if (frametime > 1.0) {
+	if (frametime > 0.0) {
 		frametime = frametime/1000.0; // frame time in seconds
 		// damping based on received frame time
 		if (frametime <= 1.0) {
@@ -1471,23 +1922,340 @@ void ofxNDIreceive::UpdateFps() {
 	}
 }
 
-void ofxNDIreceive::StartCounter()
+// Statistics sampling thread
+// NDI performance and queue functions are cheap
+// but are kept off the receiving thread.
+void ofxNDIreceive::StatsThread()
+{
+	ofxNDIutils::TraceThreadName("ofxNDIreceive statistics");
+	std::unique_lock<std::mutex> lock(m_statsMutex);
+	while (m_bStatsActive) {
+		if (p_NDILib && pNDI_recv) {
+			ofxNDIutils::TraceSpan span("ofxNDIreceive::StatsSample");
+			NDIlib_recv_performance_t total{};
+			NDIlib_recv_performance_t dropped{};
+			NDIlib_recv_queue_t queue{};
+			p_NDILib->recv_get_performance(pNDI_recv, &total, &dropped);
+			p_NDILib->recv_get_queue(pNDI_recv, &queue);
+			m_stats.videoFrames     = total.video_frames;
+			m_stats.audioFrames     = total.audio_frames;
+			m_stats.metadataFrames  = total.metadata_frames;
+			m_stats.videoDropped    = dropped.video_frames;
+			m_stats.audioDropped    = dropped.audio_frames;
+			m_stats.metadataDropped = dropped.metadata_frames;
+			m_stats.videoQueue      = queue.video_frames;
+			m_stats.audioQueue      = queue.audio_frames;
+			m_stats.metadataQueue   = queue.metadata_frames;
+			m_stats.samples++;
+		}
+		// Wait for the interval or until stopped
+		m_statsCondition.wait_for(lock, std::chrono::milliseconds(m_statsInterval),
+			[this] { return !m_bStatsActive; });
+	}
+}
+
+// Update capture time and video frame jitter
+// for a received video frame
+void ofxNDIreceive::UpdateStats(double capturetime)
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+
+	// Capture stage time
+	double &average = m_stats.stageTime[ofxNDI_stage_capture];
+	if (average <= 0.0)
+		average = capturetime;
+	else
+		average = average*0.95 + capturetime*0.05;
+
+	// Inter-arrival jitter from the sender timestamp (100 ns units)
+	int64_t timestamp = video_frame.timestamp;
+	if (timestamp == NDIlib_recv_timestamp_undefined || timestamp <= 0LL)
+		return;
+
+	if (m_lastTimestamp > 0LL && timestamp > m_lastTimestamp
+		&& video_frame.frame_rate_N > 0 && video_frame.frame_rate_D > 0) {
+		double interval = (double)(timestamp - m_lastTimestamp)/10000.0; // msec
+		double period = 1000.0*(double)video_frame.frame_rate_D/(double)video_frame.frame_rate_N;
+		double deviation = fabs(interval - period);
+		int bin = (int)deviation;
+		if (bin >= OFXNDI_JITTER_BINS)
+			bin = OFXNDI_JITTER_BINS-1;
+		m_stats.jitter[bin]++;
+		m_jitterTotal += deviation;
+		m_jitterCount++;
+		m_stats.jitterMean = m_jitterTotal/(double)m_jitterCount;
+		if (deviation > m_stats.jitterMax)
+			m_stats.jitterMax = deviation;
+	}
+	m_lastTimestamp = timestamp;
+}
+
+// Connect standby receivers to senders that have been found
+void ofxNDIreceive::UpdateStandby()
+{
+	if (!bNDIinitialized || !p_sources || no_sources == 0)
+		return;
+
+	for (size_t i = 0; i < m_standby.size(); i++) {
+		// Skip connected receivers and the one in use
+		if (m_standby[i].recv || m_standby[i].name == m_standbyName)
+			continue;
+		for (uint32_t j = 0; j < no_sources; j++) {
+			if (p_sources[j].p_ndi_name && m_standby[i].name == p_sources[j].p_ndi_name) {
+				NDIlib_recv_create_v3_t NDI_recv_create_desc;
+				NDI_recv_create_desc.source_to_connect_to = p_sources[j];
+				NDI_recv_create_desc.color_format = m_Format;
+				NDI_recv_create_desc.bandwidth = m_standbyBandwidth;
+				NDI_recv_create_desc.allow_video_fields = false;
+				NDI_recv_create_desc.p_ndi_recv_name = NULL;
+				m_standby[i].recv = p_NDILib->recv_create_v3(&NDI_recv_create_desc);
+				if (m_standby[i].recv) {
+					// on_program = false, on_preview = true
+					const NDIlib_tally_t tally_state = { false, true };
+					p_NDILib->recv_set_tally(m_standby[i].recv, &tally_state);
+				}
+				else {
+					printf("ofxNDIreceive::UpdateStandby - could not create receiver for [%s]\n", m_standby[i].name.c_str());
+				}
+				break;
+			}
+		}
+	}
+}
+
+// Use the standby receiver of a sender, if there is one,
+// until the new receiver has received a video frame
+void ofxNDIreceive::TakeStandby(std::string sendername)
+{
+	ReturnStandby();
+	for (size_t i = 0; i < m_standby.size(); i++) {
+		if (m_standby[i].name == sendername && m_standby[i].recv) {
+			pNDI_standby = m_standby[i].recv;
+			m_standby[i].recv = nullptr;
+			m_standbyName = sendername;
+			return;
+		}
+	}
+}
+
+// Return a standby receiver in use to the pool
+void ofxNDIreceive::ReturnStandby()
+{
+	if (!pNDI_standby)
+		return;
+
+	// A video frame from the standby receiver must be freed first
+	if (pNDI_frame == pNDI_standby)
+		FreeVideoData();
+	pNDI_frame = nullptr;
+
+	for (size_t i = 0; i < m_standby.size(); i++) {
+		if (m_standby[i].name == m_standbyName && !m_standby[i].recv) {
+			// Back on preview
+			const NDIlib_tally_t tally_state = { false, true };
+			p_NDILib->recv_set_tally(pNDI_standby, &tally_state);
+			m_standby[i].recv = pNDI_standby;
+			pNDI_standby = nullptr;
+			break;
+		}
+	}
+
+	// Removed from the pool while in use
+	if (pNDI_standby)
+		p_NDILib->recv_destroy(pNDI_standby);
+
+	pNDI_standby = nullptr;
+	m_standbyName.clear();
+}
+
+// Capture the latest video frame from the standby receiver in use.
+// Older frames queued while on standby are discarded.
+bool ofxNDIreceive::CaptureStandby()
+{
+	ofxNDIutils::TraceSpan span("ofxNDIreceive::CaptureStandby");
+	NDIlib_video_frame_v2_t frame;
+	bool bFrame = false;
+	while (p_NDILib->recv_capture_v3(pNDI_standby, &frame, nullptr, nullptr, 0) == NDIlib_frame_type_video) {
+		if (bFrame)
+			p_NDILib->recv_free_video_v2(pNDI_standby, &video_frame);
+		video_frame = frame;
+		bFrame = true;
+	}
+	if (bFrame)
+		pNDI_frame = pNDI_standby;
+	return bFrame;
+}
+
+// Capture a frame from the selected receiver
+// or from a standby receiver until it has connected
+NDIlib_frame_type_e ofxNDIreceive::CaptureFrame(NDIlib_audio_frame_v3_t* audio_frame, NDIlib_metadata_frame_t* metadata_frame)
+{
+	// Switch to a backup sender if the current one has been lost
+	// or back to the primary sender when it is stable
+	CheckFailover();
+	if (!pNDI_recv)
+		return NDIlib_frame_type_none;
+
+	ofxNDIutils::TraceBegin("recv_capture");
+	NDIlib_frame_type_e NDI_frame_type = p_NDILib->recv_capture_v3(pNDI_recv, &video_frame, audio_frame, metadata_frame, 0);
+	ofxNDIutils::TraceEnd();
+	pNDI_frame = pNDI_recv;
+
+	if (pNDI_standby) {
+		if (NDI_frame_type == NDIlib_frame_type_video) {
+			// The new receiver is connected
+			ReturnStandby();
+			pNDI_frame = pNDI_recv;
+		}
+		else if (NDI_frame_type == NDIlib_frame_type_none) {
+			if (CaptureStandby())
+				NDI_frame_type = NDIlib_frame_type_video;
+		}
+	}
+
+	if (NDI_frame_type == NDIlib_frame_type_video) {
+		m_lastFrameTime = std::chrono::steady_clock::now();
+		// Log the time from a switch to the first video frame
+		if (m_bSwitching) {
+			m_bSwitching = false;
+			m_failoverLatency = std::chrono::duration<double, std::milli>(m_lastFrameTime - m_switchTime).count();
+			double period = 0.0;
+			if (video_frame.frame_rate_N > 0)
+				period = 1000.0*(double)video_frame.frame_rate_D/(double)video_frame.frame_rate_N;
+			printf("ofxNDIreceive - switched to [%s] in %.3f msec (frame period %.3f msec)\n",
+				m_senderName.c_str(), m_failoverLatency, period);
+		}
+	}
+
+	return NDI_frame_type;
+}
+
+// Switch to a backup sender if the current one has been lost
+// or back to the primary sender when it is stable
+void ofxNDIreceive::CheckFailover()
 {
-	LARGE_INTEGER li;
-	if (!QueryPerformanceFrequency(&li)) {
-		printf("QueryPerformanceFrequency failed!\n");
+	if (m_primaryName.empty() || m_backupNames.empty())
 		return;
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	// Loss detection from the last frame received, or from the last switch
+	// if no frame has been received since. A sender that has not sent a frame
+	// is timed from when the receiver was created or failover was set,
+	// so that a primary sender that never connects also fails over.
+	double elapsed = 0.0;
+	if (m_bSwitching)
+		elapsed = std::chrono::duration<double, std::milli>(now - m_switchTime).count();
+	else
+		elapsed = std::chrono::duration<double, std::milli>(now - m_lastFrameTime).count();
+	if (elapsed > m_failoverTimeout) {
+		// The first running backup in order of preference other than the current sender.
+		// A backup with a connected standby receiver is preferred.
+		std::string next;
+		for (size_t i = 0; i < m_backupNames.size(); i++) {
+			int index = 0;
+			if (m_backupNames[i] != m_senderName && GetSenderIndex(m_backupNames[i], index)) {
+				if (IsStandby(m_backupNames[i])) {
+					next = m_backupNames[i];
+					break;
+				}
+				if (next.empty())
+					next = m_backupNames[i];
+			}
+		}
+		if (!next.empty()) {
+			printf("ofxNDIreceive - [%s] lost for %.0f msec\n",
+				bReceiverCreated ? m_senderName.c_str() : m_primaryName.c_str(), elapsed);
+			// Keep the primary sender connected to detect when it returns
+			if (!m_bFailover && m_failoverHold > 0.0) {
+				std::vector<std::string> list = GetStandbyList();
+				if (std::find(list.begin(), list.end(), m_primaryName) == list.end())
+					m_bPrimaryStandby = AddPrimaryStandby();
+			}
+			m_bFailover = true;
+			m_bPrimaryStable = false;
+			SwitchSender(next);
+		}
+		return;
+	}
+
+	// Return to the primary sender when it has been stable for the hold time.
+	// CheckFailover is called for each ReceiveImage, which can be faster
+	// than the primary frame rate, so the primary is stable while the time
+	// since its frame count last changed is less than the failover timeout.
+	if (m_bFailover && m_failoverHold > 0.0) {
+		for (size_t i = 0; i < m_standby.size(); i++) {
+			if (m_standby[i].name == m_primaryName) {
+				bool bStable = false;
+				if (m_standby[i].recv && p_NDILib->recv_get_no_connections(m_standby[i].recv) > 0) {
+					NDIlib_recv_performance_t total{};
+					NDIlib_recv_performance_t dropped{};
+					p_NDILib->recv_get_performance(m_standby[i].recv, &total, &dropped);
+					if (total.video_frames != m_primaryFrames) {
+						m_primaryFrames = total.video_frames;
+						m_primaryFrameTime = now;
+					}
+					bStable = (m_primaryFrames > 0
+						&& std::chrono::duration<double, std::milli>(now - m_primaryFrameTime).count() < m_failoverTimeout);
+				}
+				if (!bStable) {
+					m_bPrimaryStable = false;
+				}
+				else if (!m_bPrimaryStable) {
+					m_bPrimaryStable = true;
+					m_primaryStableTime = now;
+				}
+				else if (std::chrono::duration<double, std::milli>(now - m_primaryStableTime).count() > m_failoverHold) {
+					m_bFailover = false;
+					m_bPrimaryStable = false;
+					SwitchSender(m_primaryName);
+					// Remove the standby receiver added for failover.
+					// It is released when the primary receiver connects.
+					if (m_bPrimaryStandby)
+						RemoveStandby(m_primaryName);
+					m_bPrimaryStandby = false;
+				}
+				break;
+			}
+		}
 	}
-	PCFreq = double(li.QuadPart) / 1000.0;
-	QueryPerformanceCounter(&li);
-	CounterStart = li.QuadPart;
+}
+
+// Keep the primary sender connected to detect when it returns.
+// The frame count of the new standby receiver starts from zero.
+bool ofxNDIreceive::AddPrimaryStandby()
+{
+	m_primaryFrames = 0LL;
+	m_primaryFrameTime = std::chrono::steady_clock::now();
+	m_bPrimaryStable = false;
+	return AddStandby(m_primaryName);
+}
+
+// Release the current receiver and create one for another sender
+bool ofxNDIreceive::SwitchSender(std::string sendername)
+{
+	ofxNDIutils::TraceSpan span("ofxNDIreceive::SwitchSender");
+	m_switchTime = std::chrono::steady_clock::now();
+	m_bSwitching = true;
+	SetSenderName(sendername);
+	if (!CreateReceiver()) {
+		printf("ofxNDIreceive::SwitchSender - could not switch to [%s]\n", sendername.c_str());
+		m_bSwitching = false;
+		return false;
+	}
+	return true;
+}
+
+void ofxNDIreceive::StartCounter()
+{
+	CounterStart = ofxNDIutils::GetClockTime();
+	startTime = lastTime = 0.0;
 	// Reset starting frame rate value
 	m_fps = 30.0;
 }
 
+// Time since StartCounter (msec)
 double ofxNDIreceive::GetCounter()
 {
-	LARGE_INTEGER li;
-	QueryPerformanceCounter(&li);
-	return double(li.QuadPart - CounterStart) / PCFreq;
+	return ofxNDIutils::GetElapsedTime(CounterStart);
 }
@@ -0,0 +1,440 @@
+/*
+
+	ofxNDIresampler
+
+	Polyphase sample rate converter for received audio
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+
+*/
+#include "ofxNDIresampler.h"
+#include "ofxNDIutils.h" // For SIMD
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Filter phases between input samples
+static const int resamplerPhases = 256;
+
+// Largest ratio of input to output rate, e.g. 192 kHz to 48 kHz
+static const double resamplerMaxRatio = 4.0;
+
+// Drift control
+// The level is smoothed over about one second, because NDI audio
+// arrives in frames of up to tens of msec. The proportional and
+// integral gains give a critically damped response of about 20 seconds,
+// and the correction is limited to 1%, which is far more than
+// the difference between two audio clocks.
+static const double resamplerSmoothing = 1.0; // seconds
+static const double resamplerKp = 0.07;
+static const double resamplerKi = 0.0025;
+static const double resamplerMaxCorrection = 0.01;
+
+// Modified Bessel function of the first kind, order 0
+static double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	const double y = x*x/4.0;
+	for (int k = 1; k < 50; k++) {
+		term *= y/((double)k*(double)k);
+		sum += term;
+		if (term < sum*1e-12)
+			break;
+	}
+	return sum;
+}
+
+ofxNDIresampler::ofxNDIresampler()
+{
+	m_channels = 0;
+	m_inputRate = 0;
+	m_outputRate = 0;
+	m_quality = 2;
+	m_taps = 0;
+	m_maxSamples = 0;
+	m_latency = 40.0;
+	m_bSIMD = false;
+	m_historySize = 0;
+	m_have = 0;
+	m_position = 0.0;
+	m_bPrimed = false;
+	m_level = 0.0;
+	m_integral = 0.0;
+	m_ratio = 1.0;
+}
+
+ofxNDIresampler::~ofxNDIresampler()
+{
+	Release();
+}
+
+// Allocate for up to "channels" channels
+bool ofxNDIresampler::Setup(int channels, int outputrate, int quality, int maxsamples)
+{
+	if (channels <= 0 || outputrate <= 0 || maxsamples <= 0) {
+		printf("ofxNDIresampler::Setup - invalid %d channels %d Hz %d samples\n", channels, outputrate, maxsamples);
+		return false;
+	}
+
+	if (quality < 0) quality = 0;
+	if (quality > 3) quality = 3;
+	const int taps = 8 << quality;
+
+	// Input for one block with the largest ratio and correction
+	const int historySize = taps + (int)ceil((double)maxsamples*resamplerMaxRatio*(1.0 + resamplerMaxCorrection)) + 2;
+
+	try {
+		m_filter.assign((size_t)(resamplerPhases + 1)*(size_t)taps, 0.0f);
+		m_coefs.assign((size_t)taps, 0.0f);
+		m_history.assign((size_t)channels*(size_t)historySize, 0.0f);
+	}
+	catch (...) {
+		printf("ofxNDIresampler::Setup - could not allocate %d channels %d samples\n", channels, historySize);
+		Release();
+		return false;
+	}
+
+	m_channels = channels;
+	m_outputRate = outputrate;
+	m_quality = quality;
+	m_taps = taps;
+	m_maxSamples = maxsamples;
+	m_historySize = historySize;
+	m_inputRate = 0; // Filter is made for the rate of the FIFO
+
+#if defined(OFXNDI_SIMD)
+	m_bSIMD = ofxNDIutils::HasSIMD();
+#else
+	m_bSIMD = false;
+#endif
+
+	Reset();
+
+	return true;
+}
+
+// Free the buffers
+void ofxNDIresampler::Release()
+{
+	std::vector<float>().swap(m_filter);
+	std::vector<float>().swap(m_coefs);
+	std::vector<float>().swap(m_history);
+	m_channels = 0;
+	m_inputRate = 0;
+	m_outputRate = 0;
+	m_taps = 0;
+	m_maxSamples = 0;
+	m_historySize = 0;
+	Reset();
+}
+
+// Is the resampler set up
+bool ofxNDIresampler::IsSetup()
+{
+	return m_taps > 0;
+}
+
+// Target FIFO level (msec)
+void ofxNDIresampler::SetLatency(double msec)
+{
+	if (msec < 1.0) msec = 1.0;
+	m_latency = msec;
+}
+
+double ofxNDIresampler::GetLatency()
+{
+	return m_latency;
+}
+
+// Produce exactly "samples" samples of "channels" channels
+int ofxNDIresampler::Process(ofxNDIfifo &fifo, float* output, int samples, int channels, int stride)
+{
+	if (!output || samples <= 0 || channels <= 0)
+		return 0;
+
+	if (stride <= 0)
+		stride = samples;
+
+	if (m_taps == 0) {
+		for (int c = 0; c < channels; c++)
+			memset(output + (size_t)c*(size_t)stride, 0, (size_t)samples*sizeof(float));
+		return 0;
+	}
+
+	// Blocks of up to the size allocated
+	int done = 0;
+	while (done < samples) {
+		const int n = (samples - done < m_maxSamples) ? samples - done : m_maxSamples;
+		ProcessBlock(fifo, output + done, n, channels, stride);
+		done += n;
+	}
+
+	return samples;
+}
+
+// Start again with the FIFO level
+void ofxNDIresampler::Reset()
+{
+	m_have = 0;
+	m_position = 0.0;
+	m_bPrimed = false;
+	m_level = 0.0;
+	m_integral = 0.0;
+	m_ratio = (m_inputRate > 0 && m_outputRate > 0) ? (double)m_inputRate/(double)m_outputRate : 1.0;
+}
+
+// Input rate of the FIFO
+int ofxNDIresampler::GetInputRate()
+{
+	return m_inputRate;
+}
+
+// Output rate
+int ofxNDIresampler::GetOutputRate()
+{
+	return m_outputRate;
+}
+
+// Filter taps
+int ofxNDIresampler::GetTaps()
+{
+	return m_taps;
+}
+
+// Input samples for each output sample including the drift correction
+double ofxNDIresampler::GetRatio()
+{
+	return m_ratio;
+}
+
+// Smoothed FIFO level (msec)
+double ofxNDIresampler::GetLevel()
+{
+	return m_level;
+}
+
+//
+// Private
+//
+
+// Kaiser windowed sinc low pass filter for each phase
+// Tap k of phase p is the filter at k - (taps/2 - 1) - p/phases
+// input samples from the output position.
+void ofxNDIresampler::MakeFilter()
+{
+	static const double passband[4] = { 0.80, 0.88, 0.92, 0.95 };
+	static const double beta[4] = { 5.0, 6.5, 8.0, 9.5 };
+
+	// Cutoff in cycles per input sample, below
+	// the lower of the input and output Nyquist
+	double ratio = (double)m_outputRate/(double)m_inputRate;
+	if (ratio > 1.0) ratio = 1.0;
+	const double fc = 0.5*ratio*passband[m_quality];
+
+	const double half = (double)m_taps/2.0;
+	const double i0beta = BesselI0(beta[m_quality]);
+	const double pi = 3.14159265358979323846;
+
+	for (int p = 0; p <= resamplerPhases; p++) {
+		float* coefs = &m_filter[(size_t)p*(size_t)m_taps];
+		double sum = 0.0;
+		for (int k = 0; k < m_taps; k++) {
+			const double t = (double)k - (half - 1.0) - (double)p/(double)resamplerPhases;
+			double h = 2.0*fc;
+			if (t != 0.0)
+				h = sin(2.0*pi*fc*t)/(pi*t);
+			const double w = t/half;
+			if (w <= -1.0 || w >= 1.0)
+				h = 0.0;
+			else
+				h *= BesselI0(beta[m_quality]*sqrt(1.0 - w*w))/i0beta;
+			coefs[k] = (float)h;
+			sum += h;
+		}
+		// Unity gain for each phase
+		if (sum != 0.0) {
+			for (int k = 0; k < m_taps; k++)
+				coefs[k] = (float)((double)coefs[k]/sum);
+		}
+	}
+}
+
+// Sum of the samples multiplied by the filter
+float ofxNDIresampler::Dot(const float* samples, const float* coefs)
+{
+#if defined(OFXNDI_SIMD)
+	if (m_bSIMD) {
+		// Taps are a multiple of 8
+		__m128 sum0 = _mm_setzero_ps();
+		__m128 sum1 = _mm_setzero_ps();
+		for (int k = 0; k < m_taps; k += 8) {
+			sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(samples + k), _mm_loadu_ps(coefs + k)));
+			sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(samples + k + 4), _mm_loadu_ps(coefs + k + 4)));
+		}
+		__m128 sum = _mm_add_ps(sum0, sum1);
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+		return _mm_cvtss_f32(sum);
+	}
+#endif
+	float sum = 0.0f;
+	for (int k = 0; k < m_taps; k++)
+		sum += samples[k]*coefs[k];
+	return sum;
+}
+
+// Produce up to m_maxSamples output samples
+void ofxNDIresampler::ProcessBlock(ofxNDIfifo &fifo, float* output, int samples, int channels, int stride)
+{
+	const int used = (channels < m_channels) ? channels : m_channels;
+
+	// Channels not allocated are silent
+	for (int c = used; c < channels; c++)
+		memset(output + (size_t)c*(size_t)stride, 0, (size_t)samples*sizeof(float));
+
+	// New sender rate
+	const int rate = fifo.GetSampleRate();
+	if (rate > 0 && rate != m_inputRate) {
+		if ((double)rate/(double)m_outputRate > resamplerMaxRatio) {
+			printf("ofxNDIresampler - %d Hz to %d Hz not supported\n", rate, m_outputRate);
+		}
+		else {
+			m_inputRate = rate;
+			MakeFilter();
+			Reset();
+		}
+	}
+
+	if (m_inputRate <= 0 || rate != m_inputRate) {
+		for (int c = 0; c < used; c++)
+			memset(output + (size_t)c*(size_t)stride, 0, (size_t)samples*sizeof(float));
+		return;
+	}
+
+	// FIFO level
+	const int available = fifo.GetAvailable();
+	const double level = (double)available*1000.0/(double)m_inputRate;
+	const double nominal = (double)m_inputRate/(double)m_outputRate;
+
+	if (!m_bPrimed) {
+		// Silence until the FIFO reaches the latency
+		if (level < m_latency) {
+			for (int c = 0; c < used; c++)
+				memset(output + (size_t)c*(size_t)stride, 0, (size_t)samples*sizeof(float));
+			return;
+		}
+		m_bPrimed = true;
+		m_level = level;
+		m_integral = 0.0;
+		m_ratio = nominal;
+	}
+	else if (level > m_latency*4.0 + 1000.0*(double)m_maxSamples*nominal/(double)m_inputRate) {
+		// Far too much after a stall of the reader.
+		// Drop the excess rather than correct it slowly.
+		int excess = available - (int)(m_latency*(double)m_inputRate/1000.0);
+		while (excess > 0) {
+			const int n = (excess < m_historySize) ? excess : m_historySize;
+			fifo.Read(&m_history[0], n, 1);
+			excess -= n;
+		}
+		m_have = 0;
+		m_position = 0.0;
+		m_level = m_latency;
+		m_integral = 0.0;
+	}
+	else {
+		// Adjust the ratio to keep the level at the latency
+		const double dt = (double)samples/(double)m_outputRate;
+		double alpha = dt/resamplerSmoothing;
+		if (alpha > 1.0) alpha = 1.0;
+		m_level += (level - m_level)*alpha;
+
+		const double error = (m_level - m_latency)/1000.0; // seconds
+		m_integral += error*dt;
+		const double limit = resamplerMaxCorrection/resamplerKi;
+		if (m_integral > limit) m_integral = limit;
+		if (m_integral < -limit) m_integral = -limit;
+
+		double correction = resamplerKp*error + resamplerKi*m_integral;
+		if (correction > resamplerMaxCorrection) correction = resamplerMaxCorrection;
+		if (correction < -resamplerMaxCorrection) correction = -resamplerMaxCorrection;
+		m_ratio = nominal*(1.0 + correction);
+	}
+
+	// Input needed for the last output sample of the block
+	// with one more in case of rounding of the position
+	const double step = m_ratio;
+	const int need = (int)floor(m_position + (double)(samples - 1)*step) + m_taps + 1 - m_have;
+	if (need > 0) {
+		const int read = fifo.Read(&m_history[(size_t)m_have], need, used, m_historySize);
+		m_have += need;
+		// The FIFO is empty, so wait for the level again
+		if (read < need)
+			m_bPrimed = false;
+	}
+
+	// Interpolate the filter between the two nearest phases
+	// and apply it to each channel
+	double position = m_position;
+	for (int i = 0; i < samples; i++) {
+		const int index = (int)position;
+		const double phase = (position - (double)index)*(double)resamplerPhases;
+		int p = (int)phase;
+		if (p >= resamplerPhases) p = resamplerPhases - 1;
+		const float a = (float)(phase - (double)p);
+		const float* c0 = &m_filter[(size_t)p*(size_t)m_taps];
+		const float* c1 = c0 + m_taps;
+		float* coefs = &m_coefs[0];
+#if defined(OFXNDI_SIMD)
+		if (m_bSIMD) {
+			const __m128 va = _mm_set1_ps(a);
+			for (int k = 0; k < m_taps; k += 4) {
+				const __m128 v0 = _mm_loadu_ps(c0 + k);
+				_mm_storeu_ps(coefs + k, _mm_add_ps(v0, _mm_mul_ps(va, _mm_sub_ps(_mm_loadu_ps(c1 + k), v0))));
+			}
+		}
+		else
+#endif
+		{
+			for (int k = 0; k < m_taps; k++)
+				coefs[k] = c0[k] + a*(c1[k] - c0[k]);
+		}
+		for (int c = 0; c < used; c++)
+			output[(size_t)c*(size_t)stride + i] = Dot(&m_history[(size_t)c*(size_t)m_historySize + index], coefs);
+		position += step;
+	}
+
+	// Discard the input that has been used
+	int consumed = (int)position;
+	if (consumed > m_have) consumed = m_have;
+	if (consumed > 0) {
+		for (int c = 0; c < used; c++) {
+			float* history = &m_history[(size_t)c*(size_t)m_historySize];
+			memmove(history, history + consumed, (size_t)(m_have - consumed)*sizeof(float));
+		}
+		m_have -= consumed;
+	}
+	m_position = position - (double)consumed;
+}
@@ -0,0 +1,156 @@
+/*
+
+	ofxNDIresampler
+
+	Polyphase sample rate converter for received audio
+
+	https://ndi.video
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	18.10.26	- Create files
+
+*/
+#pragma once
+#ifndef __ofxNDIresampler__
+#define __ofxNDIresampler__
+
+#include <stdint.h>
+#include <vector>
+#include "ofxNDIfifo.h"
+
+//
+// Audio is read from an ofxNDIfifo at the rate of the sender
+// and converted to a fixed output rate, e.g. that of the host
+// audio engine, so that the reader always has the samples it needs.
+//
+// Each output sample is the sum of "taps" input samples with
+// a Kaiser windowed sinc filter. The filter is calculated for 256
+// phases between input samples, and interpolated between them,
+// so that any ratio of rates can be used.
+//
+// The sender clock is not the same as the output clock, so the
+// FIFO slowly fills or empties. The ratio is adjusted to keep the
+// FIFO level at the latency set. Output is silent until the
+// FIFO first reaches that level, and again if it becomes empty.
+//
+// Quality and latency :
+//
+//   quality | taps | passband | filter delay
+//      0    |   8  |  80%     |  4 samples
+//      1    |  16  |  88%     |  8 samples
+//      2    |  32  |  92%     |  16 samples
+//      3    |  64  |  95%     |  32 samples
+//
+// Passband is of the lower Nyquist frequency.
+// Latency is the FIFO level plus the filter delay.
+//
+// Example :
+//
+//    ofxNDIresampler resampler;
+//    resampler.Setup(2, 48000); // stereo to 48 kHz
+//    resampler.SetLatency(40.0); // msec
+//    // Audio thread
+//    resampler.Process(fifo, output, 512, 2);
+//
+
+class ofxNDIresampler {
+
+public:
+
+	ofxNDIresampler();
+	~ofxNDIresampler();
+
+	// Allocate for up to "channels" channels
+	// - outputrate | output sample rate
+	// - quality | 0 to 3 (8, 16, 32 or 64 taps)
+	// - maxsamples | largest output block without more than one FIFO read
+	// Not while another thread is processing
+	bool Setup(int channels, int outputrate, int quality = 2, int maxsamples = 4096);
+
+	// Free the buffers
+	void Release();
+
+	// Is the resampler set up
+	bool IsSetup();
+
+	// Target FIFO level (msec)
+	// Initialized 40
+	void SetLatency(double msec);
+	double GetLatency();
+
+	// Produce exactly "samples" samples of "channels" channels (planar)
+	// at the output rate from the audio in the FIFO
+	// - stride | floats from one output channel to the next (0 for samples)
+	// Returns the samples produced
+	int Process(ofxNDIfifo &fifo, float* output, int samples, int channels, int stride = 0);
+
+	// Start again with the FIFO level
+	void Reset();
+
+	// Input rate of the FIFO
+	int GetInputRate();
+
+	// Output rate
+	int GetOutputRate();
+
+	// Filter taps
+	int GetTaps();
+
+	// Input samples for each output sample including the drift correction
+	double GetRatio();
+
+	// Smoothed FIFO level (msec)
+	double GetLevel();
+
+private:
+
+	int m_channels;
+	int m_inputRate;
+	int m_outputRate;
+	int m_quality;
+	int m_taps;
+	int m_maxSamples;
+	double m_latency; // msec
+	bool m_bSIMD;
+
+	// Filter phases, (phases + 1) x taps
+	std::vector<float> m_filter;
+	std::vector<float> m_coefs; // Interpolated between two phases
+
+	// Input samples of each channel not yet used
+	std::vector<float> m_history; // channels x m_historySize
+	int m_historySize;
+	int m_have; // Samples in the history
+	double m_position; // Input position of the next output sample
+
+	// Drift control
+	bool m_bPrimed; // FIFO has reached the latency
+	double m_level; // Smoothed FIFO level (msec)
+	double m_integral; // Level error integral (sec x sec)
+	double m_ratio;
+
+	void MakeFilter();
+	void ProcessBlock(ofxNDIfifo &fifo, float* output, int samples, int channels, int stride);
+	float Dot(const float* samples, const float* coefs);
+
+};
+
+#endif
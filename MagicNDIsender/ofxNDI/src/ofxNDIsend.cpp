@@ -111,6 +111,19 @@
 	24.02.26	- ReleaseSender - set pointers to null after destroy sender :
 				- pNDI_send, m_AudioData, m_audio_frame.p_data, video_frame.p_data
 				- Set m_bMetadata = false
+	18.10.26	- Trace spans for SendImage, copy, send video and SendAudio
+				- SetVideoStride - stride of the first plane for NV12, I420,
+				  YV12, P216, PA16 and UYVA
+				- SendAudio - convert interleaved 16 bit, 32 bit and float audio
+				  to planar with ofxNDIutils SSE2 functions instead of the
+				  NDI utility functions. Buffers are allocated only if more samples
+				  are needed. Remove debug printf for each frame.
+				- SetAudioChannels, SetAudioSamples - channel stride is the
+				  bytes of one channel
+				- Add audio cadence (ofxNDIcadence) for the samples of each
+				  frame at the frame rate - NextAudioFrame, GetMaxAudioSamples,
+				  GetAudioCadence. Reset by SetFrameRate and SetAudioSampleRate.
+				- Add SetVideoTimecode for timecodes aligned with audio
 
 */
 #include "ofxNDIsend.h"
@@ -128,6 +141,7 @@ ofxNDIsend::ofxNDIsend()
 	m_picture_aspect_ratio = 16.0f/9.0f; // Re-calculated from source aspect ratio
 	m_bProgressive = true; // progressive default
 	m_bClockVideo = true; // clock video true default
+	m_VideoTimecode = NDIlib_send_timecode_synthesize; // Timecode (synthesized)
 	m_bClockAudio = false; // clock audio false default
 	m_bAsync = false;
 	m_bMetadata = false;
@@ -145,6 +159,7 @@ ofxNDIsend::ofxNDIsend()
 	m_AudioSamples = 1602; // Default up to 1602 samples for NTSC 29.97, can be changed on the fly
 	m_AudioTimecode = NDIlib_send_timecode_synthesize; // Timecode (synthesized for us !)
 	m_AudioData = nullptr; // Audio buffer
+	m_AudioCadence.Set(m_AudioSampleRate, m_frame_rate_N, m_frame_rate_D);
 
 	// Find and load the Newtek NDI dll
     p_NDILib = libloader.Load();
@@ -269,8 +284,8 @@ bool ofxNDIsend::CreateSender(const char *sendername, unsigned int width, unsign
 			video_frame.frame_format_type = NDIlib_frame_format_type_interleaved;
 
 		// The timecode of this frame in 100ns intervals
-		// Let the API fill in the timecodes for us.
-		video_frame.timecode = NDIlib_send_timecode_synthesize;
+		// Let the API fill in the timecodes for us unless set.
+		video_frame.timecode = m_VideoTimecode;
 		video_frame.p_data = nullptr;
 
 		// Keep the sender dimensions locally
@@ -373,6 +388,9 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 		return false;
 
 	if (pNDI_send && bSenderInitialized && pixels && width > 0 && height > 0) {
+
+		ofxNDIutils::TraceSpan span("ofxNDIsend::SendImage");
+
 		// Allow for forgotten UpdateSender
 		if (video_frame.xres != (int)width || video_frame.yres != (int)height) {
 			video_frame.xres = (int)width;
@@ -395,8 +413,10 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 				}
 				video_frame.p_data = p_frame;
 			}
+			ofxNDIutils::TraceBegin("CopyImage");
 			ofxNDIutils::CopyImage((const unsigned char *)pixels, (unsigned char *)video_frame.p_data,
 				width, height, (unsigned int)video_frame.line_stride_in_bytes, bSwapRB, bInvert);
+			ofxNDIutils::TraceEnd();
 		}
 		else {
 			// No bgra conversion or invert, so use the pointer directly
@@ -420,6 +440,7 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 			p_NDILib->send_send_metadata(pNDI_send, &metadata_frame);
 		}
 
+		ofxNDIutils::TraceBegin(m_bAsync ? "send_send_video_async" : "send_send_video");
 		if (m_bAsync) {
 			// Submit the video frame asynchronously.
 			// This means that this call will return  immediately
@@ -436,6 +457,7 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 			// so that we end up submitting at exactly the predetermined fps.
 			p_NDILib->send_send_video_v2(pNDI_send, &video_frame);
 		}
+		ofxNDIutils::TraceEnd();
 
 		return true;
 	}
@@ -470,6 +492,8 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 
 	if (pNDI_send && bSenderInitialized && pixels && width > 0 && height > 0) {
 
+		ofxNDIutils::TraceSpan span("ofxNDIsend::SendImage");
+
 		// Allow for forgotten UpdateSender
 		if (video_frame.xres != (int)width || video_frame.yres != (int)height) {
 			video_frame.xres = (int)width;
@@ -492,7 +516,9 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 				}
 			}
 			// Flip from the sending buffer to the invert buffer
+			ofxNDIutils::TraceBegin("FlipBuffer");
 			ofxNDIutils::FlipBuffer(pixels, p_frame, width, height);
+			ofxNDIutils::TraceEnd();
 			// Use the invert buffer as the source of video data
 			video_frame.p_data = (uint8_t*)p_frame;
 		}
@@ -512,6 +538,7 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 			p_NDILib->send_send_metadata(pNDI_send, &metadata_frame);
 		}
 
+		ofxNDIutils::TraceBegin(m_bAsync ? "send_send_video_async" : "send_send_video");
 		if (m_bAsync) {
 			// Submit the video frame asynchronously. 
 			// See comments in SendImage above
@@ -522,6 +549,7 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 			// See comments in SendImage above
 			p_NDILib->send_send_video_v2(pNDI_send, &video_frame);
 		}
+		ofxNDIutils::TraceEnd();
 
 		return true;
 	}
@@ -631,6 +659,7 @@ void ofxNDIsend::SetFrameRate(int framerate)
 		// Keep scales compatible
 		m_frame_rate_N = framerate * 1000;
 		m_frame_rate_D = 1000;
+		m_AudioCadence.Set(m_AudioSampleRate, m_frame_rate_N, m_frame_rate_D);
 		UpdateSender(GetWidth(), GetHeight());
 	}
 }
@@ -674,6 +703,8 @@ void ofxNDIsend::SetFrameRate(double framerate)
 			m_frame_rate_D = 1000;
 		}
 
+		m_AudioCadence.Set(m_AudioSampleRate, m_frame_rate_N, m_frame_rate_D);
+
 		if (m_bNDIinitialized)
 			UpdateSender(GetWidth(), GetHeight());
 
@@ -686,6 +717,7 @@ void ofxNDIsend::SetFrameRate(int framerate_N, int framerate_D)
 	if (framerate_D > 0) {
 		m_frame_rate_N = framerate_N;
 		m_frame_rate_D = framerate_D;
+		m_AudioCadence.Set(m_AudioSampleRate, m_frame_rate_N, m_frame_rate_D);
 		if (m_bNDIinitialized)
 			UpdateSender(GetWidth(), GetHeight());
 	}
@@ -724,6 +756,13 @@ bool ofxNDIsend::GetProgressive()
 	return m_bProgressive;
 }
 
+// Set video timecode
+void ofxNDIsend::SetVideoTimecode(int64_t timecode)
+{
+	m_VideoTimecode = timecode;
+	video_frame.timecode = timecode;
+}
+
 // Set clocked
 void ofxNDIsend::SetClockVideo(bool bClocked)
 {
@@ -790,6 +829,7 @@ void ofxNDIsend::SetAudioSampleRate(int sampleRate)
 {
 	m_AudioSampleRate = sampleRate;
 	m_audio_frame.sample_rate = sampleRate;
+	m_AudioCadence.Set(m_AudioSampleRate, m_frame_rate_N, m_frame_rate_D);
 }
 
 // Set number of audio channels
@@ -797,7 +837,7 @@ void ofxNDIsend::SetAudioChannels(int nChannels)
 {
 	m_AudioChannels = nChannels;
 	m_audio_frame.no_channels = nChannels;
-	m_audio_frame.channel_stride_in_bytes = (m_AudioChannels - 1)*m_AudioSamples*sizeof(float);
+	m_audio_frame.channel_stride_in_bytes = m_AudioSamples*sizeof(float);
 
 }
 
@@ -819,7 +859,28 @@ void ofxNDIsend::SetAudioSamples(int nSamples)
 {
 	m_AudioSamples = nSamples;
 	m_audio_frame.no_samples  = nSamples;
-	m_audio_frame.channel_stride_in_bytes = (m_AudioChannels-1)*m_AudioSamples*sizeof(float);
+	m_audio_frame.channel_stride_in_bytes = m_AudioSamples*sizeof(float);
+}
+
+// Set the samples of the next audio frame from the audio cadence
+int ofxNDIsend::NextAudioFrame()
+{
+	if (m_AudioCadence.GetSampleRate() <= 0)
+		return m_AudioSamples;
+	SetAudioSamples(m_AudioCadence.Next());
+	return m_AudioSamples;
+}
+
+// Most samples of any audio frame at the frame rate
+int ofxNDIsend::GetMaxAudioSamples()
+{
+	return m_AudioCadence.GetMaxSamples();
+}
+
+// Audio cadence for the frame rate and audio sample rate
+ofxNDIcadence& ofxNDIsend::GetAudioCadence()
+{
+	return m_AudioCadence;
 }
 
 // Set audio timecode
@@ -858,6 +919,8 @@ bool ofxNDIsend::SendAudio()
 	if (!pNDI_send || !m_bNDIinitialized || !m_bAudio || !m_audio_frame.p_data)
 		return false;
 
+	ofxNDIutils::TraceSpan span("ofxNDIsend::SendAudio");
+
 	//
 	// Audio frame type
 	//
@@ -866,56 +929,41 @@ bool ofxNDIsend::SendAudio()
 	//   2 - NDIlib_audio_frame_interleaved_32s_t
 	//   3 - NDIlib_audio_frame_interleaved_32f_t
 	//
-	switch (m_AudioType) {
+	// Interleaved audio is converted to planar float and sent
+	// as for NDIlib_audio_frame_v2_t. Full scale of 16 and 32 bit audio
+	// is 1.0 as for the NDI utility functions with reference level 0.
+	//
+	if (m_AudioType < 1 || m_AudioType > 3) {
+		p_NDILib->send_send_audio_v2(pNDI_send, &m_audio_frame);
+		return true;
+	}
 
-		case 0:
-		default:
-			p_NDILib->send_send_audio_v2(pNDI_send, &m_audio_frame);
-		break;
-
-		case 1:
-		{
-			// LJ DEBUG
-			printf("audio_frame_interleaved_16s\n");
-
-			NDIlib_audio_frame_interleaved_16s_t audioframe{};
-			audioframe.sample_rate = m_audio_frame.sample_rate;
-			audioframe.no_channels = m_audio_frame.no_channels;
-			audioframe.no_samples  = m_audio_frame.no_samples;
-			audioframe.timecode    = m_audio_frame.timecode;
-			audioframe.p_data      = (int16_t*)m_audio_frame.p_data;
-			p_NDILib->util_send_send_audio_interleaved_16s(pNDI_send, &audioframe);
-		}
-		break;
-
-		case 2:
-		{
-			NDIlib_audio_frame_interleaved_32s_t audioframe{};
-			audioframe.sample_rate = m_audio_frame.sample_rate;
-			audioframe.no_channels = m_audio_frame.no_channels;
-			audioframe.no_samples  = m_audio_frame.no_samples;
-			audioframe.timecode    = m_audio_frame.timecode;
-			audioframe.p_data      = (int32_t*)m_audio_frame.p_data;
-			p_NDILib->util_send_send_audio_interleaved_32s(pNDI_send, &audioframe);
-		}
-		break;
-
-		case 3:
-		{
-			// LJ DEBUG
-			printf("audio_frame_interleaved_32f\n");
-
-			NDIlib_audio_frame_interleaved_32f_t audioframe{};
-			audioframe.sample_rate = m_audio_frame.sample_rate;
-			audioframe.no_channels = m_audio_frame.no_channels;
-			audioframe.no_samples  = m_audio_frame.no_samples;
-			audioframe.timecode    = m_audio_frame.timecode;
-			audioframe.p_data      = (float*)m_audio_frame.p_data;
-			p_NDILib->util_send_send_audio_interleaved_32f(pNDI_send, &audioframe);
-		}
-		break;
+	const int channels = m_audio_frame.no_channels;
+	const int samples = m_audio_frame.no_samples;
+	if (channels <= 0 || samples <= 0)
+		return false;
+	const size_t size = (size_t)channels*(size_t)samples;
+
+	// Allocate only if more samples are needed
+	if (m_AudioPlanar.size() < size)
+		m_AudioPlanar.resize(size);
+
+	const float* interleaved = (const float*)m_audio_frame.p_data;
+	if (m_AudioType == 1 || m_AudioType == 2) {
+		if (m_AudioConvert.size() < size)
+			m_AudioConvert.resize(size);
+		if (m_AudioType == 1)
+			ofxNDIutils::Int16ToFloat((const int16_t*)m_audio_frame.p_data, m_AudioConvert.data(), size);
+		else
+			ofxNDIutils::Int32ToFloat((const int32_t*)m_audio_frame.p_data, m_AudioConvert.data(), size);
+		interleaved = m_AudioConvert.data();
+	}
+	ofxNDIutils::InterleavedToPlanar(interleaved, m_AudioPlanar.data(), channels, samples);
 
-	} // end switch m_AudioType
+	NDIlib_audio_frame_v2_t audioframe = m_audio_frame;
+	audioframe.p_data = m_AudioPlanar.data();
+	audioframe.channel_stride_in_bytes = samples*(int)sizeof(float);
+	p_NDILib->send_send_audio_v2(pNDI_send, &audioframe);
 
 	return true;
 }
@@ -954,10 +1002,23 @@ void ofxNDIsend::SetVideoStride(NDIlib_FourCC_video_type_e format)
 	// Stop async send before changing the video frame
 	if (pNDI_send && m_bAsync)
 		p_NDILib->send_send_video_async_v2(pNDI_send, nullptr);
-	if (format == NDIlib_FourCC_video_type_UYVY)
-		video_frame.line_stride_in_bytes = video_frame.xres * 2;
-	else
-		video_frame.line_stride_in_bytes = video_frame.xres * 4;
+	// Planar formats use the stride of the first plane
+	switch (format) {
+		case NDIlib_FourCC_video_type_NV12:
+		case NDIlib_FourCC_video_type_I420:
+		case NDIlib_FourCC_video_type_YV12:
+			video_frame.line_stride_in_bytes = video_frame.xres;
+			break;
+		case NDIlib_FourCC_video_type_UYVY:
+		case NDIlib_FourCC_video_type_UYVA:
+		case NDIlib_FourCC_video_type_P216:
+		case NDIlib_FourCC_video_type_PA16:
+			video_frame.line_stride_in_bytes = video_frame.xres * 2;
+			break;
+		default:
+			video_frame.line_stride_in_bytes = video_frame.xres * 4;
+			break;
+	}
 }
 
 
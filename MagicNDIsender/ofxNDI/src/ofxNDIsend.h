@@ -42,6 +42,8 @@
 	15.11.19 - Change to dynamic load of Newtek NDI dlls
 	19.01.25 - Update to NDI 6.1.1.0
 	20.12.25 - Update to NDI version 6.2.1.0
+	18.10.26 - Add audio cadence - NextAudioFrame, GetMaxAudioSamples, GetAudioCadence
+			 - Add SetVideoTimecode
 
 */
 #pragma once
@@ -55,6 +57,7 @@
 
 #include "ofxNDIdynloader.h" // NDI library loader
 #include "ofxNDIutils.h" // buffer copy utilities
+#include "ofxNDIcadence.h" // audio samples for each frame
 
 // Definition is in WinBase.h
 // define for compilers that don't include this
@@ -170,6 +173,11 @@ public:
 	// Get whether progressive
 	bool GetProgressive();
 
+	// Set video timecode
+	// - timecode | the timecode of the next frame in 100ns intervals or synthesised
+	// Initialized synthesised
+	void SetVideoTimecode(int64_t timecode = NDIlib_send_timecode_synthesize);
+
 	// Set clocked 
 	// Refer to NDI documentation
 	// (do not clock the video for async sending)
@@ -218,6 +226,21 @@ public:
 	// Initialized 1602
 	void SetAudioSamples(int nSamples = 1602);
 
+	// Set the samples of the next audio frame from the frame rate
+	// and audio sample rate so that audio frames stay exactly with
+	// the video frames, e.g. 1601, 1602, 1601, 1602, 1602 for 48 kHz
+	// at 29.97 fps. Call once for each video frame before SendAudio.
+	// Returns the samples of the frame.
+	int NextAudioFrame();
+
+	// Most samples of any audio frame at the frame rate
+	// for buffer allocation
+	int GetMaxAudioSamples();
+
+	// Audio cadence for the frame rate and audio sample rate
+	// Started again by SetFrameRate and SetAudioSampleRate
+	ofxNDIcadence& GetAudioCadence();
+
 	// Set audio timecode
 	// - timecode | the timecode of this frame in 100ns intervals or synthesised
 	// Initialized synthesised
@@ -274,6 +297,7 @@ private:
 	float m_picture_aspect_ratio; // Aspect ratio
 	bool m_bProgressive; // Progressive video output flag
 	bool m_bClockVideo; // Clock video flag
+	int64_t m_VideoTimecode; // Video frame timecode
 	bool m_bAsync; // NDI asynchronous sender
 	NDIlib_FourCC_video_type_e m_Format; // Output format. Default RGBA. May also be BGRA or YUV.
 	void SetVideoStride(NDIlib_FourCC_video_type_e format); // Set line stride for YUV or RGBA
@@ -289,6 +313,9 @@ private:
 	int m_AudioSamples;
 	int64_t m_AudioTimecode;
 	float *m_AudioData = nullptr;
+	std::vector<float> m_AudioPlanar; // Interleaved audio converted to planar
+	std::vector<float> m_AudioConvert; // Interleaved integer audio converted to float
+	ofxNDIcadence m_AudioCadence; // Samples of each audio frame
 
 	// Metadata
 	bool m_bMetadata;
@@ -66,17 +66,70 @@
 			   ofxNDI version 2.001.000
 	09-02-26 - Add Audio functions
 	03-03-26 - ofxNDI version 2.002.000
+	18.10.26 - Replace StartTiming/EndTiming, which are not reentrant
+			   or thread safe, with tracing functions.
+			   Thread-local event buffers written as chrome://tracing JSON.
+			 - memcpy_sse2 - copy the bytes after the last 128 byte block,
+			   memcpy for unaligned buffers and sfence after streaming stores
+			 - memcpy_movsd - copy the bytes after the last DWORD
+			   OSX __movsd replacement count in DWORDs
+			 - CopyImage - memcpy for a stride that is not a multiple of 4
+			   Line by line copy allows any source and dest pitch
+			 - YUV422_to_RGBA - initialize tables again if BT.601/709 changes
+			 - Add HashBuffer, hash64 and hash64_sse2
+			 - Add DirtyTiles, memequal and memequal_sse2
+			 - HoldFps - use ofxNDIpacer with absolute deadlines
+			   instead of a sleep measured from the end of the last frame
+			 - SSE2 functions for any x86/x64 or ARM NEON system (OFXNDI_SIMD)
+			   including Linux, selected if HasSIMD is true.
+			   rotl32 and __movsd replacements for all compilers other than MSVC.
+			 - Add GetClockTime and GetElapsedTime monotonic clock
+			 - Add audio conversion with SSE2 versions to a caller buffer
+			   InterleavedToPlanar, PlanarToInterleaved, FloatToInt16 with
+			   triangular dither, FloatToInt32, Int16ToFloat, Int32ToFloat, AudioGain
+			 - InterleavedToPlanar returning a vector uses the new function
+			 - AudioFrameSequence - values from ofxNDIcadence so that the
+			   sum is exact. 29.97 etc. taken as 30000/1001. Remove TODO.
+			   Whole number rates are not taken as 1000/1001 rates.
+			 - rgba_bgra, rgba_bgra_sse2 - memcpy pixel load and store
+			   for buffers that are not 4 byte aligned
 
 */
 #include "ofxNDIutils.h"
+#include "ofxNDIpacer.h" // for HoldFps
+#include "ofxNDIcadence.h" // for AudioFrameSequence
+#include <chrono> // for tracing
+#include <atomic>
+#include <mutex>
+#include <memory> // for std::unique_ptr
+#include <fstream>
 
 // _rotl replacement
-// Other solutions possible
+// gcc and clang compile this to a single rotate instruction
 // https://stackoverflow.com/questions/776508/best-practices-for-circular-shift-rotate-operations-in-c
-#define BitsCount( val ) ( sizeof( val ) * CHAR_BIT )
-#define Shift( val, steps ) ( steps % BitsCount( val ) )
-#define ROL( val, steps ) ( ( val << Shift( val, steps ) ) | ( val >> ( BitsCount( val ) - Shift( val, steps ) ) ) )
-#define ROR( val, steps ) ( ( val >> Shift( val, steps ) ) | ( val << ( BitsCount( val )
+static inline uint32_t rotl32(uint32_t val, unsigned int steps)
+{
+#if defined(_MSC_VER)
+	return _rotl(val, (int)steps);
+#else
+	steps &= 31;
+	return (val << steps) | (val >> ((32 - steps) & 31));
+#endif
+}
+
+// Swap r and b of one pixel
+// memcpy for source and dest that are not 4 byte aligned
+static inline void rgba_bgra_pixel(const void *source, void *dest)
+{
+	uint32_t rgbapix;
+	memcpy(&rgbapix, source, 4);
+	// rgbapix << 16		: a r g b > g b a r
+	//        & 0x00ff00ff  : r g b . > . b . r
+	// rgbapix & 0xff00ff00 : a r g b > a . g .
+	// result of or			:           a b g r
+	rgbapix = (rotl32(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
+	memcpy(dest, &rgbapix, 4);
+}
 
 namespace ofxNDIutils {
 
@@ -84,23 +137,70 @@ namespace ofxNDIutils {
 	// Major, minor, release
 	std::string ofxNDIversion = "2.002.000";
 
+	// Trace event recorded when a span ends
+	struct traceEvent {
+		char name[40];
+		int64_t start; // nanoseconds from StartTrace
+		int64_t duration;
+	};
+
+	// Events of one thread.
+	// Only the owning thread writes events. The count is
+	// published after each event so that WriteTrace can read
+	// the events already recorded from another thread.
+	// The generation is published after the count is cleared
+	// so that WriteTrace skips events of a previous trace.
+	struct traceBuffer {
+		std::vector<traceEvent> events;
+		std::atomic<uint32_t> count{0};
+		std::atomic<uint32_t> generation{0}; // StartTrace count when the events were recorded
+		std::atomic<uint32_t> dropped{0}; // Events lost when the buffer was full
+		uint32_t tid = 0;
+		bool bOwned = false; // In use by a running thread
+		char threadname[40]{};
+	};
+
+	// Buffer and name of one thread.
+	// The buffer is returned for re-use when the thread finishes.
+	struct traceThread {
+		traceBuffer* buffer = nullptr;
+		char name[40]{};
+		~traceThread();
+	};
+
+	// Spans started by one thread
+	struct traceStack {
+		const char* name[OFXNDI_TRACE_DEPTH];
+		int64_t start[OFXNDI_TRACE_DEPTH]; // -1 if not recording
+		int depth = 0;
+	};
+
+	// Buffers are created only while tracing, the first time a thread
+	// records an event. The buffer of a thread that has finished keeps
+	// its events for WriteTrace until the next trace, and is then re-used
+	// by another thread. Buffers are freed when the library is unloaded.
+	static std::mutex traceMutex; // for creating, re-using and writing buffers only
+	static std::vector<std::unique_ptr<traceBuffer>> traceBuffers;
+	static std::atomic<bool> bTracing{false};
+	static std::atomic<uint32_t> traceGeneration{0};
+	static std::atomic<int64_t> traceStart{0}; // GetClockTime at StartTrace
+	static thread_local traceThread threadTrace;
+	static thread_local traceStack threadStack;
+
 #ifdef USE_CHRONO
-	// Timing counters
-	std::chrono::steady_clock::time_point start;
-	std::chrono::steady_clock::time_point end;
-	// For HoldFps
-	std::chrono::steady_clock::time_point FrameStartPtr;
-	std::chrono::steady_clock::time_point FrameEndPtr;
+	// For StartTimePeriod and EndTimePeriod
 	uint32_t PeriodMin = 0;
 #endif
 
-#if defined (__APPLE__)
+#if defined(OFXNDI_SIMD) && !defined(_MSC_VER)
 
+	// __movsd replacement
+	// n is the number of 4 byte DWORDs as for the Windows intrinsic
 	static inline void *__movsd(void *d, const void *s, size_t n) {
-#if defined(__aarch64__)
-        return memcpy(d, s, n);
+#if defined(OFXNDI_SIMD_NEON)
+        return memcpy(d, s, n*4);
 #else
-		asm volatile ("rep movsb"
+		asm volatile ("rep movsl"
 			: "=D" (d),
 			"=S" (s),
 			"=c" (n)
@@ -113,11 +213,56 @@ namespace ofxNDIutils {
     }
 #endif
 
+	//
+	// SIMD support
+	//
+
+#if defined(OFXNDI_SIMD) && !defined(OFXNDI_SIMD_NEON) && !defined(_M_X64) && !defined(__x86_64__)
+	// SSE2 is optional for 32 bit x86 processors
+	static bool CpuSSE2()
+	{
+#if defined(_MSC_VER)
+		int info[4]={};
+		__cpuid(info, 1);
+		return (info[3] & (1 << 26)) != 0; // edx bit 26
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse2") != 0;
+#endif
+	}
+#endif
+
+	// Whether the processor supports the SSE2 functions
+	bool HasSIMD()
+	{
+#if defined(OFXNDI_SIMD_NEON) || defined(_M_X64) || defined(__x86_64__)
+		// Part of the instruction set
+		return true;
+#elif defined(OFXNDI_SIMD)
+		static const bool bSSE2 = CpuSSE2();
+		return bSSE2;
+#else
+		return false;
+#endif
+	}
+
+	// Instruction set used by the SSE2 functions
+	std::string GetSIMD()
+	{
+		if (!HasSIMD())
+			return "none";
+#if defined(OFXNDI_SIMD_NEON)
+		return "NEON";
+#else
+		return "SSE2";
+#endif
+	}
+
 	//
 	// Image pixel copy
 	//
 
-#if defined(TARGET_WIN32) || defined (TARGET_OSX)
+#if defined(OFXNDI_SIMD)
 
 	// movsd requires 4 byte aligned data
 	void memcpy_movsd(void* dst, const void* src, size_t Size)
@@ -126,6 +271,10 @@ namespace ofxNDIutils {
 		const unsigned long *pSrc = static_cast<const unsigned long *>(src); // Source buffer
 		unsigned long *pDst = static_cast<unsigned long *>(dst); // Dest buffer
 		__movsd(pDst, pSrc, Size >> 2); //Size divided by 4 (4 bytes per rep move)
+		// Remaining bytes
+		const size_t tail = Size & 3;
+		if (tail > 0)
+			memcpy((char *)dst + Size - tail, (const char *)src + Size - tail, tail);
 	}
 
 	//
@@ -144,10 +293,16 @@ namespace ofxNDIutils {
 	{
 		char * pSrc = (char *)src;				  // Source buffer
 		char * pDst = (char *)dst;				  // Destination buffer
-		unsigned int n = (unsigned int)Size >> 7; // Counter = size divided by 128 (8 * 128bit registers)
+		size_t n = Size >> 7; // Counter = size divided by 128 (8 * 128bit registers)
+
+		// Aligned loads and streaming stores require 16 byte aligned buffers
+		if (((reinterpret_cast<uintptr_t>(pSrc) | reinterpret_cast<uintptr_t>(pDst)) & 15) != 0) {
+			memcpy(dst, src, Size);
+			return;
+		}
 
 		__m128i Reg0, Reg1, Reg2, Reg3, Reg4, Reg5, Reg6, Reg7;
-		for (unsigned int Index = n; Index > 0; --Index) {
+		for (size_t Index = n; Index > 0; --Index) {
 
 			// SSE2 prefetch
 			_mm_prefetch(pSrc + 256, _MM_HINT_NTA);
@@ -179,6 +334,14 @@ namespace ofxNDIutils {
 			pSrc += 128;
 			pDst += 128;
 		}
+
+		// Order the streaming stores before any later access
+		_mm_sfence();
+
+		// Remaining bytes less than 128
+		if ((Size & 127) > 0)
+			memcpy(pDst, pSrc, Size & 127);
+
 	} // end memcpy_sse2
 
 
@@ -218,20 +381,8 @@ namespace ofxNDIutils {
 
 			// Make output writes aligned
 			unsigned int x;
-			for (x = 0; ((reinterpret_cast<intptr_t>(&dst[x]) & 15) != 0) && x < width; x++) {
-				auto rgbapix = src[x];
-				// rgbapix << 16		: a r g b > g b a r
-				//        & 0x00ff00ff  : r g b . > . b . r
-				// rgbapix & 0xff00ff00 : a r g b > a . g .
-				// result of or			:           a b g r
-#if defined(TARGET_WIN32)
-// _rotl is available
-				dst[x] = (_rotl(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#else
-// _rotl replacement
-				dst[x] = (ROL(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#endif
-			}
+			for (x = 0; ((reinterpret_cast<intptr_t>(&dst[x]) & 15) != 0) && x < width; x++)
+				rgba_bgra_pixel(&src[x], &dst[x]);
 
 			for (; x + 3 < width; x += 4) {
 				__m128i sourceData = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[x]));
@@ -246,21 +397,13 @@ namespace ofxNDIutils {
 			}
 
 			// Perform leftover writes
-			for (; x < width; x++) {
-				auto rgbapix = src[x];
-#if defined(TARGET_WIN32)
-				// _rotl is available
-				dst[x] = (_rotl(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#else
-				// _rotl replacement
-				dst[x] = (ROL(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#endif
-			}
+			for (; x < width; x++)
+				rgba_bgra_pixel(&src[x], &dst[x]);
 
 		}
 	} // end rgba_bgra_sse2
 
-#endif // endif TARGET_WIN32 || TARGET_OSX
+#endif // endif OFXNDI_SIMD
 
 	// Without SSE
 	void rgba_bgra(const void *rgba_source, void *bgra_dest,
@@ -287,16 +430,8 @@ namespace ofxNDIutils {
 				dest += YxW;
 			}
 
-			for (unsigned int x = 0; x < width; x++) {
-				auto rgbapix = source[x];
-#if defined(TARGET_WIN32)
-				// _rotl is available
-				dest[x] = (_rotl(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#else
-				// _rotl replacement
-				dest[x] = (ROL(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#endif
-			}
+			for (unsigned int x = 0; x < width; x++)
+				rgba_bgra_pixel(&source[x], &dest[x]);
 
 		}
 
@@ -316,9 +451,8 @@ namespace ofxNDIutils {
 		unsigned int line_t = (height - 1)*pitch;
 
 		for (unsigned int y = 0; y < height; y++) {
-			// @zilog no SSE stuff for aarch64 build
-#if defined(TARGET_WIN32) || defined (TARGET_OSX)
-			if (width <= 512 || height <= 512) // too small for assembler
+#if defined(OFXNDI_SIMD)
+			if (!HasSIMD() || width <= 512 || height <= 512) // too small for assembler
 				memcpy((void *)(To + line_t), (void *)(From + line_s), pitch);
 			else if ((pitch % 16) == 0) // use sse assembler function
 				memcpy_sse2((void *)(To + line_t), (void *)(From + line_s), pitch);
@@ -409,11 +543,13 @@ namespace ofxNDIutils {
 
 		// user requires bgra->rgba or rgba->bgra conversion from source to dest
 		if (bSwapRB) {
-#if defined(TARGET_WIN32) || defined (TARGET_OSX)
-			rgba_bgra_sse2((const void *)source, (void *)dest, width, height, bInvert);
-#else
-			rgba_bgra((const void *)source, (void *)dest, width, height, bInvert);
+#if defined(OFXNDI_SIMD)
+			if (HasSIMD()) {
+				rgba_bgra_sse2((const void *)source, (void *)dest, width, height, bInvert);
+				return;
+			}
 #endif
+			rgba_bgra((const void *)source, (void *)dest, width, height, bInvert);
 			return;
 		}
 
@@ -421,9 +557,9 @@ namespace ofxNDIutils {
 			FlipBuffer(source, dest, width, height);
 		}
 		else {
-#if defined(TARGET_WIN32) || defined (TARGET_OSX)
+#if defined(OFXNDI_SIMD)
 			// Small image just use memcpy
-			if (width < 512 || height < 256) {
+			if (!HasSIMD() || width < 512 || height < 256) {
 				memcpy((void *)dest, (const void *)source, (size_t)height* (size_t)stride);
 			}
 			else if ((stride % 16) == 0) { // 16 byte aligned
@@ -432,8 +568,10 @@ namespace ofxNDIutils {
 			else if ((stride % 4) == 0) { // 4 byte aligned
 				memcpy_movsd((void*)dest, (const void *)source, (size_t)height* (size_t)stride);
 			}
+			else {
+				memcpy((void *)dest, (const void *)source, (size_t)height* (size_t)stride);
+			}
 #else
-			// @zilog no SSE stuff for aarch64 build
 			memcpy((void *)dest, (const void *)source, (size_t)height* (size_t)stride);
 #endif
 		}
@@ -451,17 +589,17 @@ namespace ofxNDIutils {
 		// For all rows
 		for (unsigned int y = 0; y < height; y++) {
 			// Start of buffers
-			auto source = static_cast<const uint32_t *>(rgba_source); // unsigned int = 4 bytes
-			auto dest = static_cast<uint32_t *>(rgba_dest);
+			auto source = static_cast<const unsigned char *>(rgba_source);
+			auto dest = static_cast<unsigned char *>(rgba_dest);
 			// Increment to current line
-			// Pitch is line length in bytes. Divide by 4 to get the width in rgba pixels.
+			// Pitch is line length in bytes and need not be a multiple of 4
 			if (bInvert) {
-				source += (unsigned long)((height - 1 - y)*sourcePitch / 4);
-				dest   += (unsigned long)(y * destPitch / 4); // dest is not inverted
+				source += (size_t)(height - 1 - y)*(size_t)sourcePitch;
+				dest   += (size_t)y*(size_t)destPitch; // dest is not inverted
 			}
 			else {
-				source += (unsigned long)(y * sourcePitch / 4);
-				dest   += (unsigned long)(y * destPitch / 4);
+				source += (size_t)y*(size_t)sourcePitch;
+				dest   += (size_t)y*(size_t)destPitch;
 			}
 
 			// Copy the line
@@ -509,7 +647,9 @@ namespace ofxNDIutils {
 	// Lookup tables to avoid repeat calculations
 	//
 	// Initialize once only for repeats
+	// and again if the colour standard changes
 	static bool tablesInitialized = false;
+	static bool tables709 = false;
 	static int YTable[256];
 	static int UToB[256];
 	static int UToG[256];
@@ -583,9 +723,10 @@ namespace ofxNDIutils {
 		// UHD BT.2020 - use RGBA receiver preference
 		bool b709 = (width > 720);
 
-		if (!tablesInitialized) {
+		if (!tablesInitialized || tables709 != b709) {
 			InitYUVTables(b709);
 			tablesInitialized = true;
+			tables709 = b709;
 		}
 
 		// YUV data (NDIlib_FourCC_type_UYVA) is half width 
@@ -639,75 +780,914 @@ namespace ofxNDIutils {
 
 
 	//
-	// Timing
+	// Frame hash
+	//
+	// 64 bytes are accumulated for each step in 8 lanes of 64 bits.
+	// Each lane adds the product of the low and high 32 bits of the data
+	// xor a key, plus the data of the neighbouring lane, as for XXH3.
+	// The SSE2 version processes two lanes in each register and gives
+	// the same result as the scalar version.
+	// Little-endian byte order is assumed.
 	//
 
-#ifdef USE_CHRONO
-	// Timing functions
-	void StartTiming() {
-		start = std::chrono::steady_clock::now();
+	static const uint64_t hashKey[8] = {
+		0x9E3779B185EBCA87ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0x85EBCA77C2B2AE63ULL,
+		0x27D4EB2F165667C5ULL, 0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL };
+
+	static inline uint64_t HashRotl(uint64_t v, int r)
+	{
+		return (v << r) | (v >> (64 - r));
 	}
 
-	double EndTiming() {
-		end = std::chrono::steady_clock::now();
-		double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
-		// printf("    elapsed [%6.2f] msec\n", elapsed / 1000.0);
-		// printf("elapsed [%.3f] u/sec\n", elapsed);
-		return elapsed / 1000.0; // msec
+	static inline uint64_t HashMix(uint64_t h)
+	{
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDULL;
+		h ^= h >> 33;
+		h *= 0xC4CEB9FE1A85EC53ULL;
+		h ^= h >> 33;
+		return h;
 	}
 
-	// -----------------------------------------------
-	// Function: HoldFps
-	// Frame rate control
+	static inline uint64_t HashLoad(const unsigned char* p)
+	{
+		uint64_t v = 0;
+		memcpy(&v, p, 8);
+		return v;
+	}
+
+	// Combine the lanes and the bytes after the last 64 byte step
+	static uint64_t HashFinish(const uint64_t* acc, const unsigned char* p, size_t remaining, size_t size)
+	{
+		uint64_t h = (uint64_t)size*0x9E3779B185EBCA87ULL;
+		for (int l = 0; l < 8; l++)
+			h = HashRotl(h ^ HashMix(acc[l]), 27)*0xC2B2AE3D27D4EB4FULL + 0x85EBCA77C2B2AE63ULL;
+		for (; remaining >= 8; remaining -= 8, p += 8)
+			h = HashRotl(h ^ HashMix(HashLoad(p) ^ hashKey[remaining & 7]), 27)*0xC2B2AE3D27D4EB4FULL;
+		for (; remaining > 0; remaining--, p++)
+			h = HashRotl(h ^ ((uint64_t)*p*0x27D4EB2F165667C5ULL), 11)*0x9E3779B185EBCA87ULL;
+		return HashMix(h);
+	}
+
+	// Without SSE
+	uint64_t hash64(const void* data, size_t size)
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		uint64_t acc[8];
+		for (int l = 0; l < 8; l++)
+			acc[l] = hashKey[7 - l];
+		if (!p)
+			return 0;
+
+		for (size_t n = size >> 6; n > 0; n--, p += 64) {
+			uint64_t d[8];
+			for (int l = 0; l < 8; l++)
+				d[l] = HashLoad(p + l*8);
+			for (int l = 0; l < 8; l++) {
+				const uint64_t dk = d[l] ^ hashKey[l];
+				acc[l] += (dk & 0xFFFFFFFFULL)*(dk >> 32) + d[l ^ 1];
+			}
+		}
+
+		return HashFinish(acc, p, size & 63, size);
+	}
+
+#if defined(OFXNDI_SIMD)
+	uint64_t hash64_sse2(const void* data, size_t size)
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		if (!p)
+			return 0;
+
+		__m128i acc[4], key[4];
+		for (int j = 0; j < 4; j++) {
+			acc[j] = _mm_set_epi64x((long long)hashKey[6 - j*2], (long long)hashKey[7 - j*2]);
+			key[j] = _mm_set_epi64x((long long)hashKey[j*2 + 1], (long long)hashKey[j*2]);
+		}
+
+		for (size_t n = size >> 6; n > 0; n--, p += 64) {
+			for (int j = 0; j < 4; j++) {
+				__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + j*16));
+				__m128i dk = _mm_xor_si128(d, key[j]);
+				// Low 32 bits times high 32 bits of each lane
+				__m128i product = _mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+				// Data of the neighbouring lane
+				__m128i swapped = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+				acc[j] = _mm_add_epi64(acc[j], _mm_add_epi64(product, swapped));
+			}
+		}
+
+		uint64_t lanes[8];
+		for (int j = 0; j < 4; j++)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&lanes[j*2]), acc[j]);
+
+		return HashFinish(lanes, p, size & 63, size);
+	}
+#endif
+
+	// 64 bit hash of a buffer, e.g. to find a repeated frame
+	uint64_t HashBuffer(const void* data, size_t size)
+	{
+#if defined(OFXNDI_SIMD)
+		if (HasSIMD())
+			return hash64_sse2(data, size);
+#endif
+		return hash64(data, size);
+	}
+
+
 	//
-	// Hold a desired frame rate if the application does not already
-	// have frame rate control. Must be called every frame.
+	// Changed tiles
 	//
-	// Note that this function is affected by changes to Windows timer 
-	// resolution since Windows 10 Version 2004 (April 2020)
-	// https://randomascii.wordpress.com/2020/10/04/windows-timer-resolution-the-great-rule-change/
-	//
-	// timeBeginPeriod / timeEndPeriod avoid loss of precision
-	// https://learn.microsoft.com/en-us/windows/win32/api/timeapi/nf-timeapi-timebeginperiod
-	// Microsoft remark :
-	//   Call this function immediately before using timer services, and call the timeEndPeriod
-	//   function immediately after you are finished using the timer services. An application 
-	//   can make multiple timeBeginPeriod calls as long as each call is matched with a call
-	//   to timeEndPeriod.
-	// 
-	void HoldFps(int fps)
+
+	// Without SSE
+	bool memequal(const void* a, const void* b, size_t size)
 	{
-		// Unlikely but return anyway
-		if (fps <= 0)
+		return memcmp(a, b, size) == 0;
+	}
+
+#if defined(OFXNDI_SIMD)
+	// Compare 64 bytes at a time and stop at the first difference
+	bool memequal_sse2(const void* a, const void* b, size_t size)
+	{
+		const unsigned char* pa = static_cast<const unsigned char*>(a);
+		const unsigned char* pb = static_cast<const unsigned char*>(b);
+		for (; size >= 64; size -= 64, pa += 64, pb += 64) {
+			__m128i e0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb)));
+			__m128i e1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + 16)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + 16)));
+			__m128i e2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + 32)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + 32)));
+			__m128i e3 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + 48)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + 48)));
+			__m128i e = _mm_and_si128(_mm_and_si128(e0, e1), _mm_and_si128(e2, e3));
+			if (_mm_movemask_epi8(e) != 0xFFFF)
+				return false;
+		}
+		for (; size >= 16; size -= 16, pa += 16, pb += 16) {
+			__m128i e = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb)));
+			if (_mm_movemask_epi8(e) != 0xFFFF)
+				return false;
+		}
+		return size == 0 || memcmp(pa, pb, size) == 0;
+	}
+#endif
+
+	// Compare an image with the previous image in tiles.
+	// Changed tiles are copied to the previous image.
+	unsigned int DirtyTiles(const unsigned char* current, unsigned char* previous,
+		unsigned int rowbytes, unsigned int height, unsigned int pitch,
+		unsigned int tilebytes, unsigned int tilerows,
+		std::vector<unsigned char> &dirty)
+	{
+		dirty.clear();
+		if (!current || !previous || rowbytes == 0 || height == 0 || tilebytes == 0 || tilerows == 0)
+			return 0;
+		if (pitch == 0)
+			pitch = rowbytes;
+
+		const unsigned int tilesX = (rowbytes + tilebytes - 1)/tilebytes;
+		const unsigned int tilesY = (height + tilerows - 1)/tilerows;
+		dirty.assign((size_t)tilesX*tilesY, 0);
+		unsigned int changed = 0;
+
+		bool (*equal)(const void*, const void*, size_t) = memequal;
+#if defined(OFXNDI_SIMD)
+		if (HasSIMD())
+			equal = memequal_sse2;
+#endif
+
+		for (unsigned int ty = 0; ty < tilesY; ty++) {
+			const unsigned int y0 = ty*tilerows;
+			const unsigned int y1 = (std::min)(height, y0 + tilerows);
+			unsigned char* row = &dirty[(size_t)ty*tilesX];
+			unsigned int rowchanged = 0;
+
+			// Rows of a tile already found to be changed are not compared
+			for (unsigned int y = y0; y < y1 && rowchanged < tilesX; y++) {
+				const unsigned char* src = current + (size_t)y*pitch;
+				const unsigned char* dst = previous + (size_t)y*rowbytes;
+				for (unsigned int tx = 0; tx < tilesX; tx++) {
+					if (row[tx])
+						continue;
+					const unsigned int x = tx*tilebytes;
+					const unsigned int n = (std::min)(tilebytes, rowbytes - x);
+					if (!equal(src + x, dst + x, n)) {
+						row[tx] = 1;
+						rowchanged++;
+					}
+				}
+			}
+
+			// Copy the changed tiles
+			for (unsigned int tx = 0; tx < tilesX && rowchanged > 0; tx++) {
+				if (!row[tx])
+					continue;
+				const unsigned int x = tx*tilebytes;
+				const unsigned int n = (std::min)(tilebytes, rowbytes - x);
+				for (unsigned int y = y0; y < y1; y++)
+					memcpy(previous + (size_t)y*rowbytes + x, current + (size_t)y*pitch + x, n);
+			}
+			changed += rowchanged;
+		}
+
+		return changed;
+	}
+
+
+	//
+	// Audio conversion
+	//
+
+	// Triangular dither of +-1 LSB from the difference of two xorshift values.
+	// Each thread has its own state. The two values are from separate
+	// generators so that they can be calculated together, four lanes each for SSE2.
+	static thread_local uint32_t ditherState[8] = { 0x9E3779B9, 0x7F4A7C15, 0x85EBCA6B, 0xC2B2AE35,
+		0x27D4EB2F, 0x165667B1, 0xD3A2646C, 0xFD7046C5 };
+
+	static inline uint32_t DitherNext(uint32_t &x)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		return x;
+	}
+
+	static inline float DitherTPDF()
+	{
+		const float r1 = (float)(DitherNext(ditherState[0]) >> 8);
+		const float r2 = (float)(DitherNext(ditherState[4]) >> 8);
+		return (r1 - r2)*(1.0f/16777216.0f);
+	}
+
+	// Float to 16 bit for one sample
+	// lrintf rounds to nearest even as for _mm_cvtps_epi32
+	static inline int16_t FloatS16(float x)
+	{
+		if (x < -32768.0f) x = -32768.0f;
+		if (x > 32767.0f) x = 32767.0f;
+		return (int16_t)lrintf(x);
+	}
+
+	// Float to 32 bit for one sample
+	// 2147483520 is the largest float less than 2^31
+	static inline int32_t FloatS32(float x)
+	{
+		if (x < -2147483648.0f) x = -2147483648.0f;
+		if (x > 2147483520.0f) x = 2147483520.0f;
+		return (int32_t)lrintf(x);
+	}
+
+	// Without SSE
+	void interleaved_planar(const float* interleaved, float* planar, int channels, int samples, int stride)
+	{
+		if (!interleaved || !planar || channels <= 0 || samples <= 0)
 			return;
+		if (stride <= 0)
+			stride = samples;
+		for (int c = 0; c < channels; c++) {
+			float* dst = planar + (size_t)c*stride;
+			for (int i = 0; i < samples; i++)
+				dst[i] = interleaved[(size_t)i*channels + c];
+		}
+	}
 
-		// Reduce Windows timer period to minimum
-#if defined(TARGET_WIN32)
-		StartTimePeriod();
+	void planar_interleaved(const float* planar, float* interleaved, int channels, int samples, int stride)
+	{
+		if (!planar || !interleaved || channels <= 0 || samples <= 0)
+			return;
+		if (stride <= 0)
+			stride = samples;
+		for (int c = 0; c < channels; c++) {
+			const float* src = planar + (size_t)c*stride;
+			for (int i = 0; i < samples; i++)
+				interleaved[(size_t)i*channels + c] = src[i];
+		}
+	}
+
+	void float_int16(const float* source, int16_t* dest, size_t count, float gain, bool bDither)
+	{
+		const float scale = gain*32768.0f;
+		for (size_t i = 0; i < count; i++)
+			dest[i] = FloatS16(source[i]*scale + (bDither ? DitherTPDF() : 0.0f));
+	}
+
+	void float_int32(const float* source, int32_t* dest, size_t count, float gain)
+	{
+		const float scale = gain*2147483648.0f;
+		for (size_t i = 0; i < count; i++)
+			dest[i] = FloatS32(source[i]*scale);
+	}
+
+	void int16_float(const int16_t* source, float* dest, size_t count, float gain)
+	{
+		const float scale = gain/32768.0f;
+		for (size_t i = 0; i < count; i++)
+			dest[i] = (float)source[i]*scale;
+	}
+
+	void int32_float(const int32_t* source, float* dest, size_t count, float gain)
+	{
+		const float scale = gain/2147483648.0f;
+		for (size_t i = 0; i < count; i++)
+			dest[i] = (float)source[i]*scale;
+	}
+
+	void audio_gain(const float* source, float* dest, size_t count, float gain)
+	{
+		for (size_t i = 0; i < count; i++)
+			dest[i] = source[i]*gain;
+	}
+
+#if defined(OFXNDI_SIMD)
+	// Blocks of 4 samples of 4 channels are transposed in registers.
+	// Stereo is shuffled directly. Other channels and the
+	// remaining samples are copied one at a time.
+	void interleaved_planar_sse2(const float* interleaved, float* planar, int channels, int samples, int stride)
+	{
+		if (!interleaved || !planar || channels <= 0 || samples <= 0)
+			return;
+		if (stride <= 0)
+			stride = samples;
+
+		if (channels == 1) {
+			memcpy(planar, interleaved, (size_t)samples*sizeof(float));
+			return;
+		}
+
+		int s = 0;
+		if (channels == 2) {
+			float* left = planar;
+			float* right = planar + stride;
+			for (; s + 3 < samples; s += 4) {
+				__m128 a = _mm_loadu_ps(interleaved + (size_t)s*2); // L0 R0 L1 R1
+				__m128 b = _mm_loadu_ps(interleaved + (size_t)s*2 + 4); // L2 R2 L3 R3
+				_mm_storeu_ps(left + s, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(right + s, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+			}
+		}
+		else if (channels >= 4) {
+			const int c4 = channels & ~3;
+			for (; s + 3 < samples; s += 4) {
+				const float* src = interleaved + (size_t)s*channels;
+				for (int c = 0; c < c4; c += 4) {
+					__m128 r0 = _mm_loadu_ps(src + c);
+					__m128 r1 = _mm_loadu_ps(src + channels + c);
+					__m128 r2 = _mm_loadu_ps(src + channels*2 + c);
+					__m128 r3 = _mm_loadu_ps(src + channels*3 + c);
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+					float* dst = planar + (size_t)c*stride + s;
+					_mm_storeu_ps(dst, r0);
+					_mm_storeu_ps(dst + stride, r1);
+					_mm_storeu_ps(dst + (size_t)stride*2, r2);
+					_mm_storeu_ps(dst + (size_t)stride*3, r3);
+				}
+				for (int c = c4; c < channels; c++) {
+					float* dst = planar + (size_t)c*stride + s;
+					for (int i = 0; i < 4; i++)
+						dst[i] = src[(size_t)i*channels + c];
+				}
+			}
+		}
+
+		for (int c = 0; c < channels; c++) {
+			float* dst = planar + (size_t)c*stride;
+			for (int i = s; i < samples; i++)
+				dst[i] = interleaved[(size_t)i*channels + c];
+		}
+	}
+
+	void planar_interleaved_sse2(const float* planar, float* interleaved, int channels, int samples, int stride)
+	{
+		if (!planar || !interleaved || channels <= 0 || samples <= 0)
+			return;
+		if (stride <= 0)
+			stride = samples;
+
+		if (channels == 1) {
+			memcpy(interleaved, planar, (size_t)samples*sizeof(float));
+			return;
+		}
+
+		int s = 0;
+		if (channels == 2) {
+			const float* left = planar;
+			const float* right = planar + stride;
+			for (; s + 3 < samples; s += 4) {
+				__m128 l = _mm_loadu_ps(left + s);
+				__m128 r = _mm_loadu_ps(right + s);
+				_mm_storeu_ps(interleaved + (size_t)s*2, _mm_unpacklo_ps(l, r));
+				_mm_storeu_ps(interleaved + (size_t)s*2 + 4, _mm_unpackhi_ps(l, r));
+			}
+		}
+		else if (channels >= 4) {
+			const int c4 = channels & ~3;
+			for (; s + 3 < samples; s += 4) {
+				float* dst = interleaved + (size_t)s*channels;
+				for (int c = 0; c < c4; c += 4) {
+					const float* src = planar + (size_t)c*stride + s;
+					__m128 r0 = _mm_loadu_ps(src);
+					__m128 r1 = _mm_loadu_ps(src + stride);
+					__m128 r2 = _mm_loadu_ps(src + (size_t)stride*2);
+					__m128 r3 = _mm_loadu_ps(src + (size_t)stride*3);
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+					_mm_storeu_ps(dst + c, r0);
+					_mm_storeu_ps(dst + channels + c, r1);
+					_mm_storeu_ps(dst + channels*2 + c, r2);
+					_mm_storeu_ps(dst + channels*3 + c, r3);
+				}
+				for (int c = c4; c < channels; c++) {
+					const float* src = planar + (size_t)c*stride + s;
+					for (int i = 0; i < 4; i++)
+						dst[(size_t)i*channels + c] = src[i];
+				}
+			}
+		}
+
+		for (int c = 0; c < channels; c++) {
+			const float* src = planar + (size_t)c*stride;
+			for (int i = s; i < samples; i++)
+				interleaved[(size_t)i*channels + c] = src[i];
+		}
+	}
+
+	// Four lanes of xorshift
+	static inline __m128i DitherNext_sse2(__m128i x)
+	{
+		x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+		x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+		return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+	}
+
+	// Four lanes of triangular dither
+	static inline __m128 DitherTPDF_sse2(__m128i &state1, __m128i &state2)
+	{
+		state1 = DitherNext_sse2(state1);
+		state2 = DitherNext_sse2(state2);
+		const __m128 r1 = _mm_cvtepi32_ps(_mm_srli_epi32(state1, 8));
+		const __m128 r2 = _mm_cvtepi32_ps(_mm_srli_epi32(state2, 8));
+		return _mm_mul_ps(_mm_sub_ps(r1, r2), _mm_set1_ps(1.0f/16777216.0f));
+	}
+
+	// Values are clamped before conversion and packed with saturation
+	void float_int16_sse2(const float* source, int16_t* dest, size_t count, float gain, bool bDither)
+	{
+		const float scale = gain*32768.0f;
+		const __m128 vscale = _mm_set1_ps(scale);
+		const __m128 vmin = _mm_set1_ps(-32768.0f);
+		const __m128 vmax = _mm_set1_ps(32767.0f);
+		__m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ditherState));
+		__m128i state2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ditherState + 4));
+
+		size_t i = 0;
+		for (; i + 7 < count; i += 8) {
+			__m128 a = _mm_mul_ps(_mm_loadu_ps(source + i), vscale);
+			__m128 b = _mm_mul_ps(_mm_loadu_ps(source + i + 4), vscale);
+			if (bDither) {
+				a = _mm_add_ps(a, DitherTPDF_sse2(state1, state2));
+				b = _mm_add_ps(b, DitherTPDF_sse2(state1, state2));
+			}
+			a = _mm_min_ps(_mm_max_ps(a, vmin), vmax);
+			b = _mm_min_ps(_mm_max_ps(b, vmin), vmax);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+				_mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(ditherState), state1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(ditherState + 4), state2);
+
+		for (; i < count; i++)
+			dest[i] = FloatS16(source[i]*scale + (bDither ? DitherTPDF() : 0.0f));
+	}
+
+	void float_int32_sse2(const float* source, int32_t* dest, size_t count, float gain)
+	{
+		const float scale = gain*2147483648.0f;
+		const __m128 vscale = _mm_set1_ps(scale);
+		const __m128 vmin = _mm_set1_ps(-2147483648.0f);
+		const __m128 vmax = _mm_set1_ps(2147483520.0f);
+
+		size_t i = 0;
+		for (; i + 3 < count; i += 4) {
+			__m128 a = _mm_mul_ps(_mm_loadu_ps(source + i), vscale);
+			a = _mm_min_ps(_mm_max_ps(a, vmin), vmax);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_cvtps_epi32(a));
+		}
+		for (; i < count; i++)
+			dest[i] = FloatS32(source[i]*scale);
+	}
+
+	void int16_float_sse2(const int16_t* source, float* dest, size_t count, float gain)
+	{
+		const float scale = gain/32768.0f;
+		const __m128 vscale = _mm_set1_ps(scale);
+
+		size_t i = 0;
+		for (; i + 7 < count; i += 8) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			// Sign extend to 32 bits
+			__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+			_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vscale));
+			_mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vscale));
+		}
+		for (; i < count; i++)
+			dest[i] = (float)source[i]*scale;
+	}
+
+	void int32_float_sse2(const int32_t* source, float* dest, size_t count, float gain)
+	{
+		const float scale = gain/2147483648.0f;
+		const __m128 vscale = _mm_set1_ps(scale);
+
+		size_t i = 0;
+		for (; i + 3 < count; i += 4) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(v), vscale));
+		}
+		for (; i < count; i++)
+			dest[i] = (float)source[i]*scale;
+	}
+
+	void audio_gain_sse2(const float* source, float* dest, size_t count, float gain)
+	{
+		const __m128 vgain = _mm_set1_ps(gain);
+
+		size_t i = 0;
+		for (; i + 7 < count; i += 8) {
+			__m128 a = _mm_loadu_ps(source + i);
+			__m128 b = _mm_loadu_ps(source + i + 4);
+			_mm_storeu_ps(dest + i, _mm_mul_ps(a, vgain));
+			_mm_storeu_ps(dest + i + 4, _mm_mul_ps(b, vgain));
+		}
+		for (; i < count; i++)
+			dest[i] = source[i]*gain;
+	}
+#endif
+
+	// Interleaved to planar float
+	void InterleavedToPlanar(const float* interleaved, float* planar, int channels, int samples, int stride)
+	{
+#if defined(OFXNDI_SIMD)
+		if (HasSIMD()) {
+			interleaved_planar_sse2(interleaved, planar, channels, samples, stride);
+			return;
+		}
 #endif
+		interleaved_planar(interleaved, planar, channels, samples, stride);
+	}
 
-		// Target frame time
-		const double target = (1000000.0/static_cast<double>(fps))/1000.0; // msec
+	// Planar to interleaved float
+	void PlanarToInterleaved(const float* planar, float* interleaved, int channels, int samples, int stride)
+	{
+#if defined(OFXNDI_SIMD)
+		if (HasSIMD()) {
+			planar_interleaved_sse2(planar, interleaved, channels, samples, stride);
+			return;
+		}
+#endif
+		planar_interleaved(planar, interleaved, channels, samples, stride);
+	}
 
-		// Time now end point
-		FrameEndPtr = std::chrono::steady_clock::now();
+	// Float to 16 bit
+	void FloatToInt16(const float* source, int16_t* dest, size_t count, float gain, bool bDither)
+	{
+		if (!source || !dest)
+			return;
+#if defined(OFXNDI_SIMD)
+		if (HasSIMD()) {
+			float_int16_sse2(source, dest, count, gain, bDither);
+			return;
+		}
+#endif
+		float_int16(source, dest, count, gain, bDither);
+	}
 
-		// Milliseconds elapsed
-		const double elapsedTime = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(FrameEndPtr - FrameStartPtr).count()/1000000.0);
+	// Float to 32 bit
+	void FloatToInt32(const float* source, int32_t* dest, size_t count, float gain)
+	{
+		if (!source || !dest)
+			return;
+#if defined(OFXNDI_SIMD)
+		if (HasSIMD()) {
+			float_int32_sse2(source, dest, count, gain);
+			return;
+		}
+#endif
+		float_int32(source, dest, count, gain);
+	}
 
-		// Sleep to reach the target frame time
-		if (elapsedTime < target) {
-			std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long long>(target - elapsedTime)));
+	// 16 bit to float
+	void Int16ToFloat(const int16_t* source, float* dest, size_t count, float gain)
+	{
+		if (!source || !dest)
+			return;
+#if defined(OFXNDI_SIMD)
+		if (HasSIMD()) {
+			int16_float_sse2(source, dest, count, gain);
+			return;
 		}
+#endif
+		int16_float(source, dest, count, gain);
+	}
 
-		// Set start time for the next frame
-		FrameStartPtr = std::chrono::steady_clock::now();
+	// 32 bit to float
+	void Int32ToFloat(const int32_t* source, float* dest, size_t count, float gain)
+	{
+		if (!source || !dest)
+			return;
+#if defined(OFXNDI_SIMD)
+		if (HasSIMD()) {
+			int32_float_sse2(source, dest, count, gain);
+			return;
+		}
+#endif
+		int32_float(source, dest, count, gain);
+	}
 
-		// Reset Windows timer period
-#if defined(TARGET_WIN32)
-		EndTimePeriod();
+	// Gain
+	void AudioGain(const float* source, float* dest, size_t count, float gain)
+	{
+		if (!source || !dest)
+			return;
+#if defined(OFXNDI_SIMD)
+		if (HasSIMD()) {
+			audio_gain_sse2(source, dest, count, gain);
+			return;
+		}
 #endif
+		audio_gain(source, dest, count, gain);
+	}
+
+
+	//
+	// Tracing
+	//
+
+	// Nanoseconds since StartTrace
+	static int64_t TraceTime()
+	{
+		return GetClockTime() - traceStart.load(std::memory_order_acquire);
+	}
 
+	// Copy a name with truncation
+	static void TraceCopyName(char* dest, const char* name, size_t size)
+	{
+		size_t i = 0;
+		for (; name && name[i] && i < size-1; i++)
+			dest[i] = name[i];
+		dest[i] = 0;
+	}
+
+	// Buffer of the calling thread, taken the first time
+	// from a finished thread or created while tracing
+	static traceBuffer* GetTraceBuffer()
+	{
+		traceThread &thread = threadTrace;
+		const uint32_t generation = traceGeneration.load(std::memory_order_acquire);
+		if (!thread.buffer) {
+			std::lock_guard<std::mutex> lock(traceMutex);
+			// A buffer of a finished thread without events of this trace
+			traceBuffer* buffer = nullptr;
+			for (size_t i = 0; i < traceBuffers.size(); i++) {
+				if (!traceBuffers[i]->bOwned
+					&& traceBuffers[i]->generation.load(std::memory_order_relaxed) != generation) {
+					buffer = traceBuffers[i].get();
+					break;
+				}
+			}
+			if (!buffer) {
+				traceBuffers.push_back(std::unique_ptr<traceBuffer>(new traceBuffer));
+				buffer = traceBuffers.back().get();
+				buffer->events.resize(OFXNDI_TRACE_EVENTS);
+				buffer->tid = (uint32_t)traceBuffers.size();
+			}
+			buffer->bOwned = true;
+			TraceCopyName(buffer->threadname, thread.name, sizeof(buffer->threadname));
+			thread.buffer = buffer;
+		}
+		// Events from a previous trace are discarded
+		traceBuffer* buffer = thread.buffer;
+		if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+			buffer->dropped.store(0, std::memory_order_relaxed);
+			buffer->count.store(0, std::memory_order_release);
+			buffer->generation.store(generation, std::memory_order_release);
+		}
+		return buffer;
+	}
+
+	// Return the buffer for re-use when the thread finishes.
+	// The events remain until the buffer is re-used.
+	traceThread::~traceThread()
+	{
+		if (buffer) {
+			std::lock_guard<std::mutex> lock(traceMutex);
+			buffer->bOwned = false;
+		}
+	}
+
+	// -----------------------------------------------
+	// Function: StartTrace
+	// Start recording and clear previous events
+	void StartTrace()
+	{
+		std::lock_guard<std::mutex> lock(traceMutex);
+		traceStart.store(GetClockTime(), std::memory_order_release);
+		traceGeneration.fetch_add(1, std::memory_order_acq_rel);
+		bTracing.store(true, std::memory_order_release);
+	}
+
+	// -----------------------------------------------
+	// Function: StopTrace
+	// Stop recording. Recorded events are retained.
+	void StopTrace()
+	{
+		bTracing.store(false, std::memory_order_release);
+	}
+
+	// -----------------------------------------------
+	// Function: IsTracing
+	bool IsTracing()
+	{
+		return bTracing.load(std::memory_order_acquire);
+	}
+
+	// -----------------------------------------------
+	// Function: TraceBegin
+	// Start a span for the calling thread.
+	// Only the name pointer and start time are kept
+	// so the name must remain valid until TraceEnd.
+	void TraceBegin(const char* name)
+	{
+		traceStack &stack = threadStack;
+		if (stack.depth < OFXNDI_TRACE_DEPTH) {
+			stack.name[stack.depth] = name;
+			stack.start[stack.depth] = -1;
+			if (bTracing.load(std::memory_order_relaxed)) {
+				// Create the buffer before the span starts
+				if (!threadTrace.buffer)
+					GetTraceBuffer();
+				stack.start[stack.depth] = TraceTime();
+			}
+		}
+		stack.depth++;
+	}
+
+	// -----------------------------------------------
+	// Function: TraceEnd
+	// End the last span started by the calling thread
+	// and record it if tracing was active when it started.
+	void TraceEnd()
+	{
+		traceStack &stack = threadStack;
+		if (stack.depth <= 0)
+			return;
+		stack.depth--;
+		if (stack.depth >= OFXNDI_TRACE_DEPTH || stack.start[stack.depth] < 0)
+			return;
+		if (!bTracing.load(std::memory_order_relaxed))
+			return;
+
+		const int64_t end = TraceTime();
+		traceBuffer* buffer = GetTraceBuffer();
+		const uint32_t count = buffer->count.load(std::memory_order_relaxed);
+		if (count >= buffer->events.size()) {
+			buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		traceEvent &ev = buffer->events[count];
+		TraceCopyName(ev.name, stack.name[stack.depth], sizeof(ev.name));
+		ev.start = stack.start[stack.depth];
+		ev.duration = end - ev.start;
+		// Publish the event
+		buffer->count.store(count+1, std::memory_order_release);
+	}
+
+	// -----------------------------------------------
+	// Function: TraceThreadName
+	// Name the calling thread in the trace.
+	// The name is kept for the thread and nothing
+	// is allocated unless the thread records events.
+	void TraceThreadName(const char* name)
+	{
+		traceThread &thread = threadTrace;
+		TraceCopyName(thread.name, name, sizeof(thread.name));
+		if (thread.buffer) {
+			std::lock_guard<std::mutex> lock(traceMutex);
+			TraceCopyName(thread.buffer->threadname, name, sizeof(thread.buffer->threadname));
+		}
+	}
+
+	// Names are written as JSON strings
+	static std::string TraceEscape(const char* name)
+	{
+		std::string str;
+		for (const char* c = name; *c; c++) {
+			if (*c == '"' || *c == '\\')
+				str += '\\';
+			if ((unsigned char)*c >= 0x20)
+				str += *c;
+		}
+		return str;
+	}
+
+	// -----------------------------------------------
+	// Function: WriteTrace
+	// Write recorded events as a JSON file in Trace Event Format
+	// for chrome://tracing or https://ui.perfetto.dev
+	//   "X" complete events with start and duration in microseconds
+	//   "M" metadata events for thread names
+	// Recording can continue while the events are written.
+	bool WriteTrace(const char* path)
+	{
+		if (!path || !*path)
+			return false;
+
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			printf("ofxNDIutils::WriteTrace - could not open [%s]\n", path);
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(traceMutex);
+		const uint32_t generation = traceGeneration.load(std::memory_order_acquire);
+		char tmp[256]{};
+		bool bFirst = true;
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		for (size_t b = 0; b < traceBuffers.size(); b++) {
+			const traceBuffer* buffer = traceBuffers[b].get();
+			if (buffer->threadname[0]) {
+				file << (bFirst ? "" : ",\n");
+				file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+					<< ",\"args\":{\"name\":\"" << TraceEscape(buffer->threadname) << "\"}}";
+				bFirst = false;
+			}
+			if (buffer->generation.load(std::memory_order_acquire) != generation)
+				continue;
+			const uint32_t count = buffer->count.load(std::memory_order_acquire);
+			for (uint32_t i = 0; i < count; i++) {
+				const traceEvent &ev = buffer->events[i];
+				snprintf(tmp, 256, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					TraceEscape(ev.name).c_str(), buffer->tid,
+					(double)ev.start/1000.0, (double)ev.duration/1000.0);
+				file << (bFirst ? "" : ",\n") << tmp;
+				bFirst = false;
+			}
+			const uint32_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+			if (dropped > 0)
+				printf("ofxNDIutils::WriteTrace - thread %u dropped %u events\n", buffer->tid, dropped);
+		}
+		file << "\n]}\n";
+		file.close();
+
+		return true;
+	}
+
+	//
+	// Timing
+	//
+
+	// Monotonic clock in nanoseconds.
+	// steady_clock uses QueryPerformanceCounter for Windows
+	// and CLOCK_MONOTONIC for Linux and OSX.
+	int64_t GetClockTime()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Time since a GetClockTime value (msec)
+	double GetElapsedTime(int64_t start)
+	{
+		return (double)(GetClockTime() - start)/1000000.0;
+	}
+
+#ifdef USE_CHRONO
+
+	// -----------------------------------------------
+	// Function: HoldFps
+	// Frame rate control
+	//
+	// Hold a desired frame rate if the application does not already
+	// have frame rate control. Must be called every frame.
+	//
+	// Frames are paced by an ofxNDIpacer with absolute deadlines
+	// so that the sleep error does not accumulate. The Windows timer
+	// period is reduced once rather than for every frame.
+	// For fractional frame rates such as 59.94, or more than one
+	// thread, use an ofxNDIpacer directly.
+	//
+	void HoldFps(int fps)
+	{
+		// Unlikely but return anyway
+		if (fps <= 0)
+			return;
+
+		static ofxNDIpacer pacer;
+		if (pacer.GetRateN() != fps || pacer.GetRateD() != 1)
+			pacer.SetRate(fps, 1);
+		pacer.Wait();
 	}
 
 #if defined(TARGET_WIN32)
@@ -745,60 +1725,58 @@ namespace ofxNDIutils {
 	//--------------------------------------------------------------
 	// Create an audio frame number sequence for a given video fps
 	//
-	// TODO - check and revise for correct average value
-	//
-	// The average of the sequence should be as close as possible
-	// to the Audio rate / Video fps
+	// The sequence is the first "length" frames of an ofxNDIcadence,
+	// so that the sum of any number of frames from the start is exact.
+	// Whole number frame rates are taken as exactly that, e.g. 10/1.
+	// Other rates within 0.01 of a multiple of 1000/1001, such as 29.97,
+	// are taken as exactly that, e.g. 30000/1001. Otherwise the rate
+	// is rounded to 1/1000 frame per second.
+	// For sending, use an ofxNDIcadence directly to continue
+	// the sequence without repeating it, or ofxNDIsend::NextAudioFrame.
 	//
 	// Typical values
 	// Audio Rate | Video fps | Audio/Video | Sequence                 | Avg/Frame |
 	// ---------- | --------- | ----------- | ------------------------ | --------- |
-	// 48000      | 29.97     | 1601.602    | 1602,1601,1602,1601,1602 | 1601.6    |
-	// 44100      | 29.97     | 1470.147    | 1471,1470,1471,1470,1471 | 1470.2    |
+	// 48000      | 29.97     | 1601.6      | 1601,1602,1601,1602,1602 | 1601.6    |
+	// 44100      | 29.97     | 1471.47     | 1471,1471,1472,1471,1472 | 1471.47   |
 	//
 	std::vector<int> AudioFrameSequence(int audioSampleRate, double videoFps, int &maxSample, int sequenceLength)
 	{
 		std::vector<int> sequence;
 
-		if (videoFps <= 0.0)
+		if (videoFps <= 0.0 || audioSampleRate <= 0)
 			return sequence;
 
-		// Ideal fractional number of samples per video frame
-		double S = audioSampleRate/videoFps;
-		int a = static_cast<int>(std::floor(S));
-		int b = a + 1;
+		// Frame rate as N/D
+		// A whole number is tested first. Otherwise rates up to 10 fps
+		// are also within 0.01 of a multiple of 1000/1001.
+		int N = (int)std::round(videoFps*1000.0);
+		int D = 1000;
+		const double ntsc = videoFps*1001.0/1000.0;
+		if (N % 1000 != 0 && std::round(ntsc) >= 1.0 && std::fabs(ntsc - std::round(ntsc)) < 0.01) {
+			N = (int)std::round(ntsc)*1000;
+			D = 1001;
+		}
 
-		// Fractional part
-		double frac = S-(double)a;
+		ofxNDIcadence cadence;
+		if (!cadence.Set(audioSampleRate, N, D))
+			return sequence;
 
-		// If very small, no sequence is needed.
-		// Just return one number
-		if (frac < 1e-6) {
-			sequence.push_back(a);
-			maxSample = a;
+		// A whole number needs only one value
+		if (cadence.GetPeriod() == 1) {
+			maxSample = cadence.Next();
+			sequence.push_back(maxSample);
 			return sequence;
 		}
 
-		 // limit the sequence length (default 100 and maximum 1000)
-		int64_t N = std::min(sequenceLength, 1000);
-		int64_t numB = static_cast<int64_t>(std::round(N*frac));
-		int64_t numA = N-numB;
-
-		// Alternate b and a for minimal jitter
-		while (numB > 0 || numA > 0) {
-			if (numB > 0) {
-				sequence.push_back(b);
-				numB--;
-			}
-			if (numA > 0) {
-				sequence.push_back(a);
-				numA--;
-			}
-		}
+		// limit the sequence length (default 100 and maximum 1000)
+		const int length = std::max(1, std::min(sequenceLength, 1000));
+		sequence.resize((size_t)length);
+		for (int i = 0; i < length; i++)
+			sequence[i] = cadence.Next();
 
 		// Find the maximum sample number for buffer allocation
-		auto smax = std::max_element(sequence.begin(), sequence.end());
-		maxSample = *smax;
+		maxSample = *std::max_element(sequence.begin(), sequence.end());
 
 		return sequence;
 	}
@@ -815,11 +1793,7 @@ namespace ofxNDIutils {
 	{
 		// Resize the namespace buffer (same size > no action)
 		planar.resize(nChannels*nSamples);
-		for (int c = 0; c < nChannels; c++) {
-			for (int f = 0; f < nSamples; f++) {
-				planar[c*nSamples+f] = interleaved[f*nChannels+c];
-			}
-		}
+		InterleavedToPlanar(interleaved, planar.data(), nChannels, nSamples);
 		return planar;
 	}
 	